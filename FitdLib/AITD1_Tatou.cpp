@@ -220,7 +220,7 @@ int make3dTatou(void)
             osystem_drawBackground();
 #endif
 
-            DisplayObject(0,0,0,0,0,0,tatou3d);
+            DisplayObject(0,0,0,0,0,0,tatou3d,nullptr);
 
 #ifdef DREAMCAST
             dbgio_printf("[dc] make3dTatou: DisplayObject returned\n");
@@ -270,7 +270,7 @@ int make3dTatou(void)
 #ifdef DREAMCAST
                 osystem_cleanScreenKeepZBuffer();
 #endif
-                DisplayObject(0,0,0,0,0,0,tatou3d);
+                DisplayObject(0,0,0,0,0,0,tatou3d,nullptr);
 
                 //blitScreenTatou();
 
@@ -83,10 +83,15 @@ static void ensureMaskStorage(int roomId, int maskId)
         g_dcMasks[roomId].resize(maskId + 1);
 }
 
-void dc_video_gl_create_mask(const u8* mask320x200, int roomId, int maskId,
+void dc_video_gl_clear_masks()
+{
+    g_dcMasks.clear();
+}
+
+void dc_video_gl_create_mask(const u8* mask, int roomId, int maskId,
                              int maskX1, int maskY1, int maskX2, int maskY2)
 {
-    if (!mask320x200)
+    if (!mask)
         return;
 
     ensureMaskStorage(roomId, maskId);
@@ -98,18 +103,22 @@ void dc_video_gl_create_mask(const u8* mask320x200, int roomId, int maskId,
     dst.y2 = std::max(0, std::min(199, maskY2));
     dst.runs.clear();
 
+    const int width = maskX2 - maskX1 + 1;
+    if (width <= 0)
+        return;
+
     for (int y = dst.y1; y <= dst.y2; ++y)
     {
-        const int row = y * 320;
+        const u8* row = mask + (y - maskY1) * width;
         int x = dst.x1;
         while (x <= dst.x2)
         {
-            while (x <= dst.x2 && mask320x200[row + x] == 0)
+            while (x <= dst.x2 && row[x - maskX1] == 0)
                 ++x;
             if (x > dst.x2)
                 break;
             const int runX1 = x;
-            while (x <= dst.x2 && mask320x200[row + x] != 0)
+            while (x <= dst.x2 && row[x - maskX1] != 0)
                 ++x;
             const int runX2 = x; // exclusive
             dst.runs.push_back({(uint16_t)y, (uint16_t)runX1, (uint16_t)runX2});
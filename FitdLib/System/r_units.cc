@@ -24,6 +24,7 @@
 #include "System/r_units.h"
 
 #include "osystem.h"
+#include "polys.h"
 
 #ifndef USE_PVR_PAL8
 // Defined in osystemDC.cpp (Dreamcast backend). Ensures RGL batches are cleared
@@ -36,10 +37,8 @@ extern void dc_rgl_ensure_frame_started();
 #include <cmath>
 
 // Software 2D raster helpers used by the engine (8-bit indexed into polyBackBuffer).
-extern void fillpoly(s16* datas, int n, unsigned char c);
 extern void line(int x1, int y1, int x2, int y2, unsigned char c);
 extern void hline(int x1, int x2, int y, unsigned char c);
-extern unsigned char* polyBackBuffer;
 
 std::vector<RGL_Vtx> g_rglTriVtx;
 std::vector<RGL_Vtx> g_rglLineVtx;
@@ -19,62 +19,116 @@
 
 #include "common.h"
 
-int sortCompareFunction(const void* param1, const void* param2)
+#include <algorithm>
+
+void AddActiveObjet(int index)
 {
-    int distance1 = 0;
-    int distance2 = 0;
-    tObject* actor1Ptr;
-    tObject* actor2Ptr;
-    ZVStruct* actor1ZvPtr;
-    ZVStruct* actor2ZvPtr;
-    ZVStruct localZv1;
-    ZVStruct localZv2;
-    int flag = 0;
-    int y1;
-    int y2;
+    ASSERT(index >= 0 && index < NUM_MAX_OBJECT);
 
-    ASSERT(*(int*)param1 >=0 && *(int*)param1 < NUM_MAX_OBJECT);
-    ASSERT(*(int*)param2 >=0 && *(int*)param2 < NUM_MAX_OBJECT);
+    int* begin = ActiveObjets.data();
+    int* end = begin + NbActiveObjets;
+    int* position = std::lower_bound(begin, end, index);
 
-    actor1Ptr = &ListObjets[*(int*)param1];
-    actor2Ptr = &ListObjets[*(int*)param2];
+    if(position != end && *position == index)
+        return;
 
-    actor1ZvPtr = &actor1Ptr->zv;
-    actor2ZvPtr = &actor2Ptr->zv;
+    std::copy_backward(position, end, end + 1);
+    *position = index;
+    NbActiveObjets++;
 
-    if(actor1Ptr->room != currentRoom)
-    {
-        CopyZV(actor1ZvPtr, &localZv1);
-        AdjustZV(&localZv1, actor1Ptr->room, currentRoom);
-        actor1ZvPtr = &localZv1;
-    }
+    AddObjetGrid(index);
+}
+
+void RemoveActiveObjet(int index)
+{
+    int* begin = ActiveObjets.data();
+    int* end = begin + NbActiveObjets;
+    int* position = std::lower_bound(begin, end, index);
+
+    if(position == end || *position != index)
+        return;
 
-    if(actor2Ptr->room != currentRoom)
+    std::copy(position + 1, end, position);
+    NbActiveObjets--;
+
+    RemoveObjetGrid(index);
+}
+
+void GenereActiveObjets()
+{
+    NbActiveObjets = 0;
+    ClearObjetGrid();
+
+    for(int i=0;i<NUM_MAX_OBJECT;i++)
     {
-        CopyZV(actor2ZvPtr, &localZv2);
-        AdjustZV(&localZv2, actor2Ptr->room, currentRoom);
-        actor2ZvPtr = &localZv2;
+        if(ListObjets[i].indexInWorld != -1)
+        {
+            ActiveObjets[NbActiveObjets++] = i;
+            AddObjetGrid(i);
+        }
     }
+}
+
+int NextActiveObjet(int index)
+{
+    const int* begin = ActiveObjets.data();
+    const int* end = begin + NbActiveObjets;
+    const int* position = std::upper_bound(begin, end, index);
 
-    y1 = ((((actor1ZvPtr->ZVY1 + actor1ZvPtr->ZVY2) / 2) - 2000) / 2000) * 2000;
-    y2 = ((((actor2ZvPtr->ZVY1 + actor2ZvPtr->ZVY2) / 2) - 2000) / 2000) * 2000;
+    if(position == end)
+        return NUM_MAX_OBJECT;
+
+    return *position;
+}
+
+// The ZV of every displayed actor, moved into the current room once per sort
+// rather than on each comparison, one array per field
+static std::array<s32, NUM_MAX_OBJECT> sortZVX1;
+static std::array<s32, NUM_MAX_OBJECT> sortZVX2;
+static std::array<s32, NUM_MAX_OBJECT> sortZVZ1;
+static std::array<s32, NUM_MAX_OBJECT> sortZVZ2;
+static std::array<s32, NUM_MAX_OBJECT> sortY; // middle of the ZV on Y, in steps of 2000
+
+int sortCompareFunction(const void* param1, const void* param2)
+{
+    int distance1 = 0;
+    int distance2 = 0;
+    int flag = 0;
+
+    const int actor1 = *(int*)param1;
+    const int actor2 = *(int*)param2;
+
+    ASSERT(actor1 >=0 && actor1 < NUM_MAX_OBJECT);
+    ASSERT(actor2 >=0 && actor2 < NUM_MAX_OBJECT);
+
+    const int actor1X1 = sortZVX1[actor1];
+    const int actor1X2 = sortZVX2[actor1];
+    const int actor1Z1 = sortZVZ1[actor1];
+    const int actor1Z2 = sortZVZ2[actor1];
+    const int actor2X1 = sortZVX1[actor2];
+    const int actor2X2 = sortZVX2[actor2];
+    const int actor2Z1 = sortZVZ1[actor2];
+    const int actor2Z2 = sortZVZ2[actor2];
+
+    const int y1 = sortY[actor1];
+    const int y2 = sortY[actor2];
 
     if((y1 == y2) || (g_gameId >= JACK)) // both y in the same range
     {
         if(
-            ((actor1ZvPtr->ZVX1 > actor2ZvPtr->ZVX1) && (actor1ZvPtr->ZVX1 < actor2ZvPtr->ZVX2)) ||
-            ((actor1ZvPtr->ZVX2 > actor2ZvPtr->ZVX1) && (actor1ZvPtr->ZVX2 < actor2ZvPtr->ZVX2)) ||
-            ((actor2ZvPtr->ZVX1 > actor1ZvPtr->ZVX1) && (actor2ZvPtr->ZVX1 < actor1ZvPtr->ZVX2)) ||
-            ((actor2ZvPtr->ZVX2 > actor1ZvPtr->ZVX1) && (actor2ZvPtr->ZVX2 < actor1ZvPtr->ZVX2)) )
+            ((actor1X1 > actor2X1) && (actor1X1 < actor2X2)) ||
+            ((actor1X2 > actor2X1) && (actor1X2 < actor2X2)) ||
+            ((actor2X1 > actor1X1) && (actor2X1 < actor1X2)) ||
+            ((actor2X2 > actor1X1) && (actor2X2 < actor1X2)) )
         {
             flag |= 1;
         }
 
         if(
-            ((actor1ZvPtr->ZVZ1 > actor2ZvPtr->ZVZ1) && (actor1ZvPtr->ZVZ1 < actor2ZvPtr->ZVZ2)) ||
-            ((actor1ZvPtr->ZVZ2 > actor2ZvPtr->ZVZ1) && (actor1ZvPtr->ZVZ2 < actor2ZvPtr->ZVZ2)) ||
-            ((actor2ZvPtr->ZVZ1 > actor1ZvPtr->ZVZ1) && (actor2ZvPtr->ZVZ1 < actor1ZvPtr->ZVZ2)) ||
-            ((actor2ZvPtr->ZVZ2 > actor1ZvPtr->ZVZ1) && (actor2ZvPtr->ZVZ2 < actor1ZvPtr->ZVZ2)) )
+            ((actor1Z1 > actor2Z1) && (actor1Z1 < actor2Z2)) ||
+            ((actor1Z2 > actor2Z1) && (actor1Z2 < actor2Z2)) ||
+            ((actor2Z1 > actor1Z1) && (actor2Z1 < actor1Z2)) ||
+            ((actor2Z2 > actor1Z1) && (actor2Z2 < actor1Z2)) )
         {
             flag |= 2;
         }
@@ -84,49 +138,49 @@ int sortCompareFunction(const void* param1, const void* param2)
 
         if(flag == 0)
         {
-            distance1 = GiveDistance2D(translateX,translateZ,(actor1ZvPtr->ZVX1+actor1ZvPtr->ZVX2)/2,(actor1ZvPtr->ZVZ1+actor1ZvPtr->ZVZ2)/2);
-            distance2 = GiveDistance2D(translateX,translateZ,(actor2ZvPtr->ZVX1+actor2ZvPtr->ZVX2)/2,(actor2ZvPtr->ZVZ1+actor2ZvPtr->ZVZ2)/2);
+            distance1 = GiveDistance2D(translateX,translateZ,(actor1X1+actor1X2)/2,(actor1Z1+actor1Z2)/2);
+            distance2 = GiveDistance2D(translateX,translateZ,(actor2X1+actor2X2)/2,(actor2Z1+actor2Z2)/2);
         }
         else
         {
             if(flag & 2) // intersect on Z
             {
-                if( abs(translateX - actor1ZvPtr->ZVX1) < abs(translateX - actor1ZvPtr->ZVX2) )
+                if( abs(translateX - actor1X1) < abs(translateX - actor1X2) )
                 {
-                    distance1 = abs(translateX - actor1ZvPtr->ZVX1);
+                    distance1 = abs(translateX - actor1X1);
                 }
                 else
                 {
-                    distance1 = abs(translateX - actor1ZvPtr->ZVX2);
+                    distance1 = abs(translateX - actor1X2);
                 }
 
-                if( abs(translateX - actor2ZvPtr->ZVX1) < abs(translateX - actor2ZvPtr->ZVX2) )
+                if( abs(translateX - actor2X1) < abs(translateX - actor2X2) )
                 {
-                    distance2 = abs(translateX - actor2ZvPtr->ZVX1);
+                    distance2 = abs(translateX - actor2X1);
                 }
                 else
                 {
-                    distance2 = abs(translateX - actor2ZvPtr->ZVX2);
+                    distance2 = abs(translateX - actor2X2);
                 }
             }
             if(flag & 1) // intersect on X
             {
-                if( abs(translateZ - actor1ZvPtr->ZVZ1) < abs(translateZ - actor1ZvPtr->ZVZ2) )
+                if( abs(translateZ - actor1Z1) < abs(translateZ - actor1Z2) )
                 {
-                    distance1 += abs(translateZ - actor1ZvPtr->ZVZ1);
+                    distance1 += abs(translateZ - actor1Z1);
                 }
                 else
                 {
-                    distance1 += abs(translateZ - actor1ZvPtr->ZVZ2);
+                    distance1 += abs(translateZ - actor1Z2);
                 }
 
-                if( abs(translateZ - actor2ZvPtr->ZVZ1) < abs(translateZ - actor2ZvPtr->ZVZ2) )
+                if( abs(translateZ - actor2Z1) < abs(translateZ - actor2Z2) )
                 {
-                    distance2 += abs(translateZ - actor2ZvPtr->ZVZ1);
+                    distance2 += abs(translateZ - actor2Z1);
                 }
                 else
                 {
-                    distance2 += abs(translateZ - actor2ZvPtr->ZVZ2);
+                    distance2 += abs(translateZ - actor2Z2);
                 }
             }
         }
@@ -153,5 +207,25 @@ int sortCompareFunction(const void* param1, const void* param2)
 
 void sortActorList()
 {
+    for(int i=0;i<NbAffObjets;i++)
+    {
+        const int actorIdx = Index[i];
+        tObject* actorPtr = &ListObjets[actorIdx];
+        ZVStruct localZv;
+
+        CopyZV(&actorPtr->zv, &localZv);
+
+        if(actorPtr->room != currentRoom)
+        {
+            AdjustZV(&localZv, actorPtr->room, currentRoom);
+        }
+
+        sortZVX1[actorIdx] = localZv.ZVX1;
+        sortZVX2[actorIdx] = localZv.ZVX2;
+        sortZVZ1[actorIdx] = localZv.ZVZ1;
+        sortZVZ2[actorIdx] = localZv.ZVZ2;
+        sortY[actorIdx] = ((((localZv.ZVY1 + localZv.ZVY2) / 2) - 2000) / 2000) * 2000;
+    }
+
     qsort(Index.data(), NbAffObjets, sizeof(int), sortCompareFunction);
 }
@@ -17,4 +17,14 @@
 //
 //----------------------------------------------------------------------------
 
+// ActiveObjets: the slots of ListObjets whose indexInWorld isn't -1, kept in
+// ascending order by everything that claims or frees a slot
+void AddActiveObjet(int index);
+void RemoveActiveObjet(int index);
+void GenereActiveObjets(); // rebuilds it from indexInWorld, after a load
+
+// First active slot after index (-1 for the first), NUM_MAX_OBJECT past the
+// last. Walks stay in slot order while actors are added or removed.
+int NextActiveObjet(int index);
+
 void sortActorList();
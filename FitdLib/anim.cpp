@@ -23,8 +23,54 @@
 hqrEntryStruct<sAnimation>* HQ_Anims = nullptr;
 
 std::vector<sFrame> BufferAnim;
+static std::vector<sGroupState> BufferAnimGroups; // [buffer][NUM_MAX_BONES]
 
-int SetAnimObjet(int frame, sAnimation* pAnimation, sBody* body)
+void InitBufferAnim()
+{
+    BufferAnim.resize(NB_BUFFER_ANIM);
+    BufferAnimGroups.resize(NB_BUFFER_ANIM * NUM_MAX_BONES);
+
+    for (int i = 0; i < NB_BUFFER_ANIM; i++)
+    {
+        BufferAnim[i].m_groups = BufferAnimGroups.data() + i * NUM_MAX_BONES;
+    }
+}
+
+void InitPose(sPoseInstance* pose, const sBody* body)
+{
+    pose->m_bodySerial = body->m_serial;
+    pose->m_startAnim = nullptr;
+    pose->m_channels.m_frame = nullptr;
+    pose->m_startTime = (body->m_scratchBuffer.size() >= 6) ? *(u16*)(body->m_scratchBuffer.data() + 4) : 0;
+
+    pose->m_groups.resize(body->m_groups.size());
+    for (int i = 0; i < body->m_groups.size(); i++)
+    {
+        pose->m_groups[i] = body->m_groups[i].m_state;
+    }
+}
+
+// The keyframe the pose blends from from now on
+static void SetStartAnim(sPoseInstance* pose, sFrame* frame)
+{
+    pose->m_startAnim = frame;
+    pose->m_startTime = (u16)timer;
+    pose->m_channels.m_frame = nullptr;
+}
+
+sPoseInstance* GetObjectPose(int actorIdx, const sBody* body)
+{
+    sPoseInstance* pose = &ListPoses[actorIdx];
+
+    if (pose->m_bodySerial != body->m_serial)
+    {
+        InitPose(pose, body);
+    }
+
+    return pose;
+}
+
+int SetAnimObjet(int frame, sAnimation* pAnimation, const sBody* body, sPoseInstance* pose)
 {
     if(frame >= pAnimation->m_numFrames)
     {
@@ -42,8 +88,7 @@ int SetAnimObjet(int frame, sAnimation* pAnimation, sBody* body)
         return(0);
     }
 
-    body->startAnim = &keyframe;
-    *(u16*)(body->m_scratchBuffer.data() + 4) = timer;
+    SetStartAnim(pose, &keyframe);
 
     if(numGroupsInAnimation > body->m_groupOrder.size())
         numGroupsInAnimation = body->m_groupOrder.size();
@@ -54,13 +99,13 @@ int SetAnimObjet(int frame, sAnimation* pAnimation, sBody* body)
 
     for(int i=0;i< numGroupsInAnimation;i++)
     {
-        body->m_groups[i].m_state.m_type = keyframe.m_groups[i].m_type;
-        body->m_groups[i].m_state.m_delta = keyframe.m_groups[i].m_delta;
+        pose->m_groups[i].m_type = keyframe.m_groups[i].m_type;
+        pose->m_groups[i].m_delta = keyframe.m_groups[i].m_delta;
 
         if(body->m_flags & INFO_OPTIMISE)
         {
-			body->m_groups[i].m_state.m_hasRotateDelta = keyframe.m_groups[i].m_hasRotateDelta;
-			body->m_groups[i].m_state.m_rotateDelta = keyframe.m_groups[i].m_rotateDelta;
+			pose->m_groups[i].m_hasRotateDelta = keyframe.m_groups[i].m_hasRotateDelta;
+			pose->m_groups[i].m_rotateDelta = keyframe.m_groups[i].m_rotateDelta;
         }
     }
 
@@ -81,7 +126,8 @@ int InitAnim(int animNum,int animType, int animInfo)
 
             currentProcessedActorPtr->objectType |= AF_ANIMATED;
 
-            SetAnimObjet(currentProcessedActorPtr->frame, HQR_Get(HQ_Anims,animNum), HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum));
+            sBody* pBody = HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum);
+            SetAnimObjet(currentProcessedActorPtr->frame, HQR_Get(HQ_Anims,animNum), pBody, GetObjectPose(currentProcessedActorIdx, pBody));
 
             currentProcessedActorPtr->animType = animType;
             currentProcessedActorPtr->animInfo = animInfo;
@@ -116,7 +162,8 @@ int InitAnim(int animNum,int animType, int animInfo)
             removeFromBGIncrust(currentProcessedActorIdx);
         }
 
-        SetAnimObjet(0, HQR_Get(HQ_Anims,animNum), HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum));
+        sBody* pBody = HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum);
+        SetAnimObjet(0, HQR_Get(HQ_Anims,animNum), pBody, GetObjectPose(currentProcessedActorIdx, pBody));
 
 		currentProcessedActorPtr->newAnim = animNum;
 		currentProcessedActorPtr->newAnimType = animType;
@@ -185,11 +232,11 @@ int evaluateReal(RealValue* data)
 int manageFall(int actorIdx, ZVStruct* zvPtr)
 {
 	int fallResult = 0;
-	int i;
 	int room = ListObjets[actorIdx].room;
 
-	for(i=0;i<NUM_MAX_OBJECT;i++)
+	for(int j=0;j<NbActiveObjets;j++)
 	{
+		const int i = ActiveObjets[j];
 		tObject* currentTestedActorPtr = &ListObjets[i];
 
 		if(currentTestedActorPtr->indexInWorld != -1 && i != actorIdx)
@@ -274,7 +321,8 @@ void GereAnim(void)
                 }
 
                 // TODO: AITD3 has some extra code here to handle bufferAnimCounter
-                StockInterAnim(BufferAnim[bufferAnimCounter], HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum));
+                sBody* pBody = HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum);
+                StockInterAnim(BufferAnim[bufferAnimCounter], pBody, GetObjectPose(currentProcessedActorIdx, pBody));
 
                 bufferAnimCounter++;
                 if (bufferAnimCounter == NB_BUFFER_ANIM)
@@ -282,7 +330,8 @@ void GereAnim(void)
 
             }
             else {
-                ResetStartAnim(HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum));
+                sBody* pBody = HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum);
+                ResetStartAnim(GetObjectPose(currentProcessedActorIdx, pBody));
                 currentProcessedActorPtr->newAnimType &= ~ANIM_RESET;
             }
             currentProcessedActorPtr->ANIM = newAnim;
@@ -342,7 +391,8 @@ void GereAnim(void)
 		oldStepY = currentProcessedActorPtr->stepY;
 		oldStepZ = currentProcessedActorPtr->stepZ;
 
-		currentProcessedActorPtr->END_FRAME = SetInterAnimObjet(currentProcessedActorPtr->frame, HQR_Get(HQ_Anims, currentProcessedActorPtr->ANIM), HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum));
+		sBody* pBody = HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum);
+		currentProcessedActorPtr->END_FRAME = SetInterAnimObjet(currentProcessedActorPtr->frame, HQR_Get(HQ_Anims, currentProcessedActorPtr->ANIM), pBody, GetObjectPose(currentProcessedActorIdx, pBody));
 
 		walkStep(animStepX,animStepZ,currentProcessedActorPtr->beta);
 
@@ -547,6 +597,7 @@ void GereAnim(void)
 						actorTouchedPtr->roomZ += stepZ;
 
 						CopyZV(&localZv2,touchedZv);
+						MoveObjetGrid(actorTouchedPtr);
 					}
 				}
 				else
@@ -600,6 +651,8 @@ void GereAnim(void)
 
 		currentProcessedActorPtr->zv.ZVZ1 += stepZ;
 		currentProcessedActorPtr->zv.ZVZ2 += stepZ;
+
+		MoveObjetGrid(currentProcessedActorPtr);
 	} // end of movement management
 
 	if(!currentProcessedActorPtr->YHandler.numSteps)
@@ -713,23 +766,21 @@ void GereAnim(void)
 }
 
 
-void StockInterAnim(sFrame& buffer, sBody* bodyPtr)
+void StockInterAnim(sFrame& buffer, const sBody* bodyPtr, sPoseInstance* pose)
 {
     if(bodyPtr->m_flags & INFO_ANIM)
     {
-        *(u16*)(bodyPtr->m_scratchBuffer.data()+4) = (u16)timer;
-        bodyPtr->startAnim = &buffer;
+        SetStartAnim(pose, &buffer);
 
-        buffer.m_groups.resize(bodyPtr->m_groups.size());
-        for (int i = 0; i < bodyPtr->m_groups.size(); i++) {
-            buffer.m_groups[i] = bodyPtr->m_groups[i].m_state;
+        ASSERT(pose->m_groups.size() <= NUM_MAX_BONES);
+        for (int i = 0; i < pose->m_groups.size(); i++) {
+            buffer.m_groups[i] = pose->m_groups[i];
         }
     }
 }
 
-void ResetStartAnim(sBody* bodyPtr) {
-    *(u16*)(bodyPtr->m_scratchBuffer.data() + 4) = (u16)timer; // reset timer
-    bodyPtr->startAnim = nullptr;
+void ResetStartAnim(sPoseInstance* pose) {
+    SetStartAnim(pose, nullptr); // reset timer
 }
 
 s16 GetNbFramesAnim(sAnimation* animPtr)
@@ -737,63 +788,7 @@ s16 GetNbFramesAnim(sAnimation* animPtr)
     return animPtr->m_numFrames;
 }
 
-s16 PatchType(sGroupState* bodyPtr, u16 type) // local
-{
-    bodyPtr->m_type = type;
-
-    return(bodyPtr->m_type);
-}
-
-void PatchInterAngle(s16* value, s16 previousValue, s16 nextValue, int bp, int bx) // local
-{
-    s16 diff = nextValue - previousValue;
-
-    if(diff == 0)
-    {
-        *value = nextValue;
-    }
-    else
-    {
-        if(diff <= 0x200)
-        {
-            if(diff >= -0x200)
-            {
-                *value = ((diff*bp)/bx) + previousValue;
-            }
-            else
-            {
-                nextValue += 0x400;
-                nextValue -= previousValue;
-
-                *value = ((nextValue *bp)/bx) + previousValue;
-            }
-        }
-        else
-        {
-            previousValue += 0x400;
-            nextValue -= previousValue;
-
-            *value = ((nextValue *bp)/bx) + previousValue;
-        }
-    }
-}
-
-void PatchInterStep(s16* value, s16 previousValue, s16 nextValue, int bp, int bx) // local
-{
-    s16 cx = previousValue;
-    s16 ax = nextValue;
-
-    if(ax == cx)
-    {
-        *value = ax;
-    }
-    else
-    {
-        *value = (((ax - cx)*bp)/bx) + cx;
-    }
-}
-
-s16 SetInterAnimObjet(int frame, sAnimation* pAnim, sBody* pBody)
+s16 SetInterAnimObjet(int frame, sAnimation* pAnim, const sBody* pBody, sPoseInstance* pose)
 {
     int numOfBonesInAnim = pAnim->m_numGroups;
     u16 keyframeLength;
@@ -815,9 +810,9 @@ s16 SetInterAnimObjet(int frame, sAnimation* pAnim, sBody* pBody)
         return(0);
     }
 
-    timeOfKeyframeStart = *(u16*)(pBody->m_scratchBuffer.data() + 4); // time of start of keyframe
+    timeOfKeyframeStart = pose->m_startTime; // time of start of keyframe
 
-	sFrame* pPreviousKeyframe = pBody->startAnim;
+	sFrame* pPreviousKeyframe = pose->m_startAnim;
 
     if(!pPreviousKeyframe)
     {
@@ -836,66 +831,13 @@ s16 SetInterAnimObjet(int frame, sAnimation* pAnim, sBody* pBody)
 
     if(time<keyframeLength) // interpolate keyframe
     {
-        if(!(flag&INFO_OPTIMISE))
+        // sorted into channels on the first sample of the keyframe
+        if (pose->m_channels.m_frame != pKeyframe)
         {
-            for (int i = 0; i < numOfBonesInAnim; i++)
-            {
-                point3dStruct& state = pBody->m_groups[i].m_state.m_delta;
-                point3dStruct& previousState = pPreviousKeyframe->m_groups[i].m_delta;
-                point3dStruct& nextState = pKeyframe->m_groups[i].m_delta;
-                switch(PatchType(&pBody->m_groups[i].m_state, pKeyframe->m_groups[i].m_type))
-                {
-                case 0: // rotate
-                    PatchInterAngle(&state.x, previousState.x, nextState.x, bp, bx);
-                    PatchInterAngle(&state.y, previousState.y, nextState.y, bp, bx);
-                    PatchInterAngle(&state.z, previousState.z, nextState.z, bp, bx);
-                    break;
-                case 1: // translate
-                case 2: // zoom
-                    PatchInterStep(&state.x, previousState.x, nextState.x, bp, bx);
-                    PatchInterStep(&state.y, previousState.y, nextState.y, bp, bx);
-                    PatchInterStep(&state.z, previousState.z, nextState.z, bp, bx);
-                    break;
-                }
-            }
+            buildAnimChannels(pose->m_channels, pose->m_groups.data(), pPreviousKeyframe->m_groups, pKeyframe->m_groups, numOfBonesInAnim, (flag & INFO_OPTIMISE) != 0, pKeyframe, bx);
         }
-        else
-        {
-            for (int i = 0; i < numOfBonesInAnim; i++)
-            {
-                point3dStruct& state = pBody->m_groups[i].m_state.m_delta;
-                point3dStruct& previousState = pPreviousKeyframe->m_groups[i].m_delta;
-                point3dStruct& nextState = pKeyframe->m_groups[i].m_delta;
-                switch (PatchType(&pBody->m_groups[i].m_state, pKeyframe->m_groups[i].m_type))
-                {
-                case 0:
-                        break;
-                case 1:
-                case 2:
-                    PatchInterStep(&state.x, previousState.x, nextState.x, bp, bx);
-                    PatchInterStep(&state.y, previousState.y, nextState.y, bp, bx);
-                    PatchInterStep(&state.z, previousState.z, nextState.z, bp, bx);
-                    break;
-                }
 
-                {
-					if (!pBody->m_groups[i].m_state.m_hasRotateDelta ||
-						!pPreviousKeyframe->m_groups[i].m_hasRotateDelta ||
-						!pKeyframe->m_groups[i].m_hasRotateDelta)
-					{
-						continue;
-					}
-
-					point3dStruct& state = pBody->m_groups[i].m_state.m_rotateDelta;
-					point3dStruct& previousState = pPreviousKeyframe->m_groups[i].m_rotateDelta;
-					point3dStruct& nextState = pKeyframe->m_groups[i].m_rotateDelta;
-
-                    PatchInterAngle(&state.x, previousState.x, nextState.x, bp, bx);
-                    PatchInterAngle(&state.y, previousState.y, nextState.y, bp, bx);
-                    PatchInterAngle(&state.z, previousState.z, nextState.z, bp, bx);
-                }
-            }
-        }
+        interpolateAnimChannels(pose->m_channels, bp, pose->m_groups.data());
 
         animStepX = (pKeyframe->m_animStep.x * bp) / bx;
         animStepY = (pKeyframe->m_animStep.y * bp) / bx;
@@ -910,12 +852,10 @@ s16 SetInterAnimObjet(int frame, sAnimation* pAnim, sBody* pBody)
         for (int i = 0; i < numOfBonesInAnim; i++)
         {
             sGroupState& nextState = pKeyframe->m_groups[i];
-            pBody->m_groups[i].m_state = nextState;
+            pose->m_groups[i] = nextState;
         };
 
-        pBody->startAnim = pKeyframe;
-
-        *(u16*)(pBody->m_scratchBuffer.data()+4) = (u16)timer;
+        SetStartAnim(pose, pKeyframe);
 
         animCurrentTime = bx;
         animKeyframeLength = bx;
@@ -27,16 +27,25 @@ struct sFrame
 {
     u16 m_timestamp;
     point3dStruct m_animStep;
-    std::vector<sGroupState> m_groups;
+    sGroupState* m_groups = nullptr; // row of the owner's [frame][group] array
 };
 
+// Like sBody, a single allocation: the frames and then their group states,
+// m_numFrames rows of m_numGroups, follow the header.
 struct sAnimation
 {
     void* m_raw;
 
     u16 m_numFrames;
     u16 m_numGroups;
-    std::vector<sFrame> m_frames;
+    arenaArray<sFrame> m_frames;
+    arenaArray<sGroupState> m_groupStates; // [frame][group]
+
+    u8* arena() { return (u8*)(this + 1); }
+
+    static void* operator new(size_t size, arenaSize arena) { return ::operator new(size + arena.size); }
+    static void operator delete(void* ptr) { ::operator delete(ptr); }
+    static void operator delete(void* ptr, arenaSize) { ::operator delete(ptr); }
 };
 
 extern hqrEntryStruct<sAnimation>* HQ_Anims;
@@ -46,12 +55,20 @@ extern hqrEntryStruct<sAnimation>* HQ_Anims;
 
 extern std::vector<sFrame> BufferAnim;
 
+void InitBufferAnim();
+
+// Sets the pose back to the body's own, as loaded
+void InitPose(sPoseInstance* pose, const sBody* body);
+// The pose of the object in ListObjets slot actorIdx, set back to the body's
+// own when the object changed body since
+sPoseInstance* GetObjectPose(int actorIdx, const sBody* body);
+
 int InitAnim(int animNum,int animType, int animInfo);
-int SetAnimObjet(int frame, sAnimation* anim, sBody* body);
-s16 SetInterAnimObjet(int frame, sAnimation* animPtr, sBody* bodyPtr);
+int SetAnimObjet(int frame, sAnimation* anim, const sBody* body, sPoseInstance* pose);
+s16 SetInterAnimObjet(int frame, sAnimation* animPtr, const sBody* bodyPtr, sPoseInstance* pose);
 s16 GetNbFramesAnim(sAnimation* animPtr);
-void StockInterAnim(sFrame& animBuffer, sBody* bodyPtr);
-void ResetStartAnim(sBody* bodyPtr);
+void StockInterAnim(sFrame& animBuffer, const sBody* bodyPtr, sPoseInstance* pose);
+void ResetStartAnim(sPoseInstance* pose);
 void GereAnim(void);
 void InitCopyBox(char* var0, char* var1);
 
@@ -265,6 +265,8 @@ void GereFrappe(void)
             actorPtr->zv.ZVZ1 += z;
             actorPtr->zv.ZVZ2 += z;
 
+            MoveObjetGrid(actorPtr);
+
             actorPtr->objectType |= AF_ANIMATED;
             actorPtr->objectType &= ~AF_BOXIFY;
 
@@ -407,6 +409,7 @@ void GereFrappe(void)
                             rangeZv.ZVZ2 += z3;
 
                             CopyZV(&rangeZv, &currentProcessedActorPtr->zv);
+                            MoveObjetGrid(currentProcessedActorPtr);
 
                             objPtr->x = xtemp;
                             objPtr->y = ytemp;
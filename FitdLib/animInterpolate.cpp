@@ -0,0 +1,228 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark keyframe interpolation (Animation)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+#include "common.h"
+
+#include "animInterpolate.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <algorithm>
+
+// PatchInterAngle took the short way around the 0x400 circle: past half a
+// turn, the delta gets a turn back and the result is read from the other side.
+// Every step wrapped to s16, so does the channel's output.
+template <typename F>
+static void visitAngleChannels(size_t offset, const point3dStruct& previous, const point3dStruct& next, F visit)
+{
+    const s16 previousValues[3] = { previous.x, previous.y, previous.z };
+    const s16 nextValues[3] = { next.x, next.y, next.z };
+
+    for (int i = 0; i < 3; i++)
+    {
+        const s16 diff = nextValues[i] - previousValues[i];
+
+        if (diff > 0x200)
+            visit(offset + i * sizeof(s16), previousValues[i] + 0x400, diff - 0x400);
+        else if (diff < -0x200)
+            visit(offset + i * sizeof(s16), previousValues[i], diff + 0x400);
+        else
+            visit(offset + i * sizeof(s16), previousValues[i], diff);
+    }
+}
+
+// PatchInterStep: the delta doesn't wrap
+template <typename F>
+static void visitStepChannels(size_t offset, const point3dStruct& previous, const point3dStruct& next, F visit)
+{
+    visit(offset + offsetof(point3dStruct, x), previous.x, (s32)next.x - previous.x);
+    visit(offset + offsetof(point3dStruct, y), previous.y, (s32)next.y - previous.y);
+    visit(offset + offsetof(point3dStruct, z), previous.z, (s32)next.z - previous.z);
+}
+
+// Calls visit(offset, base, delta) on every channel of the groups
+template <typename F>
+static void visitChannels(const sGroupState* pose, const sGroupState* previous, const sGroupState* next, int numGroups, bool optimise, F visit)
+{
+    for (int i = 0; i < numGroups; i++)
+    {
+        const size_t group = i * sizeof(sGroupState);
+
+        switch (next[i].m_type)
+        {
+        case 0: // rotate
+            if (!optimise)
+                visitAngleChannels(group + offsetof(sGroupState, m_delta), previous[i].m_delta, next[i].m_delta, visit);
+            break;
+        case 1: // translate
+        case 2: // zoom
+            visitStepChannels(group + offsetof(sGroupState, m_delta), previous[i].m_delta, next[i].m_delta, visit);
+            break;
+        }
+
+        if (optimise && pose[i].m_hasRotateDelta && previous[i].m_hasRotateDelta && next[i].m_hasRotateDelta)
+        {
+            visitAngleChannels(group + offsetof(sGroupState, m_rotateDelta), previous[i].m_rotateDelta, next[i].m_rotateDelta, visit);
+        }
+    }
+}
+
+// With |delta * time| < 2^20, the float slope * time is within 0.26 /
+// keyframeLength of the exact quotient, while a quotient that isn't an integer
+// is at least 1 / keyframeLength away from one. Half a step of bias away from
+// zero then truncates to the integer division's result.
+static bool isBlended(s32 delta, int keyframeLength)
+{
+    return (int64_t)std::abs(delta) * (keyframeLength - 1) < (1 << 20);
+}
+
+void buildAnimChannels(animChannelsStruct& channels, sGroupState* pose, const sGroupState* previous, const sGroupState* next, int numGroups, bool optimise, const sFrame* frame, int keyframeLength)
+{
+    const float reciprocal = 1.f / (float)keyframeLength;
+    const float halfStep = 0.5f * reciprocal;
+
+    channels.m_frame = frame;
+    channels.m_keyframeLength = keyframeLength;
+
+    // at most 6 channels per group, the vectors only ever grow
+    const size_t maxChannels = numGroups * 6;
+    if (channels.m_base.size() < maxChannels)
+    {
+        channels.m_base.resize(maxChannels);
+        channels.m_delta.resize(maxChannels);
+        channels.m_offsets.resize(maxChannels);
+        channels.m_slope.resize(maxChannels);
+        channels.m_bias.resize(maxChannels);
+    }
+
+    // the blended channels from the front, the others from the back
+    int count = 0;
+    int firstDivided = (int)maxChannels;
+
+    visitChannels(pose, previous, next, numGroups, optimise, [&](size_t offset, s32 base, s32 delta) {
+        const int i = isBlended(delta, keyframeLength) ? count++ : --firstDivided;
+
+        channels.m_base[i] = base;
+        channels.m_delta[i] = delta;
+        channels.m_offsets[i] = (u32)offset;
+        channels.m_slope[i] = (float)delta * reciprocal;
+        channels.m_bias[i] = delta < 0 ? -halfStep : halfStep;
+    });
+
+    channels.m_numBlended = count;
+
+    // and then right after the blended ones
+    for (int i = firstDivided; i < (int)maxChannels; i++, count++)
+    {
+        channels.m_base[count] = channels.m_base[i];
+        channels.m_delta[count] = channels.m_delta[i];
+        channels.m_offsets[count] = channels.m_offsets[i];
+    }
+
+    channels.m_numChannels = count;
+
+    for (int i = 0; i < numGroups; i++)
+    {
+        pose[i].m_type = next[i].m_type;
+    }
+}
+
+static inline void storeChannel(sGroupState* pose, u32 offset, int value)
+{
+    *(s16*)((u8*)pose + offset) = (s16)value;
+}
+
+// Channels first to count - 1, through the integer division
+static inline void divideChannels(const animChannelsStruct& channels, int first, int count, int time, sGroupState* pose)
+{
+    for (int i = first; i < count; i++)
+    {
+        // wraps like the 32-bit multiply of PatchInterStep
+        const s32 product = (s32)((u32)channels.m_delta[i] * (u32)time);
+        storeChannel(pose, channels.m_offsets[i], channels.m_base[i] + product / channels.m_keyframeLength);
+    }
+}
+
+void interpolateAnimChannelsScalar(const animChannelsStruct& channels, int time, sGroupState* pose)
+{
+    divideChannels(channels, 0, channels.m_numChannels, time, pose);
+}
+
+// Not on the Dreamcast, which would run the vectors one lane at a time.
+#if defined(__GNUC__) && !defined(DREAMCAST)
+
+typedef int32_t animVec4i __attribute__((vector_size(16)));
+typedef float animVec4f __attribute__((vector_size(16)));
+
+template <typename T>
+static inline T loadVec4(const void* data)
+{
+    T v;
+    memcpy(&v, data, sizeof(v));
+    return v;
+}
+
+void interpolateAnimChannels(const animChannelsStruct& channels, int time, sGroupState* pose)
+{
+    const float timeValue = (float)time;
+
+    int i = 0;
+    s32 values[64];
+
+    // blended a chunk at a time, then written into the groups
+    while (i + 4 <= channels.m_numBlended)
+    {
+        const int chunk = std::min((channels.m_numBlended - i) & ~3, 64);
+
+        for (int j = 0; j < chunk; j += 4)
+        {
+            const animVec4f slope = loadVec4<animVec4f>(channels.m_slope.data() + i + j);
+            const animVec4f bias = loadVec4<animVec4f>(channels.m_bias.data() + i + j);
+            const animVec4i base = loadVec4<animVec4i>(channels.m_base.data() + i + j);
+
+            const animVec4i result = base + __builtin_convertvector(slope * timeValue + bias, animVec4i);
+            memcpy(values + j, &result, sizeof(result));
+        }
+
+        for (int j = 0; j < chunk; j++)
+        {
+            storeChannel(pose, channels.m_offsets[i + j], values[j]);
+        }
+
+        i += chunk;
+    }
+
+    divideChannels(channels, i, channels.m_numChannels, time, pose);
+}
+
+#else
+
+void interpolateAnimChannels(const animChannelsStruct& channels, int time, sGroupState* pose)
+{
+    const float timeValue = (float)time;
+
+    // the same truncation as the vectors, one channel at a time
+    for (int i = 0; i < channels.m_numBlended; i++)
+    {
+        storeChannel(pose, channels.m_offsets[i], channels.m_base[i] + (int)(channels.m_slope[i] * timeValue + channels.m_bias[i]));
+    }
+
+    divideChannels(channels, channels.m_numBlended, channels.m_numChannels, time, pose);
+}
+
+#endif
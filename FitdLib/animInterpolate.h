@@ -0,0 +1,62 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark keyframe interpolation (Animation)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+// SetInterAnimObjet's blend of a pose between two keyframes. The bones are
+// sorted into channels once per keyframe: every rotate, translate or zoom
+// component becomes value = base + delta * time / keyframeLength, whatever
+// PatchInterAngle or PatchInterStep did for it. Each sample then blends all
+// the channels, 4 at a time where GCC vector extensions are available. Results
+// are bit exact with the one-channel-at-a-time integer division
+// (interpolateAnimChannelsScalar) and with the per bone code they replaced,
+// which tools/animbench checks.
+
+struct sGroupState;
+struct sFrame;
+
+struct animChannelsStruct
+{
+    const sFrame* m_frame = nullptr; // keyframe blended to, nullptr until built
+    int m_keyframeLength = 0;
+    int m_numChannels = 0;
+
+    // The first m_numBlended channels, |delta| * (keyframeLength - 1) < 2^20,
+    // blend as truncate(m_slope * time + m_bias) without dividing
+    int m_numBlended = 0;
+
+    // Sized for the most channels built so far
+    std::vector<s32> m_base;
+    std::vector<s32> m_delta;
+    std::vector<u32> m_offsets; // byte offset of the s16 written in the pose's sGroupState array
+    std::vector<float> m_slope;
+    std::vector<float> m_bias;
+};
+
+// Sorts numGroups groups blended from previous to next into channels, and
+// sets the type of each pose group to next's, as PatchType did. optimise is
+// INFO_OPTIMISE: rotate groups keep their m_delta and blend m_rotateDelta
+// when pose, previous and next all have one.
+void buildAnimChannels(animChannelsStruct& channels, sGroupState* pose, const sGroupState* previous, const sGroupState* next, int numGroups, bool optimise, const sFrame* frame, int keyframeLength);
+
+// Writes every channel at time (0 <= time < keyframeLength) into pose.
+void interpolateAnimChannels(const animChannelsStruct& channels, int time, sGroupState* pose);
+void interpolateAnimChannelsScalar(const animChannelsStruct& channels, int time, sGroupState* pose);
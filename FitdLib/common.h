@@ -135,6 +135,7 @@ int getCVarsIdx(int);
 #include "screen.h"
 #include "videoMode.h"
 #include "pak.h"
+#include "prefetch.h"
 #include "unpack.h"
 #include "tatou.h"
 #include "threadCode.h"
@@ -150,6 +151,7 @@ int getCVarsIdx(int);
 #include "anim.h"
 #include "animAction.h"
 #include "actorList.h"
+#include "objectGrid.h"
 #include "mainLoop.h"
 #include "inventory.h"
 #include "startupMenu.h"
@@ -70,12 +70,39 @@
 #undef USE_OPENGL_3_2
 #endif
 
+#ifdef FITD_HEADLESS
+#undef USE_IMGUI
+#undef FITD_DEBUGGER
+#undef USE_SDL
+#undef USE_OPENGL_3_2
+#endif
+
 #ifdef MACOSX
 #define UNIX
 #endif
 
 #define HAS_YM3812 1
 
+// Budget of the body/anim/life/hybrid/matrix caches, as a multiple of the
+// original DOS sizes. Least recently used resources are evicted past it.
+// 0 keeps every resource loaded until the next floor change.
+#ifndef HQR_BUDGET_SCALE
+#ifdef DREAMCAST
+#define HQR_BUDGET_SCALE 4
+#else
+#define HQR_BUDGET_SCALE 16
+#endif
+#endif
+
+// Bytes of decoded PAK entries the prefetcher may keep staged ahead of use.
+#ifndef PREFETCH_STAGING_SIZE
+#ifdef DREAMCAST
+#define PREFETCH_STAGING_SIZE (1024 * 1024)
+#else
+#define PREFETCH_STAGING_SIZE (16 * 1024 * 1024)
+#endif
+#endif
+
 #include <stdint.h>
 
 // Prefer EPI's type definitions for core game types.
@@ -78,7 +78,7 @@ static inline float fitd_sinf(float r) {
     fitd_fpscr_restore(old);
     return out;
 #else
-    return std::sinf(r);
+    return ::sinf(r);
 #endif
 }
 
@@ -89,7 +89,7 @@ static inline float fitd_cosf(float r) {
     fitd_fpscr_restore(old);
     return out;
 #else
-    return std::cosf(r);
+    return ::cosf(r);
 #endif
 }
 
@@ -100,7 +100,7 @@ static inline float fitd_sqrtf(float v) {
     fitd_fpscr_restore(old);
     return out;
 #else
-    return std::sqrtf(v);
+    return ::sqrtf(v);
 #endif
 }
 
@@ -19,6 +19,7 @@
 
 #include <vector>
 #include "common.h"
+#include "hybrid.h"
 
 #ifdef FITD_DEBUGGER
 
@@ -127,6 +128,19 @@ void InputS16(const char* name, s16* value)
 
     *value = intValue;
 }
+
+template <typename T>
+void DisplayHqrStats(hqrEntryStruct<T>* hqrPtr)
+{
+    if (!hqrPtr)
+        return;
+
+    const hqrStatsStruct& stats = HQR_GetStats(hqrPtr);
+    const u32 total = stats.hits + stats.misses;
+
+    ImGui::Text("%-10s hits:%6u misses:%5u (%5.1f%%)", HQR_GetName(hqrPtr), stats.hits, stats.misses, total ? (stats.hits * 100.f) / total : 0.f);
+    ImGui::Text("           %7dK/%7dK evictions:%5u (%uK) over budget:%u", HQR_GetUsedSize(hqrPtr) / 1024, HQR_GetBudget(hqrPtr) / 1024, stats.evictions, stats.evictedBytes / 1024, stats.overBudgetLoads);
+}
 #endif
 
 void debugger_draw(void)
@@ -139,10 +153,23 @@ void debugger_draw(void)
             ImGui::MenuItem("No Collisions", nullptr, &debuggerVar_noHardClip);
             ImGui::Combo("Collision", (int*)&hardColDisplayMode, "None\0Wireframe\0Filled\0");
             ImGui::Combo("Triggers", (int*)&sceColDisplayMode, "None\0Wireframe\0Filled\0");
+            ImGui::Separator();
+            ImGui::MenuItem("Cull back faces", nullptr, &cullBackFaces);
+            ImGui::MenuItem("Cull off screen", nullptr, &cullOffScreen);
+            ImGui::Text("Primitives kept:%u back facing:%u off screen:%u", primCullStats.kept, primCullStats.backFacing, primCullStats.offScreen);
+            ImGui::Separator();
+            ImGui::MenuItem("Cache still objects", nullptr, &displayCacheEnabled);
+            ImGui::Text("Objects cached:%u drawn:%u", displayCacheStats.hits, displayCacheStats.misses);
+            ImGui::MenuItem("Display actors on job threads", nullptr, &prepareActorsEnabled);
+            ImGui::Separator();
+            ImGui::MenuItem("Check the actor grid", nullptr, &objectGridCheckEnabled);
+            ImGui::Text("Grid queries:%u mismatches:%u", objectGridCheckStats.queries, objectGridCheckStats.mismatches);
             ImGui::EndMenu();
         }
         ImGui::EndMainMenuBar();
     }
+    primCullStats = primCullStatsStruct(); // the menu shows per frame counts
+    displayCacheStats = displayCacheStatsStruct();
 
     if(debuggerVar_debugMenuDisplayed)
     {
@@ -242,6 +269,23 @@ void debugger_draw(void)
             ImGui::End();
         }
 
+        {
+            ImGui::Begin("Resources");
+
+            DisplayHqrStats(HQ_Bodys);
+            DisplayHqrStats(HQ_Anims);
+            DisplayHqrStats(listLife);
+            DisplayHqrStats(listTrack);
+            DisplayHqrStats(HQ_Hybrides);
+            DisplayHqrStats(HQ_Matrices);
+
+            const prefetchStatsStruct& prefetchStats = Prefetch_GetStats();
+            ImGui::Separator();
+            ImGui::Text("Prefetch   requests:%5u hits:%5u waits:%4u dropped:%5u staged:%uK", prefetchStats.requests, prefetchStats.hits, prefetchStats.waits, prefetchStats.dropped, prefetchStats.stagedBytes / 1024);
+
+            ImGui::End();
+        }
+
         {
             ImGui::Begin("Active objects");
 
@@ -258,6 +302,10 @@ void debugger_draw(void)
             ImGui::PushItemWidth(100);
             
             InputS16("world index", &pObject->indexInWorld); ImGui::SameLine();
+            if (pObject->indexInWorld != -1)
+                AddActiveObjet(selectedObject);
+            else
+                RemoveActiveObjet(selectedObject);
             InputS16("bodyNum", &pObject->bodyNum);
 //            InputS16("_flags", &pObject->_flags);
             InputS16("dynFlags", &pObject->dynFlags);
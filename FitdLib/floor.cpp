@@ -41,6 +41,7 @@ void LoadEtage(int floorNumber)
 
     HQR_Reset(HQ_Bodys);
     HQR_Reset(HQ_Anims);
+    Prefetch_Flush();
 
     g_currentFloor = floorNumber;
 
@@ -167,7 +168,12 @@ void LoadEtage(int floorNumber)
                 sceZoneData+=0x10;
             }
         }
+
+        buildRoomGrid(currentRoomDataPtr->hardColGrid, &currentRoomDataPtr->hardColTable.data()->zv, sizeof(hardColStruct), currentRoomDataPtr->numHardCol);
+        buildRoomGrid(currentRoomDataPtr->sceZoneGrid, &currentRoomDataPtr->sceZoneTable.data()->zv, sizeof(sceZoneStruct), currentRoomDataPtr->numSceZone);
     }
+
+    InitObjetGrid();
     ///////////////////////////////////
 
     /////////////////////////////////////////////////
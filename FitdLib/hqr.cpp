@@ -25,36 +25,291 @@ template <typename T>
 struct hqrSubEntryStruct
 {
     s16 key;
-    s16 size;
+    s32 size;
     unsigned int lastTimeUsed;
+    u32 lastFrameUsed;
     T* ptr;
+    int nextFree; // intrusive free list, -1 terminated
+    int lruPrev; // intrusive LRU list, most recently used first
+    int lruNext;
 };
 
 template <typename T>
 struct hqrEntryStruct
 {
     std::string string;
-    u16 maxFreeData;
-    u16 sizeFreeData;
+    s32 maxFreeData;
+    s32 sizeFreeData;
     u16 numMaxEntry;
     u16 numUsedEntry;
     std::vector<hqrSubEntryStruct<T>> entries;
+
+    // open addressing index: resource key -> slot in entries (-1 = empty)
+    std::vector<int> hashTable;
+    int firstFree;
+
+    // only caches with a budget evict, the others keep everything until HQR_Reset
+    bool evictable;
+    int lruHead;
+    int lruTail;
+
+    hqrStatsStruct stats;
 };
 
+// Entries used during the current frame are never evicted, callers may still hold their pointers
+static u32 hqrCurrentFrame = 0;
+
+void HQR_NextFrame()
+{
+    hqrCurrentFrame++;
+}
+
+static unsigned int hqrHashKey(int key, unsigned int mask)
+{
+    return ((u32)key * 2654435761u) & mask;
+}
+
+template <typename T>
+static void hqrLruUnlink(hqrEntryStruct<T>* hqrPtr, int slot)
+{
+    hqrSubEntryStruct<T>& entry = hqrPtr->entries[slot];
+
+    if (entry.lruPrev != -1)
+        hqrPtr->entries[entry.lruPrev].lruNext = entry.lruNext;
+    else
+        hqrPtr->lruHead = entry.lruNext;
+
+    if (entry.lruNext != -1)
+        hqrPtr->entries[entry.lruNext].lruPrev = entry.lruPrev;
+    else
+        hqrPtr->lruTail = entry.lruPrev;
+
+    entry.lruPrev = -1;
+    entry.lruNext = -1;
+}
+
+template <typename T>
+static void hqrLruPushFront(hqrEntryStruct<T>* hqrPtr, int slot)
+{
+    hqrSubEntryStruct<T>& entry = hqrPtr->entries[slot];
+
+    entry.lruPrev = -1;
+    entry.lruNext = hqrPtr->lruHead;
+    if (hqrPtr->lruHead != -1)
+        hqrPtr->entries[hqrPtr->lruHead].lruPrev = slot;
+    else
+        hqrPtr->lruTail = slot;
+    hqrPtr->lruHead = slot;
+}
+
+template <typename T>
+static void hqrTouchEntry(hqrEntryStruct<T>* hqrPtr, hqrSubEntryStruct<T>* pEntry)
+{
+    pEntry->lastTimeUsed = timer;
+    pEntry->lastFrameUsed = hqrCurrentFrame;
+
+    const int slot = (int)(pEntry - hqrPtr->entries.data());
+    if (hqrPtr->lruHead != slot)
+    {
+        hqrLruUnlink(hqrPtr, slot);
+        hqrLruPushFront(hqrPtr, slot);
+    }
+}
+
 template <typename T>
-hqrSubEntryStruct<T>* quickFindEntry(int index, int numMax, std::vector<hqrSubEntryStruct<T>>& ptr) // no RE. Original was probably faster
+static void hqrRebuildIndex(hqrEntryStruct<T>* hqrPtr)
 {
-    for(int i=0;i<numMax;i++)
+    unsigned int hashSize = 16;
+    while (hashSize < hqrPtr->entries.size() * 2u)
+        hashSize <<= 1;
+
+    hqrPtr->hashTable.assign(hashSize, -1);
+    hqrPtr->firstFree = -1;
+
+    const unsigned int mask = hashSize - 1;
+
+    // push in reverse so that the lowest slots are handed out first
+    for (int i = (int)hqrPtr->entries.size() - 1; i >= 0; i--)
     {
-        if((ptr[i].key == index) && ptr[i].ptr)
+        hqrSubEntryStruct<T>& entry = hqrPtr->entries[i];
+
+        if (entry.ptr)
         {
-            return &ptr[i];
+            unsigned int hash = hqrHashKey(entry.key, mask);
+            while (hqrPtr->hashTable[hash] != -1)
+                hash = (hash + 1) & mask;
+            hqrPtr->hashTable[hash] = i;
         }
+        else
+        {
+            entry.nextFree = hqrPtr->firstFree;
+            hqrPtr->firstFree = i;
+        }
+    }
+}
+
+template <typename T>
+static void hqrInitEntries(hqrEntryStruct<T>* hqrPtr, int numEntries)
+{
+    hqrPtr->numMaxEntry = numEntries;
+    hqrPtr->numUsedEntry = 0;
+    hqrPtr->entries.resize(numEntries);
+
+    for (int i = 0; i < numEntries; i++)
+    {
+        hqrPtr->entries[i].ptr = nullptr;
+    }
+
+    hqrPtr->lruHead = -1;
+    hqrPtr->lruTail = -1;
+    hqrRebuildIndex(hqrPtr);
+}
+
+template <typename T>
+hqrSubEntryStruct<T>* hqrFindEntry(hqrEntryStruct<T>* hqrPtr, int key)
+{
+    const unsigned int mask = (unsigned int)hqrPtr->hashTable.size() - 1;
+
+    for (unsigned int hash = hqrHashKey(key, mask); hqrPtr->hashTable[hash] != -1; hash = (hash + 1) & mask)
+    {
+        hqrSubEntryStruct<T>* pEntry = &hqrPtr->entries[hqrPtr->hashTable[hash]];
+        if (pEntry->key == key)
+            return pEntry;
     }
 
     return nullptr;
 }
 
+// Takes a slot off the free list and indexes it under key. The caller fills ptr.
+template <typename T>
+hqrSubEntryStruct<T>* hqrAllocEntry(hqrEntryStruct<T>* hqrPtr, int key)
+{
+    if (hqrPtr->firstFree == -1)
+    {
+        int numEntries = hqrPtr->entries.size();
+        int newNumEntries = numEntries ? numEntries * 2 : 16;
+        if (newNumEntries > 0xFFFF)
+            newNumEntries = 0xFFFF;
+        if (newNumEntries == numEntries)
+            return nullptr;
+
+        hqrPtr->entries.resize(newNumEntries);
+        for (int i = numEntries; i < newNumEntries; i++)
+        {
+            hqrPtr->entries[i].ptr = nullptr;
+        }
+        hqrPtr->numMaxEntry = newNumEntries;
+
+        hqrRebuildIndex(hqrPtr);
+    }
+
+    int slot = hqrPtr->firstFree;
+    hqrSubEntryStruct<T>* pEntry = &hqrPtr->entries[slot];
+    hqrPtr->firstFree = pEntry->nextFree;
+
+    const unsigned int mask = (unsigned int)hqrPtr->hashTable.size() - 1;
+    unsigned int hash = hqrHashKey(key, mask);
+    while (hqrPtr->hashTable[hash] != -1)
+        hash = (hash + 1) & mask;
+    hqrPtr->hashTable[hash] = slot;
+
+    pEntry->key = key;
+    pEntry->nextFree = -1;
+    pEntry->lastFrameUsed = hqrCurrentFrame;
+    hqrLruPushFront(hqrPtr, slot);
+    hqrPtr->numUsedEntry++;
+
+    return pEntry;
+}
+
+// Unindexes the slot and returns it to the free list. The caller frees ptr.
+template <typename T>
+void hqrReleaseEntry(hqrEntryStruct<T>* hqrPtr, hqrSubEntryStruct<T>* pEntry)
+{
+    const int slot = (int)(pEntry - hqrPtr->entries.data());
+    const unsigned int mask = (unsigned int)hqrPtr->hashTable.size() - 1;
+
+    unsigned int hash = hqrHashKey(pEntry->key, mask);
+    while (hqrPtr->hashTable[hash] != slot)
+        hash = (hash + 1) & mask;
+
+    // backward shift deletion keeps probe chains intact without tombstones
+    unsigned int next = (hash + 1) & mask;
+    while (hqrPtr->hashTable[next] != -1)
+    {
+        unsigned int home = hqrHashKey(hqrPtr->entries[hqrPtr->hashTable[next]].key, mask);
+        if (((next - home) & mask) >= ((next - hash) & mask))
+        {
+            hqrPtr->hashTable[hash] = hqrPtr->hashTable[next];
+            hash = next;
+        }
+        next = (next + 1) & mask;
+    }
+    hqrPtr->hashTable[hash] = -1;
+
+    hqrLruUnlink(hqrPtr, slot);
+
+    pEntry->ptr = nullptr;
+    pEntry->nextFree = hqrPtr->firstFree;
+    hqrPtr->firstFree = slot;
+    hqrPtr->numUsedEntry--;
+}
+
+template <typename T>
+static void hqrDeleteResource(T* ptr)
+{
+    if constexpr (std::is_same_v<T, char>) {
+        delete[] ptr;
+    }
+    else {
+        if constexpr (std::is_same_v<T, sAnimation>) {
+            // poses remember the keyframes they interpolate from and to
+            if (!ptr->m_frames.empty())
+            {
+                const sFrame* pFirst = ptr->m_frames.data();
+                const sFrame* pLast = pFirst + ptr->m_frames.size();
+                for (sPoseInstance& pose : ListPoses)
+                {
+                    if (pose.m_startAnim >= pFirst && pose.m_startAnim < pLast)
+                    {
+                        pose.m_startAnim = nullptr;
+                        pose.m_channels.m_frame = nullptr;
+                    }
+                    if (pose.m_channels.m_frame >= pFirst && pose.m_channels.m_frame < pLast)
+                        pose.m_channels.m_frame = nullptr;
+                }
+            }
+        }
+        delete ptr;
+    }
+}
+
+// Evicts least recently used entries until size bytes fit in the budget.
+// Returns false if the entries still loaded were all used during this frame.
+template <typename T>
+static bool hqrEvict(hqrEntryStruct<T>* hqrPtr, int size)
+{
+    while (hqrPtr->sizeFreeData < size)
+    {
+        const int slot = hqrPtr->lruTail;
+        if (slot == -1)
+            return false;
+
+        hqrSubEntryStruct<T>* pEntry = &hqrPtr->entries[slot];
+        if (pEntry->lastFrameUsed == hqrCurrentFrame)
+            return false;
+
+        hqrPtr->stats.evictions++;
+        hqrPtr->stats.evictedBytes += pEntry->size;
+        hqrPtr->sizeFreeData += pEntry->size;
+
+        hqrDeleteResource(pEntry->ptr);
+        hqrReleaseEntry(hqrPtr, pEntry);
+    }
+
+    return true;
+}
+
 template <typename T>
 hqrEntryStruct<T>* HQR_InitRessource(const char* name, int size, int numEntries)
 {
@@ -63,18 +318,12 @@ hqrEntryStruct<T>* HQR_InitRessource(const char* name, int size, int numEntries)
     if(!dest)
         return NULL;
 
-    numEntries = 2000;
     dest->string = name;
     dest->sizeFreeData = size;
     dest->maxFreeData = size;
-    dest->numMaxEntry = numEntries;
-    dest->numUsedEntry = 0;
-    dest->entries.resize(numEntries);
-
-    for(int i=0;i<numEntries;i++)
-    {
-        dest->entries[i].ptr = nullptr;
-    }
+    dest->evictable = false;
+    dest->stats = {};
+    hqrInitEntries(dest, numEntries);
 
     return(dest);
 }
@@ -82,22 +331,21 @@ hqrEntryStruct<T>* HQR_InitRessource(const char* name, int size, int numEntries)
 int HQ_Malloc(hqrEntryStruct<char>* hqrPtr,int size)
 {
     int key;
-    int entryNum;
 
     if(hqrPtr->sizeFreeData<size)
         return(-1);
 
-    entryNum = hqrPtr->numUsedEntry;
-
     key = hqrKeyGen;
 
-    hqrPtr->entries[entryNum].key = key;
+    hqrSubEntryStruct<char>* pEntry = hqrAllocEntry(hqrPtr, key);
+    if(!pEntry)
+        return(-1);
 
     //  dataPtr1[entryNum].offset = hqrPtr->maxFreeData - hqrPtr->sizeFreeData;
-    hqrPtr->entries[entryNum].size = size;
-    hqrPtr->entries[entryNum].ptr = (char*)malloc(size);
+    pEntry->size = size;
+    pEntry->lastTimeUsed = timer;
+    pEntry->ptr = new char[size];
 
-    hqrPtr->numUsedEntry++;
     hqrPtr->sizeFreeData -= size;
 
     hqrKeyGen++;
@@ -111,7 +359,7 @@ char* HQ_PtrMalloc(hqrEntryStruct<char>* hqrPtr, int index)
     if(index<0)
         return NULL;
 
-    hqrSubEntryStruct<char>* ptr = quickFindEntry(index, hqrPtr->numUsedEntry, hqrPtr->entries);
+    hqrSubEntryStruct<char>* ptr = hqrFindEntry(hqrPtr, index);
 
     if(!ptr)
         return NULL;
@@ -119,15 +367,38 @@ char* HQ_PtrMalloc(hqrEntryStruct<char>* hqrPtr, int index)
     return(ptr->ptr);
 }
 
+// Places count Ts at offset in the arena and advances offset
+template <typename T>
+static arenaArray<T> allocArenaArray(u8* arena, size_t& offset, u32 count)
+{
+    arenaArray<T> array;
+    array.m_data = (T*)(arena + offset);
+    array.m_size = count;
+    offset += count * sizeof(T);
+    return array;
+}
+
 sAnimation* createAnimationFromPtr(void* ptr, int size)
 {
     u8* animPtr = (u8*)ptr;
 
-    sAnimation* pAnimation = new sAnimation;
+    u16 numFrames = READ_LE_U16(animPtr);
+    u16 numGroups = READ_LE_U16(animPtr + 2);
+
+    static_assert(sizeof(sAnimation) % alignof(sFrame) == 0 && sizeof(sFrame) % alignof(sGroupState) == 0, "arena arrays must stay aligned");
+
+    size_t animationArenaSize = numFrames * sizeof(sFrame) + numFrames * numGroups * sizeof(sGroupState);
+
+    sAnimation* pAnimation = new (arenaSize{ animationArenaSize }) sAnimation;
+    size_t arenaOffset = 0;
+    memset(pAnimation->arena(), 0, animationArenaSize);
+
+    pAnimation->m_frames = allocArenaArray<sFrame>(pAnimation->arena(), arenaOffset, numFrames);
+    pAnimation->m_groupStates = allocArenaArray<sGroupState>(pAnimation->arena(), arenaOffset, numFrames * numGroups);
 
     pAnimation->m_raw = ptr;
-    pAnimation->m_numFrames = READ_LE_U16(animPtr); animPtr += 2;
-    pAnimation->m_numGroups = READ_LE_U16(animPtr); animPtr += 2;
+    pAnimation->m_numFrames = numFrames; animPtr += 2;
+    pAnimation->m_numGroups = numGroups; animPtr += 2;
 
     int fullSizeNoOptim = 2 + 2 + pAnimation->m_numFrames * (2 + 2 + 2 + 2 + pAnimation->m_numGroups * (2 + 2 + 2 + 2));
     int fullSizeWithOptim = 2 + 2 + pAnimation->m_numFrames * (2 + 2 + 2 + 2 + pAnimation->m_numGroups * (2 + 2 + 2 + 2 + 2 + 2 + 2 + 2));
@@ -141,7 +412,6 @@ sAnimation* createAnimationFromPtr(void* ptr, int size)
         assert(size == fullSizeNoOptim);
     }
 
-    pAnimation->m_frames.resize(pAnimation->m_numFrames);
     for (int i = 0; i < pAnimation->m_numFrames; i++)
     {
         sFrame* pFrame = &pAnimation->m_frames[i];
@@ -151,7 +421,7 @@ sAnimation* createAnimationFromPtr(void* ptr, int size)
         pFrame->m_animStep.y = READ_LE_S16(animPtr); animPtr += 2;
         pFrame->m_animStep.z = READ_LE_S16(animPtr); animPtr += 2;
 
-        pFrame->m_groups.resize(pAnimation->m_numGroups);
+        pFrame->m_groups = pAnimation->m_groupStates.data() + i * pAnimation->m_numGroups;
         for (int i = 0; i < pAnimation->m_numGroups; i++)
         {
             sGroupState* pGroup = &pFrame->m_groups[i];
@@ -174,14 +444,269 @@ sAnimation* createAnimationFromPtr(void* ptr, int size)
     return pAnimation;
 }
 
+// The fields of a raw group record that shape the bone hierarchy
+struct rawGroupStruct
+{
+    int start;
+    int numVertices;
+    int baseVertices;
+    s8 orgGroup;
+    s8 numGroup;
+};
+
+// Records group as reached by rotating group rotated, then recurses into the
+// children RotateGroupe finds from group: the entries from group on, over
+// numGroups - m_numGroup of them, whose m_orgGroup is group's m_numGroup.
+// Returns false where that scan would leave the group table or never end.
+static bool visitGroupChildren(const std::vector<rawGroupStruct>& groups, int group, int rotated, int depth, std::vector<std::pair<u16, u16>>& reached)
+{
+    int numGroups = (int)groups.size();
+    if (depth > numGroups || reached.size() >= std::min((size_t)numGroups * numGroups, (size_t)0xFFFF))
+        return false;
+
+    reached.push_back(std::make_pair((u16)group, (u16)rotated));
+
+    int scan = numGroups - groups[group].numGroup;
+    if (scan <= 0 || group + scan > numGroups)
+        return false;
+
+    for (int i = group; i < group + scan; i++)
+    {
+        if (groups[i].orgGroup == groups[group].numGroup)
+        {
+            if (!visitGroupChildren(groups, i, rotated, depth + 1, reached))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Flattens the bone hierarchy of an INFO_ANIM body (see sGroupLink) from its
+// raw group order and records. Fills links and chains, or only counts when
+// links is null. Returns the number of chain entries; flat tells whether
+// AnimateCloud can use them, which needs disjoint, in range vertex groups.
+static u32 readBodyGroupLinks(u8* groupBuffer, u16 numGroups, u16 numVertices, u16 flags, sGroupLink* links, u16* chains, bool& flat)
+{
+    int recordSize = (flags & INFO_OPTIMISE) ? 0x18 : 0x10;
+    u8* orderBuffer = groupBuffer;
+    u8* recordBuffer = groupBuffer + numGroups * 2;
+
+    std::vector<rawGroupStruct> groups(numGroups);
+    for (int i = 0; i < numGroups; i++)
+    {
+        u8* record = recordBuffer + i * recordSize;
+        groups[i].start = READ_LE_S16(record) / 6;
+        groups[i].numVertices = READ_LE_S16(record + 2);
+        groups[i].baseVertices = READ_LE_S16(record + 4) / 6;
+        groups[i].orgGroup = READ_LE_S8(record + 6);
+        groups[i].numGroup = READ_LE_S8(record + 7);
+    }
+
+    flat = true;
+
+    std::vector<s16> owner(numVertices, -1);
+    for (int i = 0; i < numGroups && flat; i++)
+    {
+        if (groups[i].start < 0 || groups[i].numVertices < 0 || groups[i].start + groups[i].numVertices > numVertices
+            || groups[i].baseVertices < 0 || groups[i].baseVertices >= numVertices)
+        {
+            flat = false;
+            break;
+        }
+
+        for (int j = 0; j < groups[i].numVertices; j++)
+        {
+            if (owner[groups[i].start + j] != -1)
+            {
+                flat = false;
+                break;
+            }
+            owner[groups[i].start + j] = i;
+        }
+    }
+
+    // (group, group whose pose reaches it), in m_groupOrder order. AITD2+
+    // groups only pose themselves, AITD1 rotations carry over to children.
+    std::vector<std::pair<u16, u16>> reached;
+    for (int i = 0; i < numGroups && flat; i++)
+    {
+        int group = READ_LE_U16(orderBuffer + i * 2) / recordSize;
+        if (group >= numGroups)
+            flat = false;
+        else if (flags & INFO_OPTIMISE)
+            reached.push_back(std::make_pair((u16)group, (u16)group));
+        else
+            flat = visitGroupChildren(groups, group, group, 0, reached);
+    }
+
+    if (!flat)
+        reached.clear();
+
+    if (links)
+    {
+        for (int i = 0; i < numGroups; i++)
+        {
+            links[i].m_chainStart = 0;
+            links[i].m_chainSize = 0;
+            links[i].m_baseGroup = flat ? owner[groups[i].baseVertices] : -1;
+        }
+
+        for (const auto& entry : reached)
+            links[entry.first].m_chainSize++;
+
+        for (int i = 1; i < numGroups; i++)
+            links[i].m_chainStart = links[i - 1].m_chainStart + links[i - 1].m_chainSize;
+
+        std::vector<u16> fill(numGroups, 0);
+        for (const auto& entry : reached)
+            chains[links[entry.first].m_chainStart + fill[entry.first]++] = entry.second;
+    }
+
+    return (u32)reached.size();
+}
+
+// Reads one primitive. Its points go to points, or are only counted when
+// points is null. Returns the start of the next primitive.
+static u8* readBodyPrimitive(u8* bodyBuffer, sPrimitive* pPrimitive, u16* points)
+{
+    pPrimitive->m_type = (primTypeEnum)READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+    pPrimitive->m_size = 0;
+    pPrimitive->m_even = 0;
+
+    bool hasUVs = false;
+
+    switch (pPrimitive->m_type)
+    {
+    case primTypeEnum_Line:
+        pPrimitive->m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_even = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_numPoints = 2;
+        break;
+    case primTypeEnum_Poly:
+    case processPrim_PolyTexture8:
+        pPrimitive->m_numPoints = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        break;
+    case primTypeEnum_Point:
+    case primTypeEnum_BigPoint:
+    case primTypeEnum_Zixel:
+        pPrimitive->m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_even = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_numPoints = 1;
+        break;
+    case primTypeEnum_Sphere:
+        pPrimitive->m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_even = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_size = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
+        pPrimitive->m_numPoints = 1;
+        break;
+    case processPrim_PolyTexture9:
+    case processPrim_PolyTexture10:
+        pPrimitive->m_numPoints = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        pPrimitive->m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
+        hasUVs = true;
+        break;
+    default:
+        assert(0);
+        pPrimitive->m_numPoints = 0;
+        break;
+    }
+
+    pPrimitive->m_points = points;
+    for (int j = 0; j < pPrimitive->m_numPoints; j++)
+    {
+        if (points)
+            points[j] = READ_LE_U16(bodyBuffer) / 6;
+        bodyBuffer += 2;
+    }
+
+    // UVs, not used
+    if (hasUVs)
+        bodyBuffer += pPrimitive->m_numPoints * 2;
+
+    return bodyBuffer;
+}
+
 sBody* createBodyFromPtr(void* ptr)
 {
     u8* bodyBuffer = (u8*)ptr;
 
-    sBody* newBody = new sBody;
+    // first pass: sizes of everything that goes in the arena
+    u16 flags = READ_LE_U16(bodyBuffer);
+    u8* sizePtr = bodyBuffer + 2 + 12;
 
+    u16 scratchBufferSize = READ_LE_U16(sizePtr); sizePtr += 2 + scratchBufferSize;
+    u16 numVertices = READ_LE_U16(sizePtr); sizePtr += 2 + numVertices * 6;
+
+    if (flags & INFO_TORTUE)
+    {
+        assert(0); // never used
+    }
+
+    u16 numGroups = 0;
+    u8* groupBuffer = nullptr;
+    u32 numChains = 0;
+    bool flatGroups = false;
+    if (flags & INFO_ANIM)
+    {
+        numGroups = READ_LE_U16(sizePtr); sizePtr += 2;
+        groupBuffer = sizePtr;
+        numChains = readBodyGroupLinks(groupBuffer, numGroups, numVertices, flags, nullptr, nullptr, flatGroups);
+        sizePtr += numGroups * ((flags & INFO_OPTIMISE) ? (2 + 0x18) : (2 + 0x10));
+    }
+
+    u16 numPrimitives = READ_LE_U16(sizePtr); sizePtr += 2;
+    u32 numPoints = 0;
+    for (int i = 0; i < numPrimitives; i++)
+    {
+        sPrimitive primitive;
+        sizePtr = readBodyPrimitive(sizePtr, &primitive, nullptr);
+        numPoints += primitive.m_numPoints;
+    }
+
+    // widest alignment first, sGroup and everything after only need 2
+    static_assert(sizeof(sBody) % alignof(sPrimitive) == 0, "arena must start aligned for sPrimitive");
+    static_assert(sizeof(sPrimitive) % alignof(sGroup) == 0 && sizeof(sGroup) % 2 == 0, "arena arrays must stay aligned");
+    static_assert(alignof(sGroupLink) == 2 && sizeof(sGroupLink) % 2 == 0, "arena arrays must stay aligned");
+
+    size_t bodyArenaSize = numPrimitives * sizeof(sPrimitive)
+        + numGroups * sizeof(sGroup)
+        + numGroups * sizeof(sGroupLink)
+        + numVertices * 3 * sizeof(s16)
+        + numGroups * sizeof(u16)
+        + numChains * sizeof(u16)
+        + numPoints * sizeof(u16)
+        + scratchBufferSize;
+
+    static u32 bodySerial = 0;
+
+    sBody* newBody = new (arenaSize{ bodyArenaSize }) sBody;
+    newBody->m_serial = ++bodySerial;
+    u8* arena = newBody->arena();
+    size_t arenaOffset = 0;
+    memset(arena, 0, bodyArenaSize); // as the vectors it replaces were
+
+    newBody->m_primitives = allocArenaArray<sPrimitive>(arena, arenaOffset, numPrimitives);
+    newBody->m_groups = allocArenaArray<sGroup>(arena, arenaOffset, numGroups);
+    newBody->m_groupLinks = allocArenaArray<sGroupLink>(arena, arenaOffset, numGroups);
+    newBody->m_vertices.x = allocArenaArray<s16>(arena, arenaOffset, numVertices).data();
+    newBody->m_vertices.y = allocArenaArray<s16>(arena, arenaOffset, numVertices).data();
+    newBody->m_vertices.z = allocArenaArray<s16>(arena, arenaOffset, numVertices).data();
+    newBody->m_vertices.count = numVertices;
+    newBody->m_groupOrder = allocArenaArray<u16>(arena, arenaOffset, numGroups);
+    newBody->m_groupChains = allocArenaArray<u16>(arena, arenaOffset, numChains);
+    newBody->m_pointIndices = allocArenaArray<u16>(arena, arenaOffset, numPoints);
+    newBody->m_scratchBuffer = allocArenaArray<u8>(arena, arenaOffset, scratchBufferSize); // timer at +4 is u16 aligned
+    assert(arenaOffset == bodyArenaSize);
+
+    // second pass: fill it
     newBody->m_raw = ptr;
-    newBody->m_flags = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
+    newBody->m_flags = flags; bodyBuffer += 2;
 
     newBody->m_zv.ZVX1 = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
     newBody->m_zv.ZVX2 = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
@@ -190,32 +715,23 @@ sBody* createBodyFromPtr(void* ptr)
     newBody->m_zv.ZVZ1 = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
     newBody->m_zv.ZVZ2 = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
 
-    u16 scratchBufferSize = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
-    newBody->m_scratchBuffer.resize(scratchBufferSize);
+    bodyBuffer += 2;
     for (int i = 0; i < scratchBufferSize; i++)
     {
         newBody->m_scratchBuffer[i] = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
     }
 
-    u16 numVertices = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
-    newBody->m_vertices.resize(numVertices);
+    bodyBuffer += 2;
     for (int i = 0; i < numVertices; i++)
     {
-        newBody->m_vertices[i].x = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
-        newBody->m_vertices[i].y = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
-        newBody->m_vertices[i].z = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
-    }
-
-    if (newBody->m_flags & INFO_TORTUE)
-    {
-        assert(0); // never used
+        newBody->m_vertices.x[i] = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
+        newBody->m_vertices.y[i] = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
+        newBody->m_vertices.z[i] = READ_LE_S16(bodyBuffer); bodyBuffer += 2;
     }
 
     if (newBody->m_flags & INFO_ANIM)
     {
-        u16 numGroups = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
-        newBody->m_groupOrder.reserve(numGroups);
-        newBody->m_groups.resize(numGroups);
+        bodyBuffer += 2;
 
         if (newBody->m_flags & INFO_OPTIMISE) // AITD2+
         {
@@ -223,7 +739,7 @@ sBody* createBodyFromPtr(void* ptr)
             {
                 u16 offset = READ_LE_U16(bodyBuffer);
                 assert(offset % 0x18 == 0);
-                newBody->m_groupOrder.push_back(offset / 0x18);
+                newBody->m_groupOrder[i] = offset / 0x18;
                 bodyBuffer += 2;
             }
 
@@ -251,7 +767,7 @@ sBody* createBodyFromPtr(void* ptr)
             {
                 u16 offset = READ_LE_U16(bodyBuffer);
                 assert(offset % 0x10 == 0);
-                newBody->m_groupOrder.push_back(offset / 0x10);
+                newBody->m_groupOrder[i] = offset / 0x10;
                 bodyBuffer += 2;
             }
 
@@ -270,87 +786,15 @@ sBody* createBodyFromPtr(void* ptr)
             }
         }
 
+        readBodyGroupLinks(groupBuffer, numGroups, numVertices, flags, newBody->m_groupLinks.data(), newBody->m_groupChains.data(), newBody->m_flatGroups);
     }
 
-    u16 numPrimitives = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
-    newBody->m_primitives.resize(numPrimitives);
+    bodyBuffer += 2;
+    u16* points = newBody->m_pointIndices.data();
     for (int i = 0; i < numPrimitives; i++)
     {
-        newBody->m_primitives[i].m_type = (primTypeEnum)READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-
-        switch (newBody->m_primitives[i].m_type)
-        {
-        case primTypeEnum_Line:
-            newBody->m_primitives[i].m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_even = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_points.resize(2);
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                newBody->m_primitives[i].m_points[j] = READ_LE_U16(bodyBuffer) / 6; bodyBuffer += 2;
-            }
-            break;
-        case primTypeEnum_Poly:
-            newBody->m_primitives[i].m_points.resize(READ_LE_U8(bodyBuffer)); bodyBuffer += 1;
-            newBody->m_primitives[i].m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                newBody->m_primitives[i].m_points[j] = READ_LE_U16(bodyBuffer) / 6; bodyBuffer += 2;
-            }
-            break;
-        case primTypeEnum_Point:
-        case primTypeEnum_BigPoint:
-        case primTypeEnum_Zixel:
-            newBody->m_primitives[i].m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_even = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_points.resize(1);
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                newBody->m_primitives[i].m_points[j] = READ_LE_U16(bodyBuffer) / 6; bodyBuffer += 2;
-            }
-            break;
-        case primTypeEnum_Sphere:
-            newBody->m_primitives[i].m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_even = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_size = READ_LE_U16(bodyBuffer); bodyBuffer += 2;
-            newBody->m_primitives[i].m_points.resize(1);
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                newBody->m_primitives[i].m_points[j] = READ_LE_U16(bodyBuffer) / 6; bodyBuffer += 2;
-            }
-            break;
-        case processPrim_PolyTexture8:
-            newBody->m_primitives[i].m_points.resize(READ_LE_U8(bodyBuffer)); bodyBuffer += 1;
-            newBody->m_primitives[i].m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                newBody->m_primitives[i].m_points[j] = READ_LE_U16(bodyBuffer) / 6; bodyBuffer += 2;
-            }
-            break;
-        case processPrim_PolyTexture9:
-        case processPrim_PolyTexture10:
-            newBody->m_primitives[i].m_points.resize(READ_LE_U8(bodyBuffer)); bodyBuffer += 1;
-            newBody->m_primitives[i].m_material = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            newBody->m_primitives[i].m_color = READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                newBody->m_primitives[i].m_points[j] = READ_LE_U16(bodyBuffer) / 6; bodyBuffer += 2;
-            }
-            // load UVS?
-            for (int j = 0; j < newBody->m_primitives[i].m_points.size(); j++)
-            {
-                READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-                READ_LE_U8(bodyBuffer); bodyBuffer += 1;
-            }
-            break;
-        default:
-            assert(0);
-            break;
-        }
+        bodyBuffer = readBodyPrimitive(bodyBuffer, &newBody->m_primitives[i], points);
+        points += newBody->m_primitives[i].m_numPoints;
     }
 
     return newBody;
@@ -364,11 +808,12 @@ T* HQR_Get(hqrEntryStruct<T>* hqrPtr, int index)
     if(index<0)
         return NULL;
 
-    foundEntry = quickFindEntry(index,hqrPtr->numUsedEntry,hqrPtr->entries);
+    foundEntry = hqrFindEntry(hqrPtr, index);
 
     if(foundEntry)
     {
-        foundEntry->lastTimeUsed = timer;
+        hqrPtr->stats.hits++;
+        hqrTouchEntry(hqrPtr, foundEntry);
         HQ_Load = 0;
 
         return(foundEntry->ptr);
@@ -381,56 +826,63 @@ T* HQR_Get(hqrEntryStruct<T>* hqrPtr, int index)
 		if(size == 0)
 			return NULL;
 
-        if(size>=hqrPtr->maxFreeData)
+        if(hqrPtr->evictable)
+        {
+            // what can't be freed goes over budget rather than failing the load
+            if(!hqrEvict(hqrPtr, size))
+            {
+                hqrPtr->stats.overBudgetLoads++;
+            }
+        }
+        else if(size>=hqrPtr->maxFreeData)
         {
             fatalError(1,hqrPtr->string.c_str());
         }
 
-        unsigned int time = timer;
+        hqrPtr->stats.misses++;
 
-        for(int i=0;i<hqrPtr->numMaxEntry;i++)
-        {
-            if(hqrPtr->entries[i].ptr == NULL)
-            {
-                foundEntry = &hqrPtr->entries[i];
-                break;
-            }
-        }
+        foundEntry = hqrAllocEntry(hqrPtr, index);
 
         ASSERT(foundEntry);
 
-        //    foundEntry = hqrSubPtr;
-
         HQ_Load = 1;
 
-        foundEntry->key = index;
         foundEntry->lastTimeUsed = timer;
         //foundEntry[hqrPtr->numUsedEntry].offset = hqrPtr->maxFreeData - hqrPtr->sizeFreeData;
         foundEntry->size = size;
 
-        char* buffer = new char[size];
-        LoadPak(hqrPtr->string.c_str(), index, buffer);
-
         if constexpr (std::is_same_v<T, char>) {
+            char* buffer = new char[size];
+            LoadPak(hqrPtr->string.c_str(), index, buffer);
             foundEntry->ptr = buffer;
         }
-        else if constexpr (std::is_same_v<T, sBody>) {
-            foundEntry->ptr = createBodyFromPtr(buffer);
-            delete[] buffer;
-        }
-        else if constexpr (std::is_same_v<T, sAnimation>) {
-            foundEntry->ptr = createAnimationFromPtr(buffer, size);
-            delete[] buffer;
-        }
-        else if constexpr (std::is_same_v<T, sHybrid>) {
-            foundEntry->ptr = new sHybrid((uint8_t*)buffer, size);
-            delete[] buffer;
-        }
         else {
-            assert(0);
+            // parsed resources only read the raw data: use the mapped entry
+            // in place when it's stored uncompressed
+            char* buffer = nullptr;
+            char* rawData = (char*)PAK_getView(hqrPtr->string.c_str(), index);
+            if (!rawData) {
+                buffer = new char[size];
+                LoadPak(hqrPtr->string.c_str(), index, buffer);
+                rawData = buffer;
+            }
+
+            if constexpr (std::is_same_v<T, sBody>) {
+                foundEntry->ptr = createBodyFromPtr(rawData);
+            }
+            else if constexpr (std::is_same_v<T, sAnimation>) {
+                foundEntry->ptr = createAnimationFromPtr(rawData, size);
+            }
+            else if constexpr (std::is_same_v<T, sHybrid>) {
+                foundEntry->ptr = new sHybrid((uint8_t*)rawData, size);
+            }
+            else {
+                assert(0);
+            }
+
+            delete[] buffer;
         }
 
-        hqrPtr->numUsedEntry++;
         hqrPtr->sizeFreeData -= size;
 
         RestoreTimerAnim();
@@ -446,8 +898,6 @@ hqrEntryStruct<char>* HQR_Init(int size,int numEntry)
 
     hqrEntryStruct<char>* dest = new hqrEntryStruct<char>();
 
-    numEntry = 2000;
-
     ASSERT_PTR(dest);
 
     if(!dest)
@@ -456,14 +906,9 @@ hqrEntryStruct<char>* HQR_Init(int size,int numEntry)
     dest->string = "_MEMORY_";
     dest->sizeFreeData = size;
     dest->maxFreeData = size;
-    dest->numMaxEntry = numEntry;
-    dest->numUsedEntry = 0;
-    dest->entries.resize(numEntry);
-
-    for(int i=0;i<numEntry;i++)
-    {
-        dest->entries[i].ptr = nullptr;
-    }
+    dest->evictable = false;
+    dest->stats = {};
+    hqrInitEntries(dest, numEntry);
 
     return(dest);
 }
@@ -472,22 +917,20 @@ template <typename T>
 void HQR_Reset(hqrEntryStruct<T>* hqrPtr)
 {
     hqrPtr->sizeFreeData = hqrPtr->maxFreeData;
-    hqrPtr->numUsedEntry = 0;
 
     for(int i =0;i<hqrPtr->numMaxEntry;i++)
     {
         if (hqrPtr->entries[i].ptr)
         {
-            if constexpr (std::is_same_v<T, char>) {
-                delete[] hqrPtr->entries[i].ptr;
-            }
-            else {
-                delete hqrPtr->entries[i].ptr;
-            }
+            hqrDeleteResource(hqrPtr->entries[i].ptr);
             hqrPtr->entries[i].ptr = nullptr;
         }
     }
 
+    hqrPtr->numUsedEntry = 0;
+    hqrPtr->lruHead = -1;
+    hqrPtr->lruTail = -1;
+    hqrRebuildIndex(hqrPtr);
 }
 
 template <typename T>
@@ -506,6 +949,64 @@ void configureHqrHero(hqrEntryStruct<T>* hqrPtr, const char* name)
 
 void HQ_Free_Malloc(hqrEntryStruct<char>* hqrPtr, int index)
 {
+    if(index<0)
+        return;
+
+    hqrSubEntryStruct<char>* pEntry = hqrFindEntry(hqrPtr, index);
+
+    if(!pEntry)
+        return;
+
+    hqrPtr->sizeFreeData += pEntry->size;
+    delete[] pEntry->ptr;
+    hqrReleaseEntry(hqrPtr, pEntry);
+}
+
+template <typename T>
+const hqrStatsStruct& HQR_GetStats(hqrEntryStruct<T>* hqrPtr)
+{
+    return hqrPtr->stats;
+}
+
+template <typename T>
+void HQR_ResetStats(hqrEntryStruct<T>* hqrPtr)
+{
+    hqrPtr->stats = {};
+}
+
+template <typename T>
+const char* HQR_GetName(hqrEntryStruct<T>* hqrPtr)
+{
+    return hqrPtr->string.c_str();
+}
+
+template <typename T>
+void HQR_SetBudget(hqrEntryStruct<T>* hqrPtr, int budget)
+{
+    hqrPtr->sizeFreeData += budget - hqrPtr->maxFreeData;
+    hqrPtr->maxFreeData = budget;
+    hqrPtr->evictable = true;
+
+    // shrinking applies right away to whatever wasn't used this frame
+    hqrEvict(hqrPtr, 0);
+}
+
+template <typename T>
+int HQR_GetBudget(hqrEntryStruct<T>* hqrPtr)
+{
+    return hqrPtr->maxFreeData;
+}
+
+template <typename T>
+int HQR_GetUsedSize(hqrEntryStruct<T>* hqrPtr)
+{
+    return hqrPtr->maxFreeData - hqrPtr->sizeFreeData;
+}
+
+template <typename T>
+bool HQR_Contains(hqrEntryStruct<T>* hqrPtr, int index)
+{
+    return hqrFindEntry(hqrPtr, index) != nullptr;
 }
 
 template
@@ -523,11 +1024,27 @@ void HQR_Reset(hqrEntryStruct<char>* hqrPtr);
 template
 void configureHqrHero(hqrEntryStruct<char>* hqrPtr, const char* name);
 
+template const hqrStatsStruct& HQR_GetStats(hqrEntryStruct<char>* hqrPtr);
+template void HQR_ResetStats(hqrEntryStruct<char>* hqrPtr);
+template const char* HQR_GetName(hqrEntryStruct<char>* hqrPtr);
+template void HQR_SetBudget(hqrEntryStruct<char>* hqrPtr, int budget);
+template int HQR_GetBudget(hqrEntryStruct<char>* hqrPtr);
+template int HQR_GetUsedSize(hqrEntryStruct<char>* hqrPtr);
+template bool HQR_Contains(hqrEntryStruct<char>* hqrPtr, int index);
+
 /// body
 template hqrEntryStruct<sBody>* HQR_InitRessource(const char* name, int size, int numEntries);
 template sBody* HQR_Get(hqrEntryStruct<sBody>* hqrPtr, int index);
 template void HQR_Free(hqrEntryStruct<sBody>* hqrPtr);
+template void HQR_Reset(hqrEntryStruct<sBody>* hqrPtr);
 template void configureHqrHero(hqrEntryStruct<sBody>* hqrPtr, const char* name);
+template const hqrStatsStruct& HQR_GetStats(hqrEntryStruct<sBody>* hqrPtr);
+template void HQR_ResetStats(hqrEntryStruct<sBody>* hqrPtr);
+template const char* HQR_GetName(hqrEntryStruct<sBody>* hqrPtr);
+template void HQR_SetBudget(hqrEntryStruct<sBody>* hqrPtr, int budget);
+template int HQR_GetBudget(hqrEntryStruct<sBody>* hqrPtr);
+template int HQR_GetUsedSize(hqrEntryStruct<sBody>* hqrPtr);
+template bool HQR_Contains(hqrEntryStruct<sBody>* hqrPtr, int index);
 
 /// anim
 template hqrEntryStruct<sAnimation>* HQR_InitRessource(const char* name, int size, int numEntries);
@@ -535,8 +1052,22 @@ template sAnimation* HQR_Get(hqrEntryStruct<sAnimation>* hqrPtr, int index);
 template void HQR_Free(hqrEntryStruct<sAnimation>* hqrPtr);
 template void HQR_Reset(hqrEntryStruct<sAnimation>* hqrPtr);
 template void configureHqrHero(hqrEntryStruct<sAnimation>* hqrPtr, const char* name);
+template const hqrStatsStruct& HQR_GetStats(hqrEntryStruct<sAnimation>* hqrPtr);
+template void HQR_ResetStats(hqrEntryStruct<sAnimation>* hqrPtr);
+template const char* HQR_GetName(hqrEntryStruct<sAnimation>* hqrPtr);
+template void HQR_SetBudget(hqrEntryStruct<sAnimation>* hqrPtr, int budget);
+template int HQR_GetBudget(hqrEntryStruct<sAnimation>* hqrPtr);
+template int HQR_GetUsedSize(hqrEntryStruct<sAnimation>* hqrPtr);
+template bool HQR_Contains(hqrEntryStruct<sAnimation>* hqrPtr, int index);
 
 /// hybrids
 template hqrEntryStruct<sHybrid>* HQR_InitRessource(const char* name, int size, int numEntries);
 template sHybrid* HQR_Get(hqrEntryStruct<sHybrid>* hqrPtr, int index);
 template void HQR_Free(hqrEntryStruct<sHybrid>* hqrPtr);
+template const hqrStatsStruct& HQR_GetStats(hqrEntryStruct<sHybrid>* hqrPtr);
+template void HQR_ResetStats(hqrEntryStruct<sHybrid>* hqrPtr);
+template const char* HQR_GetName(hqrEntryStruct<sHybrid>* hqrPtr);
+template void HQR_SetBudget(hqrEntryStruct<sHybrid>* hqrPtr, int budget);
+template int HQR_GetBudget(hqrEntryStruct<sHybrid>* hqrPtr);
+template int HQR_GetUsedSize(hqrEntryStruct<sHybrid>* hqrPtr);
+template bool HQR_Contains(hqrEntryStruct<sHybrid>* hqrPtr, int index);
@@ -24,13 +24,23 @@ struct hqrSubEntryStruct;
 template <typename T>
 struct hqrEntryStruct;
 
+// Lookup counters for a cache, hits/misses of HQR_Get and LRU evictions
+struct hqrStatsStruct
+{
+    u32 hits;
+    u32 misses;
+    u32 evictions;
+    u32 evictedBytes;
+    u32 overBudgetLoads;
+};
+
 template <typename T>
 T* HQR_Get(hqrEntryStruct<T>* hqrPtr, int index);
 
 hqrEntryStruct<char>* HQR_Init(int size, int numEntry);
 int HQ_Malloc(hqrEntryStruct<char>* hqrPtr,int size);
 char* HQ_PtrMalloc(hqrEntryStruct<char>* hqrPtr, int index);
-void HQ_Free_Malloc(hqrEntryStruct<char>* hqrPtr, int index);
+void HQ_Free_Malloc(hqrEntryStruct<char>* hqrPtr, int index);
 
 template <typename T>
 void HQR_Free(hqrEntryStruct<T>* hqrPtr);
@@ -40,10 +50,37 @@ hqrEntryStruct<T>* HQR_InitRessource(const char* name, int size, int numEntries)
 
 template <typename T>
 void HQR_Reset(hqrEntryStruct<T>* hqrPtr);
-
+
+template <typename T>
+void configureHqrHero(hqrEntryStruct<T>* hqrPtr, const char* name);
+
+template <typename T>
+const hqrStatsStruct& HQR_GetStats(hqrEntryStruct<T>* hqrPtr);
+
+template <typename T>
+void HQR_ResetStats(hqrEntryStruct<T>* hqrPtr);
+
+template <typename T>
+const char* HQR_GetName(hqrEntryStruct<T>* hqrPtr);
+
+// Turns on LRU eviction: resources not used during the current frame are
+// freed, least recently used first, to keep the loaded data under budget bytes
 template <typename T>
-void configureHqrHero(hqrEntryStruct<T>* hqrPtr, const char* name);
-
-struct sBody* createBodyFromPtr(void* ptr);
-
+void HQR_SetBudget(hqrEntryStruct<T>* hqrPtr, int budget);
+
+template <typename T>
+int HQR_GetBudget(hqrEntryStruct<T>* hqrPtr);
+
+template <typename T>
+int HQR_GetUsedSize(hqrEntryStruct<T>* hqrPtr);
+
+// True if the resource is loaded, without touching its LRU position
+template <typename T>
+bool HQR_Contains(hqrEntryStruct<T>* hqrPtr, int index);
+
+// Starts a new frame, entries used by the previous one become evictable
+void HQR_NextFrame();
+
+struct sBody* createBodyFromPtr(void* ptr);
+
 
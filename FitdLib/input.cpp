@@ -52,6 +52,10 @@ void readKeyboard(void)
     I_ControlGetEvents();
 }
 
+#elif defined(FITD_HEADLESS)
+
+// readKeyboard is in osystemHeadless.cpp, which replays the -input script
+
 #else
 
 #include <SDL.h>
@@ -76,7 +80,7 @@ void handleKeyDown(SDL_Event& event)
 
 #endif // DREAMCAST
 
-#ifndef DREAMCAST
+#if !defined(DREAMCAST) && !defined(FITD_HEADLESS)
 void readKeyboard(void)
 {
     SDL_Event event;
@@ -210,4 +214,4 @@ void readKeyboard(void)
     }
 #endif
 }
-#endif // !DREAMCAST
+#endif // !DREAMCAST && !FITD_HEADLESS
@@ -124,7 +124,7 @@ void renderInventoryObject(int arg)
     ShowBeta -= 8;
 
     setCameraTarget(0,0,0,60,ShowBeta,0,24000);
-    DisplayObject(0,0,0,0,0,0,ShowObjet);
+    DisplayObject(0,0,0,0,0,0,ShowObjet,nullptr);
 
     if(arg!=-1)
     {
@@ -219,7 +219,9 @@ void processInventory(void)
     if(!numObjInInventoryTable[currentInventory])
         return;
 
+#ifdef DREAMCAST
     DC_SetMenuActive(true);
+#endif
 
     firstObjectDisplayedIdx = 0;
     lastSelectedObjectIdx = -1;
@@ -468,7 +470,9 @@ void processInventory(void)
     }
 
     //updateShaking();
+#ifdef DREAMCAST
     DC_SetMenuActive(false);
+#endif
 }
 
 
@@ -490,7 +494,7 @@ void DrawFoundWindow(int menuState, int objectName, int zoomFactor)
 
     setCameraTarget(0, 0, 0, 60, ShowBeta, 0, zoomFactor);
 
-    DisplayObject(0, 0, 0, 0, 0, 0, HQR_Get(HQ_Bodys, ShowBody));
+    DisplayObject(0, 0, 0, 0, 0, 0, HQR_Get(HQ_Bodys, ShowBody), nullptr);
 
     SimpleMessage(160, WindowY1, 20, 1);
     SimpleMessage(160, WindowY1 + 16, objectName, 1);
@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark job threads (System)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "common.h"
+#include "jobs.h"
+
+#include <algorithm>
+
+#ifndef DREAMCAST
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define JOBS_MAX_WORKERS 7
+
+// The run in progress. Workers wake on a new generation and take items from
+// s_jobsNext until none are left. s_jobsActive counts the workers taking
+// items: a run only ends, and the next one only starts, once it is 0.
+static std::mutex s_jobsMutex;
+static std::condition_variable s_jobsCond;
+static std::condition_variable s_jobsIdleCond;
+
+static std::vector<std::thread> s_jobsThreads;
+static bool s_jobsQuit = false;
+static u32 s_jobsGeneration = 0;
+static int s_jobsActive = 0;
+
+static const std::function<void(int)>* s_jobsFunction = nullptr;
+static int s_jobsCount = 0;
+static std::atomic<int> s_jobsNext{ 0 };
+
+static void jobsTake()
+{
+    for (;;)
+    {
+        int item = s_jobsNext.fetch_add(1);
+        if (item >= s_jobsCount)
+            return;
+
+        (*s_jobsFunction)(item);
+    }
+}
+
+static void jobsWorker()
+{
+    u32 generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(s_jobsMutex);
+            s_jobsCond.wait(lock, [&] { return s_jobsQuit || s_jobsGeneration != generation; });
+
+            if (s_jobsQuit)
+                break;
+
+            generation = s_jobsGeneration;
+            s_jobsActive++;
+        }
+
+        jobsTake();
+
+        {
+            std::lock_guard<std::mutex> lock(s_jobsMutex);
+            if (--s_jobsActive == 0)
+                s_jobsIdleCond.notify_one();
+        }
+    }
+}
+
+void Jobs_Init()
+{
+    if (!s_jobsThreads.empty())
+        return;
+
+    int numWorkers = std::min((int)std::thread::hardware_concurrency() - 1, JOBS_MAX_WORKERS);
+
+    s_jobsQuit = false;
+    for (int i = 0; i < numWorkers; i++)
+    {
+        s_jobsThreads.emplace_back(jobsWorker);
+    }
+}
+
+void Jobs_Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_jobsMutex);
+        s_jobsQuit = true;
+    }
+    s_jobsCond.notify_all();
+
+    for (auto& thread : s_jobsThreads)
+    {
+        thread.join();
+    }
+    s_jobsThreads.clear();
+}
+
+void Jobs_Run(int count, const std::function<void(int)>& job)
+{
+    if (count <= 1 || s_jobsThreads.empty())
+    {
+        for (int i = 0; i < count; i++)
+            job(i);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(s_jobsMutex);
+        s_jobsIdleCond.wait(lock, [] { return s_jobsActive == 0; }); // late wake ups of the last run
+
+        s_jobsFunction = &job;
+        s_jobsCount = count;
+        s_jobsNext = 0;
+        s_jobsGeneration++;
+    }
+    s_jobsCond.notify_all();
+
+    jobsTake();
+
+    // workers still in the middle of their last item
+    std::unique_lock<std::mutex> lock(s_jobsMutex);
+    s_jobsIdleCond.wait(lock, [] { return s_jobsActive == 0; });
+    s_jobsFunction = nullptr;
+}
+
+int Jobs_GetNumThreads()
+{
+    return (int)s_jobsThreads.size() + 1;
+}
+
+#else
+
+void Jobs_Init()
+{
+}
+
+void Jobs_Shutdown()
+{
+}
+
+void Jobs_Run(int count, const std::function<void(int)>& job)
+{
+    for (int i = 0; i < count; i++)
+        job(i);
+}
+
+int Jobs_GetNumThreads()
+{
+    return 1;
+}
+
+#endif
@@ -0,0 +1,36 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark job threads (System)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <functional>
+
+// A few worker threads that split a frame's independent work items (the
+// actors PrepareActors displays) with the game thread. There are no workers
+// on the Dreamcast, where Jobs_Run calls everything on the game thread.
+
+void Jobs_Init();
+void Jobs_Shutdown();
+
+// Calls job(i) for every i in [0, count), on the workers and the calling
+// thread, and returns once every call returned. Not reentrant.
+void Jobs_Run(int count, const std::function<void(int)>& job);
+
+// Workers plus the calling thread
+int Jobs_GetNumThreads();
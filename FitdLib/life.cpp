@@ -124,6 +124,7 @@ int InitSpecialObjet(int mode, int X, int Y, int Z, int stage, int room, int alp
 
     currentActorPtr->objectType = AF_SPECIAL;
     currentActorPtr->indexInWorld = -2;
+    AddActiveObjet(i);
     currentActorPtr->life = -1;
     currentActorPtr->lifeMode = 2; // TODO: probably incorrect betweem AITD1/2
     currentActorPtr->bodyNum = 0;
@@ -175,6 +176,7 @@ int InitSpecialObjet(int mode, int X, int Y, int Z, int stage, int room, int alp
         if (!flowPtr)
         {
             currentActorPtr->indexInWorld = -1;
+            RemoveActiveObjet(i);
             return(-1);
         }
 
@@ -350,6 +352,8 @@ void setStage(int newStage, int newRoomLocal, int X, int Y, int Z)
     currentProcessedActorPtr->zv.ZVZ1 += Z - animZ;
     currentProcessedActorPtr->zv.ZVZ2 += Z - animZ;
 
+    MoveObjetGrid(currentProcessedActorPtr);
+
     currentProcessedActorPtr->roomX = X;
     currentProcessedActorPtr->roomY = Y;
     currentProcessedActorPtr->roomZ = Z;
@@ -438,7 +442,8 @@ void doRealZv(tObject* actorPtr)
 {
     ZVStruct* zvPtr;
 
-    computeScreenBox(0, 0, 0, actorPtr->alpha, actorPtr->beta, actorPtr->gamma, HQR_Get(HQ_Bodys, actorPtr->bodyNum));
+    sBody* pBody = HQR_Get(HQ_Bodys, actorPtr->bodyNum);
+    computeScreenBox(0, 0, 0, actorPtr->alpha, actorPtr->beta, actorPtr->gamma, pBody, GetObjectPose((int)(actorPtr - ListObjets.data()), pBody));
 
     zvPtr = &actorPtr->zv;
 
@@ -450,6 +455,8 @@ void doRealZv(tObject* actorPtr)
     zvPtr->ZVY2 += actorPtr->roomY;
     zvPtr->ZVZ1 += actorPtr->roomZ;
     zvPtr->ZVZ2 += actorPtr->roomZ;
+
+    MoveObjetGrid(actorPtr);
 }
 
 #ifdef DEBUG
@@ -783,7 +790,7 @@ void processLife(int lifeNum, bool callFoundLife)
                             }
                             else */
                             {
-                                SetInterAnimObjet(currentProcessedActorPtr->frame, pAnim, pBody);
+                                SetInterAnimObjet(currentProcessedActorPtr->frame, pAnim, pBody, GetObjectPose(currentProcessedActorIdx, pBody));
                             }
                         }
                     }
@@ -818,7 +825,7 @@ void processLife(int lifeNum, bool callFoundLife)
 
                     sBody* pBody = HQR_Get(HQ_Bodys, currentProcessedActorPtr->bodyNum);
 
-                    SetAnimObjet(0, pAnim, pBody);
+                    SetAnimObjet(0, pAnim, pBody, GetObjectPose(currentProcessedActorIdx, pBody));
                     InitAnim(param2, 4, -1);
                 }
                 else
@@ -851,6 +858,7 @@ void processLife(int lifeNum, bool callFoundLife)
                 currentProcessedActorPtr->zv.ZVZ2 = currentProcessedActorPtr->roomZ + *(s16*)currentLifePtr + currentProcessedActorPtr->stepZ;
                 currentLifePtr += 2;
 
+                MoveObjetGrid(currentProcessedActorPtr);
                 break;
             }
             case LM_DEF_ABS_ZV:
@@ -871,6 +879,7 @@ void processLife(int lifeNum, bool callFoundLife)
                 currentProcessedActorPtr->zv.ZVZ2 = *(s16*)currentLifePtr;
                 currentLifePtr += 2;
 
+                MoveObjetGrid(currentProcessedActorPtr);
                 break;
             }
             case LM_DO_ROT_ZV: // DO_ROT_ZV
@@ -888,6 +897,7 @@ void processLife(int lifeNum, bool callFoundLife)
                 currentProcessedActorPtr->zv.ZVZ1 += currentProcessedActorPtr->roomZ;
                 currentProcessedActorPtr->zv.ZVZ2 += currentProcessedActorPtr->roomZ;
 
+                MoveObjetGrid(currentProcessedActorPtr);
                 break;
             }
             case LM_DO_MAX_ZV:
@@ -902,6 +912,7 @@ void processLife(int lifeNum, bool callFoundLife)
                 currentProcessedActorPtr->zv.ZVZ1 += currentProcessedActorPtr->roomZ;
                 currentProcessedActorPtr->zv.ZVZ2 += currentProcessedActorPtr->roomZ;
 
+                MoveObjetGrid(currentProcessedActorPtr);
                 break;
             }
             case LM_DO_CARRE_ZV: // DO_CARRE_ZV
@@ -916,6 +927,7 @@ void processLife(int lifeNum, bool callFoundLife)
                 currentProcessedActorPtr->zv.ZVZ1 += currentProcessedActorPtr->roomZ;
                 currentProcessedActorPtr->zv.ZVZ2 += currentProcessedActorPtr->roomZ;
 
+                MoveObjetGrid(currentProcessedActorPtr);
                 break;
             }
             case LM_TYPE: // TYPE
@@ -23,6 +23,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 unsigned char* polyBackBuffer = NULL;
 
@@ -48,11 +49,14 @@ void pixel(int x,int y, unsigned char c)
 
 void hline(int x1, int x2, int y, unsigned char c)
 {
-    int i;
+    if(y<0 || y>=200)
+        return;
 
-    for(i=x1; i < (x2 + 1);i++)
+    x1 = MAX(x1, 0);
+    x2 = MIN(x2, 319);
+    if(x1 <= x2)
     {
-        pixel(i,y,c);
+        memset(polyBackBuffer+y*320+x1, c, x2-x1+1);
     }
 }
 
@@ -198,6 +202,6 @@ void line(int x1, int y1, int x2, int y2, unsigned char c) {
     } else {
         bsubline_3(x1, y1, x2, y2, c);
     } 
-}
-
+}
+
 #undef SWAP
@@ -40,10 +40,12 @@ extern "C" {
 #include "hybrid.h"
 #include "anim2d.h"
 #include "r_occlude.h"
+#include "jobs.h"
+#include "polys.h"
 
 #include <time.h>
 
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
 #include "bgfxGlue.h"
 #include <bgfx/bgfx.h>
 #endif
@@ -357,6 +359,7 @@ void executeFoundLife(int objIdx)
 		currentLifeActorIdx = actorIdx;
 
 		currentProcessedActorPtr->indexInWorld = objIdx;
+		AddActiveObjet(actorIdx);
 		currentProcessedActorPtr->life = -1;
 		currentProcessedActorPtr->bodyNum = -1;
 		currentProcessedActorPtr->objectType = 0;
@@ -371,6 +374,7 @@ void executeFoundLife(int objIdx)
 	if(var_2)
 	{
 		currentProcessedActorPtr->indexInWorld = -1;
+		RemoveActiveObjet((int)(currentProcessedActorPtr - ListObjets.data()));
 	}
 
 	currentProcessedActorPtr = currentActorPtr;
@@ -533,7 +537,10 @@ void OpenProgram(void)
 	/*  InitCopyPlot(aux2);
 	InitSpecialCopyPoly(aux2); */
 
-    BufferAnim.resize(NB_BUFFER_ANIM);
+    InitBufferAnim();
+
+	Prefetch_Init();
+	Jobs_Init();
 
     switch(g_gameId)
 	{
@@ -1357,12 +1364,24 @@ void LoadWorld(void)
 		HQ_Matrices = HQR_InitRessource<char>("LISTMAT",64000,5);
 	}
 
+#if HQR_BUDGET_SCALE
+	HQR_SetBudget(listLife, 65000 * HQR_BUDGET_SCALE);
+	HQR_SetBudget(HQ_Bodys, 37000 * HQR_BUDGET_SCALE);
+	HQR_SetBudget(HQ_Anims, 30000 * HQR_BUDGET_SCALE);
+	if (HQ_Hybrides)
+		HQR_SetBudget(HQ_Hybrides, 20000 * HQR_BUDGET_SCALE);
+	if (HQ_Matrices)
+		HQR_SetBudget(HQ_Matrices, 64000 * HQR_BUDGET_SCALE);
+#endif
+
 
 	for(i=0;i<NUM_MAX_OBJECT;i++)
 	{
 		ListObjets[i].indexInWorld = -1;
 	}
 
+	GenereActiveObjets();
+
 	if(g_gameId == AITD1)
 	{
 		currentWorldTarget = CVars[getCVarsIdx(WORLD_NUM_PERSO)];
@@ -1504,20 +1523,6 @@ void loadCamera(int cameraIdx)
 	}
 }
 
-struct sMaskStruct
-{
-	u16 x1;
-	u16 y1;
-	u16 x2;
-	u16 y2;
-	u16 deltaX;
-	u16 deltaY;
-
-	std::array<u8, 320*200> mask;
-};
-
-std::vector<std::vector<sMaskStruct>> g_maskBuffers;
-
 void loadMask(int cameraIdx)
 {
     if (g_gameId == TIMEGATE)
@@ -1534,46 +1539,45 @@ void loadMask(int cameraIdx)
 
 	g_MaskPtr = (unsigned char*)loadPak(name,cameraIdx);
 
-    g_maskBuffers.clear();
-    g_maskBuffers.resize(cameraDataTable[NumCamera]->numViewedRooms);
+    osystem_clearMasks();
+
+    // the spans of each mask are decoded into its own rectangle
+    std::vector<u8> mask;
+
 	for(int i=0; i<cameraDataTable[NumCamera]->numViewedRooms; i++)
 	{
 		cameraViewedRoomStruct* pRoomView = &cameraDataTable[NumCamera]->viewedRoomTable[i];
 		unsigned char* pViewedRoomMask = g_MaskPtr + READ_LE_U32(g_MaskPtr + i*4);
 
-        g_maskBuffers[i].reserve(pRoomView->masks.size());
 		for(int j=0; j<pRoomView->masks.size(); j++)
 		{
-			g_maskBuffers[i].emplace_back();
-			sMaskStruct* pDestMask = &g_maskBuffers[i].back();
 			unsigned char* pMaskData = pViewedRoomMask + READ_LE_U32(pViewedRoomMask + j*4);
 
-            pDestMask->mask.fill(0);
-
-			pDestMask->x1 = READ_LE_U16(pMaskData);
+			u16 x1 = READ_LE_U16(pMaskData);
 			pMaskData += 2;
-			pDestMask->y1 = READ_LE_U16(pMaskData);
+			u16 y1 = READ_LE_U16(pMaskData);
 			pMaskData += 2;
-			pDestMask->x2 = READ_LE_U16(pMaskData);
+			u16 x2 = READ_LE_U16(pMaskData);
 			pMaskData += 2;
-			pDestMask->y2 = READ_LE_U16(pMaskData);
+			u16 y2 = READ_LE_U16(pMaskData);
 			pMaskData += 2;
-			pDestMask->deltaX = READ_LE_U16(pMaskData);
+			u16 deltaX = READ_LE_U16(pMaskData);
 			pMaskData += 2;
-			pDestMask->deltaY = READ_LE_U16(pMaskData);
+			u16 deltaY = READ_LE_U16(pMaskData);
 			pMaskData += 2;
 
-			assert(pDestMask->deltaX == pDestMask->x2 - pDestMask->x1 + 1);
-			assert(pDestMask->deltaY == pDestMask->y2 - pDestMask->y1 + 1);
+			assert(deltaX == x2 - x1 + 1);
+			assert(deltaY == y2 - y1 + 1);
+
+            mask.assign(deltaX * deltaY, 0);
 
-			for(int k=0; k<pDestMask->deltaY; k++)
+			for(int k=0; k<deltaY; k++)
 			{
 				u16 uNumEntryForLine = READ_LE_U16(pMaskData);
 				pMaskData += 2;
 
-				unsigned char* pSourceBuffer = (unsigned char*)aux;
-
-				int offset = pDestMask->x1 + pDestMask->y1 * 320 + k * 320;
+				int offset = k * deltaX;
+				int lineEnd = offset + deltaX;
 
 				for(int l=0; l<uNumEntryForLine; l++)
 				{
@@ -1582,24 +1586,27 @@ void loadMask(int cameraIdx)
 
 					offset += uNumSkip;
 
-					for(int m=0; m<uNumCopy; m++)
-					{						
-                        pDestMask->mask[offset] = 0xFF;
-						offset++;
-					}
+                    // texels past x2 were never drawn
+                    int numCopy = std::min<int>(uNumCopy, lineEnd - offset);
+                    if (numCopy > 0)
+                        memset(&mask[offset], 0xFF, numCopy);
+                    offset += uNumCopy;
 				}
 			}
 
-			osystem_createMask(pDestMask->mask, i, j, pDestMask->x1, pDestMask->y1, pDestMask->x2, pDestMask->y2);
+			osystem_createMask(mask.data(), i, j, x1, y1, x2, y2);
 		}
 	}
 }
 
-void fillpoly(s16 * datas, int n, unsigned char c);
-extern unsigned char* polyBackBuffer;
-
 void createAITD1Mask()
 {
+    osystem_clearMasks();
+
+    // the polygons of each mask are drawn on screen, then cropped to their box
+    static std::array<u8, 320 * 200> screenMask;
+    std::vector<u8> mask;
+
 	for(int viewedRoomIdx=0; viewedRoomIdx<cameraDataTable[NumCamera]->numViewedRooms; viewedRoomIdx++)
 	{
 		cameraViewedRoomStruct* pcameraViewedRoomData = &cameraDataTable[NumCamera]->viewedRoomTable[viewedRoomIdx];
@@ -1612,10 +1619,7 @@ void createAITD1Mask()
 
 		for(int maskIdx=0;maskIdx<numMask;maskIdx++)
 		{
-            sMaskStruct theMaskStruct;
-            sMaskStruct* pDestMask = &theMaskStruct;
-            pDestMask->mask.fill(0);
-            polyBackBuffer = pDestMask->mask.data();
+            polyBackBuffer = screenMask.data();
 
 			int numMaskZone = READ_LE_U16(data);
 			char* src = data2 + READ_LE_U16(data+2);
@@ -1663,7 +1667,24 @@ void createAITD1Mask()
 
 			}
 
-			osystem_createMask(pDestMask->mask, viewedRoomIdx, maskIdx, minX-1, minY-1, maxX+1, maxY+1);
+            int x1 = std::max(minX - 1, 0);
+            int y1 = std::max(minY - 1, 0);
+            int x2 = std::min(maxX + 1, 319);
+            int y2 = std::min(maxY + 1, 199);
+
+            mask.clear();
+            if (x1 <= x2 && y1 <= y2)
+            {
+                for (int y = y1; y <= y2; y++)
+                {
+                    mask.insert(mask.end(), &screenMask[y * 320 + x1], &screenMask[y * 320 + x2 + 1]);
+                }
+
+                // fillpoly stays within the polygons' box
+                memset(&screenMask[y1 * 320], 0, (y2 - y1 + 1) * 320);
+            }
+
+			osystem_createMask(mask.data(), viewedRoomIdx, maskIdx, x1, y1, x2, y2);
 
 			int numOverlay = READ_LE_U16(data);
 			data+=2;
@@ -1844,6 +1865,7 @@ void DeleteObjet(int index) // remove actor
 	if(actorPtr->indexInWorld == -2) // flow
 	{
 		actorPtr->indexInWorld = -1;
+		RemoveActiveObjet(index);
 
 		if(actorPtr->ANIM == 4 )
 		{
@@ -1860,6 +1882,7 @@ void DeleteObjet(int index) // remove actor
 
 			objectPtr->objIndex = -1;
 			actorPtr->indexInWorld = -1;
+			RemoveActiveObjet(index);
 
 			objectPtr->body = actorPtr->bodyNum;
 			objectPtr->anim = actorPtr->ANIM;
@@ -2017,7 +2040,7 @@ int IsInCamRectTestAITD2(int X, int Z) // TODO: not 100% exact
 
 void updateAllActorAndObjectsAITD2()
 {
-    for (int i = 0; i < NUM_MAX_OBJECT; i++)
+    for (int i = NextActiveObjet(-1); i < NUM_MAX_OBJECT; i = NextActiveObjet(i))
     {
         tObject* pObject = &ListObjets[i];
 
@@ -2172,7 +2195,7 @@ void GenereActiveList()
 		return;
 	}
 
-	for(int i=0;i<NUM_MAX_OBJECT;i++)
+	for(int i=NextActiveObjet(-1);i<NUM_MAX_OBJECT;i=NextActiveObjet(i))
 	{
         tObject* currentActor = &ListObjets[i];
         if (currentActor->indexInWorld == -1)
@@ -2318,8 +2341,9 @@ void GenereAffList()
 {
 	NbAffObjets = 0;
 
-	for(int i=0;i< ListObjets.size();i++)
+	for(int j=0;j<NbActiveObjets;j++)
 	{
+        const int i = ActiveObjets[j];
         tObject* actorPtr = &ListObjets[i];
 		if(actorPtr->indexInWorld != -1 && actorPtr->bodyNum != -1)
 		{
@@ -2424,6 +2448,9 @@ void InitView()
     for (int i = 0; i < currentCameraZoneList[NumCamera]->hybrids.size(); i++) {
         startAnim2d(i);
     }
+
+	// start loading what the next camera cut or room change will need
+	Prefetch_Neighbours();
 }
 
 s16 GiveDistance2D(int x1, int z1, int x2, int z2)
@@ -2561,6 +2588,7 @@ void deleteObject(int objIdx)
 
 		actorPtr->room = -1;
 		actorPtr->stage = -1;
+		MoveObjetGrid(actorPtr);
 
 		//    FlagGenereActiveList = 1;
 
@@ -3030,13 +3058,111 @@ int isBgOverlayRequired( int X1, int X2, int Z1, int Z2, char* data, int param )
 	return(0);
 }
 
-void drawBgOverlay(tObject* actorPtr)
+// Rectangles of the masks found in front of the actors of the frame. Those of
+// a mask don't overlap, so drawBgOverlays draws each pixel of it once.
+static std::vector<maskRectStruct> frameMaskRects;
+
+// Splits rect around other, adding the parts outside of it to pieces
+static void subtractMaskRect(const maskRectStruct& rect, const maskRectStruct& other, std::vector<maskRectStruct>& pieces)
+{
+	if(other.x1 > rect.x2 || other.x2 < rect.x1 || other.y1 > rect.y2 || other.y2 < rect.y1)
+	{
+		pieces.push_back(rect);
+		return;
+	}
+
+	maskRectStruct piece = rect;
+	if(other.y1 > rect.y1)
+	{
+		piece.y1 = rect.y1;
+		piece.y2 = other.y1 - 1;
+		pieces.push_back(piece);
+	}
+	if(other.y2 < rect.y2)
+	{
+		piece.y1 = other.y2 + 1;
+		piece.y2 = rect.y2;
+		pieces.push_back(piece);
+	}
+
+	piece.y1 = std::max(rect.y1, other.y1);
+	piece.y2 = std::min(rect.y2, other.y2);
+	if(other.x1 > rect.x1)
+	{
+		piece.x1 = rect.x1;
+		piece.x2 = other.x1 - 1;
+		pieces.push_back(piece);
+	}
+	if(other.x2 < rect.x2)
+	{
+		piece.x1 = other.x2 + 1;
+		piece.x2 = rect.x2;
+		pieces.push_back(piece);
+	}
+}
+
+// Whether a rectangle of a mask the actor isn't behind overlaps its clip
+// rectangle. Drawn at the end of the frame, it would cover the actor.
+static bool isMaskRectOverActor(int roomId, const std::vector<int>& actorMasks)
+{
+	for(const maskRectStruct& rect : frameMaskRects)
+	{
+		if(rect.x1 > clipRight || rect.x2 < clipLeft || rect.y1 > clipBottom || rect.y2 < clipTop)
+			continue;
+		if(rect.roomId == roomId && std::find(actorMasks.begin(), actorMasks.end(), rect.maskId) != actorMasks.end())
+			continue;
+		return true;
+	}
+	return false;
+}
+
+// Adds the clip rectangle to the mask, less what its rectangles already cover
+static void addMaskRect(int roomId, int maskId)
+{
+	static std::vector<maskRectStruct> pieces;
+	static std::vector<maskRectStruct> remainingPieces;
+
+	pieces.clear();
+	pieces.push_back({ roomId, maskId, clipLeft, clipTop, clipRight, clipBottom });
+
+	for(const maskRectStruct& other : frameMaskRects)
+	{
+		if(other.roomId != roomId || other.maskId != maskId)
+			continue;
+
+		remainingPieces.clear();
+		for(const maskRectStruct& piece : pieces)
+		{
+			subtractMaskRect(piece, other, remainingPieces);
+		}
+		pieces.swap(remainingPieces);
+
+		if(pieces.empty())
+			return;
+	}
+
+	frameMaskRects.insert(frameMaskRects.end(), pieces.begin(), pieces.end());
+}
+
+void drawBgOverlays()
+{
+	if(!frameMaskRects.empty())
+	{
+		osystem_drawMasks(frameMaskRects.data(), (int)frameMaskRects.size());
+		frameMaskRects.clear();
+	}
+}
+
+void drawBgOverlay(tObject* actorPtr, const objectMarkStruct& actorMark)
 {
 	char* data;
 	char* data2;
 
 	int numOverlayZone;
 
+	static std::vector<int> actorMasks;
+	actorMasks.clear();
+
 	actorPtr->screenXMin = BBox3D1;
 	actorPtr->screenYMin = BBox3D2;
 	actorPtr->screenXMax = BBox3D3;
@@ -3062,9 +3188,10 @@ void drawBgOverlay(tObject* actorPtr)
 		}
 	}
 	if(pcameraViewedRoomData == NULL)
-		return;
-
-	if(g_gameId == AITD1)
+	{
+		// out of the rooms this camera views, the actor is behind no mask
+	}
+	else if(g_gameId == AITD1)
 	{
 		data2 = room_PtrCamera[NumCamera] + pcameraViewedRoomData->offsetToMask;
 		data = data2;
@@ -3082,9 +3209,7 @@ void drawBgOverlay(tObject* actorPtr)
 				data+4,
 				*(s16*)(data) ))
 			{
-				osystem_setClip(clipLeft, clipTop, clipRight, clipBottom);
-				osystem_drawMask(relativeCameraIndex, i);
-				osystem_clearClip();
+				actorMasks.push_back(i);
 
 				/*
 				int j;
@@ -3129,15 +3254,26 @@ void drawBgOverlay(tObject* actorPtr)
 
 				if(actorX1 >= pRect->zoneX1 && actorZ1 >= pRect->zoneZ1 && actorX2 <= pRect->zoneX2 && actorZ2 <= pRect->zoneZ2)
 				{
-					osystem_setClip(clipLeft, clipTop, clipRight, clipBottom);
-					osystem_drawMask(relativeCameraIndex, i);
-					osystem_clearClip();
+					actorMasks.push_back(i);
 					break;
 				}
 			}
 		}
 	}
 
+	// pending masks the actor isn't behind go under it: they are drawn with the
+	// actors before it, it is drawn after them
+	if(isMaskRectOverActor(relativeCameraIndex, actorMasks))
+	{
+		FlushObjectsBefore(actorMark);
+		drawBgOverlays();
+	}
+
+	for(int maskId : actorMasks)
+	{
+		addMaskRect(relativeCameraIndex, maskId);
+	}
+
 	SetClip(0,0,319,199);
 }
 
@@ -3200,6 +3336,39 @@ void AllRedraw(int flagFlip)
 	SetClip(0,0,319,199);
 	NbLogBoxs = 0;
 
+	// actors are drawn together, then the background masks in front of them. An
+	// actor over a pending mask it isn't behind closes the batch before it.
+	BeginObjectBatch();
+
+	// their bodies are transformed and projected on the job threads first
+	{
+		std::array<actorDisplayStruct, NUM_MAX_OBJECT> displayedActors;
+		int numDisplayedActors = 0;
+
+		for(int i=0;i<NbAffObjets + NbAnim2D;i++)
+		{
+			int currentDrawActor = Index[i];
+			if (currentDrawActor & 0x8000)
+				continue;
+
+			tObject* actorPtr = &ListObjets[currentDrawActor];
+			if (actorPtr->objectType & (AF_SPECIAL | AF_OBJ_2D))
+				continue;
+
+			actorDisplayStruct& actor = displayedActors[numDisplayedActors++];
+			actor.actorIdx = currentDrawActor;
+			actor.x = actorPtr->worldX + actorPtr->stepX;
+			actor.y = actorPtr->worldY + actorPtr->stepY;
+			actor.z = actorPtr->worldZ + actorPtr->stepZ;
+			actor.alpha = actorPtr->alpha;
+			actor.beta = actorPtr->beta;
+			actor.gamma = actorPtr->gamma;
+			actor.pBody = HQR_Get(HQ_Bodys, actorPtr->bodyNum);
+		}
+
+		PrepareActors(displayedActors.data(), numDisplayedActors);
+	}
+
 	for(int i=0;i<NbAffObjets + NbAnim2D;i++)
 	{
 		int currentDrawActor = Index[i];
@@ -3214,6 +3383,7 @@ void AllRedraw(int flagFlip)
         }
         else {
             tObject* actorPtr = &ListObjets[currentDrawActor];
+            objectMarkStruct actorMark = GetObjectMark();
 
             // this is commented out to draw actors backed into the background
             //if(actorPtr->_flags & (AF_ANIMATED + AF_DRAWABLE + AF_SPECIAL))
@@ -3242,7 +3412,7 @@ void AllRedraw(int flagFlip)
                             //          initAnimInBody(actorPtr->FRAME, HQR_Get(listAnim, actorPtr->ANIM), bodyPtr);
                         }
 
-                        AffObjet(actorPtr->worldX + actorPtr->stepX, actorPtr->worldY + actorPtr->stepY, actorPtr->worldZ + actorPtr->stepZ, actorPtr->alpha, actorPtr->beta, actorPtr->gamma, bodyPtr);
+                        DisplayActor(currentDrawActor, actorPtr->worldX + actorPtr->stepX, actorPtr->worldY + actorPtr->stepY, actorPtr->worldZ + actorPtr->stepZ, actorPtr->alpha, actorPtr->beta, actorPtr->gamma, bodyPtr);
 
 
                         if (actorPtr->animActionType != 0)
@@ -3280,7 +3450,7 @@ void AllRedraw(int flagFlip)
 #endif
                     {
                         //if(g_gameId == AITD1)
-                        drawBgOverlay(actorPtr);
+                        drawBgOverlay(actorPtr, actorMark);
                     }
                     //addToRedrawBox();
                 }
@@ -3295,13 +3465,16 @@ void AllRedraw(int flagFlip)
         }
 	}
 
+	EndObjectBatch();
+	drawBgOverlays();
+
 #ifdef FITD_DEBUGGER
     {
         if (backgroundMode == backgroundModeEnum_3D)
         {
-            for (int i = 0; i < NUM_MAX_OBJECT; i++)
+            for (int i = 0; i < NbActiveObjets; i++)
             {
-                tObject* actorPtr = &ListObjets[i];
+                tObject* actorPtr = &ListObjets[ActiveObjets[i]];
 
                 if (actorPtr->indexInWorld != -1)
                 {
@@ -3423,7 +3596,8 @@ void AdjustZV(ZVStruct* zvPtr, int startRoom, int destRoom)
 	zvPtr->ZVZ2 += Zdif;
 }
 
-int CheckObjectCol(int actorIdx, ZVStruct* zvPtr)
+// The first 3 of the candidates whose ZV zvPtr intersects, into col
+static int findObjectCol(int actorIdx, ZVStruct* zvPtr, const int* candidates, int numCandidates, s16* col)
 {
 	int currentCollisionSlot = 0;
     
@@ -3431,12 +3605,13 @@ int CheckObjectCol(int actorIdx, ZVStruct* zvPtr)
 
 	for(int i=0;i<3;i++)
 	{
-		currentProcessedActorPtr->COL[i] = -1;
+		col[i] = -1;
 	}
 
-	for(int i=0;i<NUM_MAX_OBJECT;i++)
+	for(int j=0;j<numCandidates;j++)
 	{
-        tObject* currentActor = &ListObjets.at(i);
+        const int i = candidates[j];
+        tObject* currentActor = &ListObjets[i];
 
         if (currentActor->indexInWorld == -1)
             continue;
@@ -3455,7 +3630,7 @@ int CheckObjectCol(int actorIdx, ZVStruct* zvPtr)
 
             if (CubeIntersect(&localZv, currentActorZv))
             {
-                currentProcessedActorPtr->COL[currentCollisionSlot++] = i;
+                col[currentCollisionSlot++] = i;
 
                 if (currentCollisionSlot == 3)
                     return(3);
@@ -3465,7 +3640,7 @@ int CheckObjectCol(int actorIdx, ZVStruct* zvPtr)
         {
             if (CubeIntersect(zvPtr, currentActorZv))
             {
-                currentProcessedActorPtr->COL[currentCollisionSlot++] = i;
+                col[currentCollisionSlot++] = i;
 
                 if (currentCollisionSlot == 3)
                     return(3);
@@ -3476,6 +3651,39 @@ int CheckObjectCol(int actorIdx, ZVStruct* zvPtr)
 	return(currentCollisionSlot);
 }
 
+int CheckObjectCol(int actorIdx, ZVStruct* zvPtr)
+{
+	// only the actors sharing a cell of the grid with zvPtr, in slot order
+	std::array<int, NUM_MAX_OBJECT> gridCandidates;
+	int numCandidates = GetObjetGridCandidates(ListObjets[actorIdx].room, zvPtr, gridCandidates.data());
+
+	if(numCandidates < 0)
+	{
+		return findObjectCol(actorIdx, zvPtr, ActiveObjets.data(), NbActiveObjets, currentProcessedActorPtr->COL);
+	}
+
+	int numCol = findObjectCol(actorIdx, zvPtr, gridCandidates.data(), numCandidates, currentProcessedActorPtr->COL);
+
+#ifdef FITD_DEBUGGER
+	if(objectGridCheckEnabled)
+	{
+		s16 walkCol[3];
+		int numWalkCol = findObjectCol(actorIdx, zvPtr, ActiveObjets.data(), NbActiveObjets, walkCol);
+
+		objectGridCheckStats.queries++;
+		if(numWalkCol != numCol || memcmp(walkCol, currentProcessedActorPtr->COL, sizeof(walkCol)))
+		{
+			objectGridCheckStats.mismatches++;
+			printf("CheckObjectCol(%d): grid found %d %d %d, every actor %d %d %d\n", actorIdx,
+				currentProcessedActorPtr->COL[0], currentProcessedActorPtr->COL[1], currentProcessedActorPtr->COL[2],
+				walkCol[0], walkCol[1], walkCol[2]);
+		}
+	}
+#endif
+
+	return(numCol);
+}
+
 void take(int objIdx)
 {
 	tWorldObject* objPtr = &ListWorldObjets[objIdx];
@@ -3691,17 +3899,23 @@ void GereCollision(ZVStruct* oldZv, ZVStruct* animatedZv, ZVStruct* fixZv)
 
 int AsmCheckListCol(ZVStruct* zvPtr, roomDataStruct* pRoomData)
 {
-	u16 i;
 	int hardColVar = 0;
-	hardColStruct* pCurrentEntry = pRoomData->hardColTable.data();
 
 #ifdef FITD_DEBUGGER
 	if(debuggerVar_noHardClip)
 		return 0;
 #endif
 
-	for(i=0;i<pRoomData->numHardCol;i++)
+	// only the entries near zvPtr, still in table order
+	const u16* entries = NULL;
+	int numEntries = getRoomGridBox(pRoomData->hardColGrid, zvPtr, &entries);
+	if(numEntries < 0)
+		numEntries = pRoomData->numHardCol;
+
+	for(int i=0;i<numEntries;i++)
 	{
+		hardColStruct* pCurrentEntry = &pRoomData->hardColTable[entries ? entries[i] : i];
+
 		if(((pCurrentEntry->zv.ZVX1) < (zvPtr->ZVX2)) && ((zvPtr->ZVX1) < (pCurrentEntry->zv.ZVX2)))
 		{
 			if(((pCurrentEntry->zv.ZVY1) < (zvPtr->ZVY2)) && ((zvPtr->ZVY1) < (pCurrentEntry->zv.ZVY2)))
@@ -3713,8 +3927,6 @@ int AsmCheckListCol(ZVStruct* zvPtr, roomDataStruct* pRoomData)
 				}
 			}
 		}
-
-		pCurrentEntry++;
 	}
 
 	return hardColVar;
@@ -3917,13 +4129,15 @@ bool isPointInZV(int x, int y, int z, ZVStruct* pZV)
 
 sceZoneStruct* processActor2Sub(int x, int y, int z, roomDataStruct* pRoomData)
 {
-	u32 i;
-	sceZoneStruct* pCurrentZone;  
-
-	pCurrentZone = pRoomData->sceZoneTable.data();
+	const u16* entries = NULL;
+	int numEntries = getRoomGridPoint(pRoomData->sceZoneGrid, x, z, &entries);
+	if(numEntries < 0)
+		numEntries = pRoomData->numSceZone;
 
-	for(i=0;i<pRoomData->numSceZone;i++)
+	for(int i=0;i<numEntries;i++)
 	{
+		sceZoneStruct* pCurrentZone = &pRoomData->sceZoneTable[entries ? entries[i] : i];
+
 		if(pCurrentZone->zv.ZVX1 <= x && pCurrentZone->zv.ZVX2 >= x)
 		{
 			if(pCurrentZone->zv.ZVY1 <= y && pCurrentZone->zv.ZVY2 >= y)
@@ -3934,8 +4148,6 @@ sceZoneStruct* processActor2Sub(int x, int y, int z, roomDataStruct* pRoomData)
 				}
 			}
 		}
-
-		pCurrentZone++;
 	}
 
 	return(NULL);
@@ -3952,14 +4164,22 @@ void GereDec()
 	{
 		onceMore = false;
 		roomDataStruct* pRoomData = &roomDataTable[currentProcessedActorPtr->room];
-		for(u32 i=0;i<pRoomData->numSceZone;i++)
+
+		// the point only moves with the room, which starts another pass
+		const int pointX = currentProcessedActorPtr->roomX + currentProcessedActorPtr->stepX;
+		const int pointY = currentProcessedActorPtr->roomY + currentProcessedActorPtr->stepY;
+		const int pointZ = currentProcessedActorPtr->roomZ + currentProcessedActorPtr->stepZ;
+
+		const u16* entries = NULL;
+		int numEntries = getRoomGridPoint(pRoomData->sceZoneGrid, pointX, pointZ, &entries);
+		if(numEntries < 0)
+			numEntries = pRoomData->numSceZone;
+
+		for(int i=0;i<numEntries;i++)
 		{
-			sceZoneStruct* pCurrentZone = &pRoomData->sceZoneTable[i];
+			sceZoneStruct* pCurrentZone = &pRoomData->sceZoneTable[entries ? entries[i] : i];
 
-			if(isPointInZV(	currentProcessedActorPtr->roomX + currentProcessedActorPtr->stepX,
-				currentProcessedActorPtr->roomY + currentProcessedActorPtr->stepY,
-				currentProcessedActorPtr->roomZ + currentProcessedActorPtr->stepZ,
-				&pCurrentZone->zv))
+			if(isPointInZV(pointX, pointY, pointZ, &pCurrentZone->zv))
 			{
 				switch(pCurrentZone->type)
 				{
@@ -3986,6 +4206,8 @@ void GereDec()
 						currentProcessedActorPtr->zv.ZVZ1 += z;
 						currentProcessedActorPtr->zv.ZVZ2 += z;
 
+						MoveObjetGrid(currentProcessedActorPtr);
+
 						onceMore = true;
 						if(currentProcessedActorIdx == currentCameraTargetActor)
 						{
@@ -4173,6 +4395,7 @@ void PutAtObjet(int objIdx, int objIdxToPutAt)
 			currentProcessedActorPtr->alpha = actorToPutAtPtr->alpha;
 			currentProcessedActorPtr->beta = actorToPutAtPtr->beta;
 			currentProcessedActorPtr->gamma = actorToPutAtPtr->gamma;
+			MoveObjetGrid(currentProcessedActorPtr);
 
 			ListWorldObjets[currentProcessedActorPtr->indexInWorld].foundFlag |= 0x4000;
 			ListWorldObjets[currentProcessedActorPtr->indexInWorld].flags |= 0x80;
@@ -4213,6 +4436,7 @@ void PutAtObjet(int objIdx, int objIdxToPutAt)
 			currentProcessedActorPtr->alpha = objPtrToPutAt->alpha;
 			currentProcessedActorPtr->beta = objPtrToPutAt->beta;
 			currentProcessedActorPtr->gamma = objPtrToPutAt->gamma;
+			MoveObjetGrid(currentProcessedActorPtr);
 
 			ListWorldObjets[currentProcessedActorPtr->indexInWorld].foundFlag |= 0x4000;
 			ListWorldObjets[currentProcessedActorPtr->indexInWorld].flags |= 0x80;
@@ -4315,6 +4539,8 @@ void throwStoppedAt(int x, int z)
 	currentProcessedActorPtr->zv.ZVZ1 += z2;
 	currentProcessedActorPtr->zv.ZVZ2 += z2;
 
+	MoveObjetGrid(currentProcessedActorPtr);
+
 	ListWorldObjets[currentProcessedActorPtr->indexInWorld].foundFlag |= 0x4000;
 	ListWorldObjets[currentProcessedActorPtr->indexInWorld].foundFlag &= 0xEFFF;
 
@@ -4364,7 +4590,7 @@ void detectGame(void)
 		#else
 		printf("Detected Alone in the Dark\n");
 		#endif
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
         SDL_SetWindowTitle(gWindowBGFX, "Alone in the Dark");
 #endif
 		return;
@@ -4380,7 +4606,7 @@ void detectGame(void)
 		#else
 		printf("Detected Jack in the Dark\n");
 		#endif
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
         SDL_SetWindowTitle(gWindowBGFX, "Jack in the Dark");
 #endif
 		return;
@@ -4396,7 +4622,7 @@ void detectGame(void)
 		#else
 		printf("Detected Alone in the Dark 2\n");
 		#endif
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
         SDL_SetWindowTitle(gWindowBGFX, "Alone in the Dark 2");
 #endif
 		return;
@@ -4412,7 +4638,7 @@ void detectGame(void)
 		#else
 		printf("Detected Alone in the Dark 3\n");
 		#endif
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
         SDL_SetWindowTitle(gWindowBGFX, "Alone in the Dark 3");
 #endif
 		return;
@@ -4428,7 +4654,7 @@ void detectGame(void)
 		#else
 		printf("Detected Time Gate\n");
 		#endif
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
         SDL_SetWindowTitle(gWindowBGFX, "Time Gate");
 #endif
 		return;
@@ -4457,7 +4683,7 @@ int FitdMain(int argc, char* argv[])
 	dbgio_printf("[FitdMain] detectGame done (g_gameId=%d, CVars=%d)\n", (int)g_gameId, (int)CVars.size());
 #endif
 
-#if !defined(AITD_UE4) && !defined(DREAMCAST)
+#if !defined(AITD_UE4) && !defined(DREAMCAST) && !defined(FITD_HEADLESS)
 	initBgfxGlue(argc, argv);
 #endif
 
@@ -4642,6 +4868,9 @@ void cleanupAndExit(void)
 {
 	Sound_Quit();
 
+	Prefetch_Shutdown();
+	Jobs_Shutdown();
+
 	HQR_Free(listMus);
 	HQR_Free(listSamp);
 	HQR_Free(HQ_Memory);
@@ -4650,6 +4879,8 @@ void cleanupAndExit(void)
 	HQR_Free(HQ_Bodys);
 	HQR_Free(HQ_Anims);
 
+	PAK_CloseAll();
+
 	/* free(tabTextes);
 	free(aux);
 	free(aux2);
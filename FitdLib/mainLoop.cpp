@@ -62,6 +62,8 @@ void PlayWorld(int allowSystemMenu, int deltaTime)
 
     while(bLoop)
     {
+        HQR_NextFrame();
+
 		process_events();
         
         localKey = key;
@@ -129,7 +131,7 @@ void PlayWorld(int allowSystemMenu, int deltaTime)
                 }
             }
 
-            for(currentProcessedActorIdx = 0; currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx++)
+            for(currentProcessedActorIdx = NextActiveObjet(-1); currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx = NextActiveObjet(currentProcessedActorIdx))
             {
                 currentProcessedActorPtr = &ListObjets[currentProcessedActorIdx];
                 if(currentProcessedActorPtr->indexInWorld >= 0)
@@ -142,7 +144,9 @@ void PlayWorld(int allowSystemMenu, int deltaTime)
                 }
             }
 
-            for(currentProcessedActorIdx = 0; currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx++)
+            GenereObjetGrid();
+
+            for(currentProcessedActorIdx = NextActiveObjet(-1); currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx = NextActiveObjet(currentProcessedActorIdx))
             {
                 currentProcessedActorPtr = &ListObjets[currentProcessedActorIdx];
                 if(currentProcessedActorPtr->indexInWorld >= 0)
@@ -166,8 +170,12 @@ void PlayWorld(int allowSystemMenu, int deltaTime)
             }
 
             
-            for(currentProcessedActorIdx = 0; currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx++)
+            for(currentProcessedActorIdx = NextActiveObjet(-1); currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx = NextActiveObjet(currentProcessedActorIdx))
             {
+                // every empty slot before this one stopped the loop too
+                if(FlagChangeEtage && currentProcessedActorIdx > 0)
+                    break;
+
                 currentProcessedActorPtr = &ListObjets[currentProcessedActorIdx];
                 if(currentProcessedActorPtr->indexInWorld >= 0)
                 {
@@ -225,8 +233,12 @@ void PlayWorld(int allowSystemMenu, int deltaTime)
 
             NumCamera = NewNumCamera;
 
-            for (currentProcessedActorIdx = 0; currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx++)
+            for (currentProcessedActorIdx = NextActiveObjet(-1); currentProcessedActorIdx < NUM_MAX_OBJECT; currentProcessedActorIdx = NextActiveObjet(currentProcessedActorIdx))
             {
+                // every empty slot before this one stopped the loop too
+                if (FlagChangeEtage && currentProcessedActorIdx > 0)
+                    break;
+
                 currentProcessedActorPtr = &ListObjets[currentProcessedActorIdx];
                 if (currentProcessedActorPtr->indexInWorld >= 0)
                 {
@@ -551,7 +551,7 @@ static int musicSyncBytes = 1500;
 int musicTimer = 0;
 int nextUpdateTimer = 1500;
 
-int musicUpdate(void *udata, uint8 *stream, int len)
+int musicUpdate(void *udata, u8 *stream, int len)
 {
     if(OPLinitialized)
     {
@@ -571,7 +571,7 @@ int musicUpdate(void *udata, uint8 *stream, int len)
 
             if(timeBeforNextUpdate) // generate
             {
-                YM3812UpdateOne(0,(int16*)(stream+fillStatus),(timeBeforNextUpdate)/2);
+                YM3812UpdateOne(0,(INT16*)(stream+fillStatus),(timeBeforNextUpdate)/2);
                 fillStatus+=timeBeforNextUpdate;
                 musicTimer+=timeBeforNextUpdate;
             }
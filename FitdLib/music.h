@@ -22,7 +22,7 @@ extern unsigned int musicChrono;
 int initMusicDriver(void);
 
 extern "C" {
-int musicUpdate(void *udata, uint8 *stream, int len);
+int musicUpdate(void *udata, u8 *stream, int len);
 void playMusic(int musicNumber);
 extern bool g_gameUseCDA;
 extern int musicVolume;
@@ -36,6 +36,8 @@ int InitObjet(int body, int typeZv, int hardZvIdx, s16 objectType, int x, int y,
     if(i==NUM_MAX_OBJECT)
         return -1;
 
+    AddActiveObjet(i);
+
     currentProcessedActorPtr = actorPtr;
     currentProcessedActorIdx = i;
 
@@ -117,11 +119,14 @@ int InitObjet(int body, int typeZv, int hardZvIdx, s16 objectType, int x, int y,
     {
         bodyPtr = HQR_Get(HQ_Bodys,actorPtr->bodyNum);
 
+        // nothing left of the slot's previous object
+        InitPose(&ListPoses[i], bodyPtr);
+
         if(anim != -1)
         {
             sAnimation* animPtr = HQR_Get(HQ_Anims,anim);
 
-            SetAnimObjet(frame,animPtr, bodyPtr);
+            SetAnimObjet(frame,animPtr, bodyPtr, &ListPoses[i]);
 
             actorPtr->numOfFrames = GetNbFramesAnim(animPtr);
             actorPtr->flagEndAnim = 0;
@@ -266,5 +271,7 @@ int InitObjet(int body, int typeZv, int hardZvIdx, s16 objectType, int x, int y,
     zvPtr->ZVZ1 += z;
     zvPtr->ZVZ2 += z;
 
+    MoveObjetGrid(actorPtr);
+
     return(i);
 }
@@ -0,0 +1,284 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark actor grid (Game Logic)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+#include "common.h"
+
+#include "objectGrid.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define OBJECT_GRID_CELL_SHIFT 11 // 2048 units a side, a few actors wide
+#define OBJECT_GRID_NUM_BUCKETS 256 // cells hashed into, both power of 2
+#define OBJECT_GRID_MAX_CELLS 4 // per axis; past this an actor is tested by everyone
+
+#define OBJECT_MASK_WORDS ((NUM_MAX_OBJECT + 31) / 32)
+
+typedef std::array<u32, OBJECT_MASK_WORDS> objectMaskStruct;
+
+enum objectGridState
+{
+    OBJECT_GRID_NONE = 0, // not active
+    OBJECT_GRID_ANYWHERE, // in anywhereMask
+    OBJECT_GRID_CELLS,
+};
+
+struct objectGridEntryStruct
+{
+    objectGridState state = OBJECT_GRID_NONE;
+    s32 cellX1;
+    s32 cellX2;
+    s32 cellZ1;
+    s32 cellZ2;
+};
+
+struct roomOriginStruct
+{
+    s32 x;
+    s32 z;
+};
+
+// What AdjustZV adds to move a ZV out of each room, on X and Z
+static std::vector<roomOriginStruct> roomOrigins;
+
+static std::array<objectMaskStruct, OBJECT_GRID_NUM_BUCKETS> bucketMasks;
+static objectMaskStruct anywhereMask;
+static std::array<objectGridEntryStruct, NUM_MAX_OBJECT> gridEntries;
+
+#ifdef FITD_DEBUGGER
+#ifdef NDEBUG
+bool objectGridCheckEnabled = false;
+#else
+bool objectGridCheckEnabled = true;
+#endif
+objectGridCheckStatsStruct objectGridCheckStats;
+#endif
+
+static inline void setMaskBit(objectMaskStruct& mask, int index)
+{
+    mask[index >> 5] |= 1u << (index & 31);
+}
+
+static inline void clearMaskBit(objectMaskStruct& mask, int index)
+{
+    mask[index >> 5] &= ~(1u << (index & 31));
+}
+
+static inline int lowestMaskBit(u32 bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#elif defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanForward(&bit, bits);
+    return (int)bit;
+#else
+    int bit = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static inline int getBucket(s32 cellX, s32 cellZ)
+{
+    const u32 hash = ((u32)cellX * 0x9E3779B1u) ^ ((u32)cellZ * 0x85EBCA6Bu);
+    return (int)(hash >> 24) & (OBJECT_GRID_NUM_BUCKETS - 1);
+}
+
+// The cells under the ZV of room, in floor space. A ZV with X1 > X2 still
+// meets the boxes spanning [X2, X1] in CubeIntersect, so both ends count.
+static bool getCells(int room, const ZVStruct* zvPtr, objectGridEntryStruct& entry)
+{
+    if (room < 0 || room >= (int)roomOrigins.size())
+        return false;
+
+    const roomOriginStruct& origin = roomOrigins[room];
+
+    const s32 x1 = std::min(zvPtr->ZVX1, zvPtr->ZVX2) + origin.x;
+    const s32 x2 = std::max(zvPtr->ZVX1, zvPtr->ZVX2) + origin.x;
+    const s32 z1 = std::min(zvPtr->ZVZ1, zvPtr->ZVZ2) + origin.z;
+    const s32 z2 = std::max(zvPtr->ZVZ1, zvPtr->ZVZ2) + origin.z;
+
+    entry.cellX1 = x1 >> OBJECT_GRID_CELL_SHIFT;
+    entry.cellX2 = x2 >> OBJECT_GRID_CELL_SHIFT;
+    entry.cellZ1 = z1 >> OBJECT_GRID_CELL_SHIFT;
+    entry.cellZ2 = z2 >> OBJECT_GRID_CELL_SHIFT;
+
+    return (entry.cellX2 - entry.cellX1 < OBJECT_GRID_MAX_CELLS) && (entry.cellZ2 - entry.cellZ1 < OBJECT_GRID_MAX_CELLS);
+}
+
+static void unplace(int index)
+{
+    objectGridEntryStruct& entry = gridEntries[index];
+
+    if (entry.state == OBJECT_GRID_CELLS)
+    {
+        for (s32 cellX = entry.cellX1; cellX <= entry.cellX2; cellX++)
+        {
+            for (s32 cellZ = entry.cellZ1; cellZ <= entry.cellZ2; cellZ++)
+            {
+                clearMaskBit(bucketMasks[getBucket(cellX, cellZ)], index);
+            }
+        }
+    }
+
+    clearMaskBit(anywhereMask, index);
+    entry.state = OBJECT_GRID_ANYWHERE;
+}
+
+static void place(int index)
+{
+    objectGridEntryStruct& entry = gridEntries[index];
+    tObject* actorPtr = &ListObjets[index];
+
+    unplace(index);
+
+    if (!getCells(actorPtr->room, &actorPtr->zv, entry))
+    {
+        setMaskBit(anywhereMask, index);
+        return;
+    }
+
+    for (s32 cellX = entry.cellX1; cellX <= entry.cellX2; cellX++)
+    {
+        for (s32 cellZ = entry.cellZ1; cellZ <= entry.cellZ2; cellZ++)
+        {
+            setMaskBit(bucketMasks[getBucket(cellX, cellZ)], index);
+        }
+    }
+
+    entry.state = OBJECT_GRID_CELLS;
+}
+
+void ClearObjetGrid()
+{
+    for (int i = 0; i < OBJECT_GRID_NUM_BUCKETS; i++)
+    {
+        bucketMasks[i].fill(0);
+    }
+
+    anywhereMask.fill(0);
+
+    for (int i = 0; i < NUM_MAX_OBJECT; i++)
+    {
+        gridEntries[i].state = OBJECT_GRID_NONE;
+    }
+}
+
+void AddObjetGrid(int index)
+{
+    if (gridEntries[index].state != OBJECT_GRID_NONE)
+        return;
+
+    // tested by everyone until its ZV is known
+    gridEntries[index].state = OBJECT_GRID_ANYWHERE;
+    setMaskBit(anywhereMask, index);
+}
+
+void RemoveObjetGrid(int index)
+{
+    if (gridEntries[index].state == OBJECT_GRID_NONE)
+        return;
+
+    unplace(index);
+    gridEntries[index].state = OBJECT_GRID_NONE;
+}
+
+void MoveObjetGrid(tObject* actorPtr)
+{
+    const int index = (int)(actorPtr - ListObjets.data());
+
+    if (gridEntries[index].state == OBJECT_GRID_NONE)
+        return;
+
+    place(index);
+}
+
+void InitObjetGrid()
+{
+    roomOrigins.resize(roomDataTable.size());
+
+    // AdjustZV(zv, a, b) moves X by 10 * (a.worldX - b.worldX) and Z by
+    // 10 * (b.worldZ - a.worldZ)
+    for (size_t i = 0; i < roomDataTable.size(); i++)
+    {
+        roomOrigins[i].x = 10 * roomDataTable[i].worldX;
+        roomOrigins[i].z = -10 * roomDataTable[i].worldZ;
+    }
+
+    // placed with the last floor's origins
+    for (int i = 0; i < NUM_MAX_OBJECT; i++)
+    {
+        if (gridEntries[i].state != OBJECT_GRID_NONE)
+        {
+            unplace(i);
+            setMaskBit(anywhereMask, i);
+        }
+    }
+}
+
+void GenereObjetGrid()
+{
+    for (int i = 0; i < NbActiveObjets; i++)
+    {
+        place(ActiveObjets[i]);
+    }
+}
+
+int GetObjetGridCandidates(int room, const ZVStruct* zvPtr, int* candidates)
+{
+    objectGridEntryStruct query;
+
+    if (!getCells(room, zvPtr, query))
+        return -1;
+
+    objectMaskStruct mask = anywhereMask;
+
+    for (s32 cellX = query.cellX1; cellX <= query.cellX2; cellX++)
+    {
+        for (s32 cellZ = query.cellZ1; cellZ <= query.cellZ2; cellZ++)
+        {
+            const objectMaskStruct& bucketMask = bucketMasks[getBucket(cellX, cellZ)];
+
+            for (int i = 0; i < OBJECT_MASK_WORDS; i++)
+            {
+                mask[i] |= bucketMask[i];
+            }
+        }
+    }
+
+    int numCandidates = 0;
+
+    for (int i = 0; i < OBJECT_MASK_WORDS; i++)
+    {
+        u32 bits = mask[i];
+
+        while (bits)
+        {
+            candidates[numCandidates++] = i * 32 + lowestMaskBit(bits);
+            bits &= bits - 1;
+        }
+    }
+
+    return numCandidates;
+}
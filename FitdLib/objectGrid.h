@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark actor grid (Game Logic)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// Broadphase of CheckObjectCol. The ZV of every active actor is moved out of
+// its room into floor space, with the room origins of the floor, and hashed
+// into square cells on X/Z. A ZV then only has to be tested against the
+// actors sharing one of its cells, which CheckObjectCol still does with
+// AdjustZV and CubeIntersect, so the collisions found don't change.
+//
+// Actors the grid can't place (a room outside the floor, a ZV over too many
+// cells, or not placed yet) are candidates of every query.
+
+void InitObjetGrid(); // LoadEtage: the room origins of the new floor
+void GenereObjetGrid(); // once per frame: places every active actor again
+
+// After anything changed the ZV or the room of an active actor
+void MoveObjetGrid(tObject* actorPtr);
+
+// From AddActiveObjet and RemoveActiveObjet
+void AddObjetGrid(int index);
+void RemoveObjetGrid(int index);
+void ClearObjetGrid();
+
+// Fills candidates with the active slots, in ascending order, that a ZV of room
+// may intersect, and returns their number. Returns -1 when the grid can't
+// narrow it down and every active actor has to be tested.
+int GetObjetGridCandidates(int room, const ZVStruct* zvPtr, int* candidates);
+
+#ifdef FITD_DEBUGGER
+// CheckObjectCol also walks every active actor and reports the queries whose
+// collisions differ, which only happens when a change of the ZV or the room of
+// an actor missed MoveObjetGrid. On by default in debug builds.
+struct objectGridCheckStatsStruct
+{
+    u32 queries;
+    u32 mismatches;
+};
+
+extern bool objectGridCheckEnabled;
+extern objectGridCheckStatsStruct objectGridCheckStats; // since the start
+#endif
@@ -78,8 +78,24 @@
 	void osystem_playSample(char* samplePtr,int size);
 	//    void getMouseStatus(mouseStatusStruct * mouseData);
 
-	void osystem_createMask(const std::array<u8, 320 * 200>& mask, int roomId, int maskId, int maskX1, int maskY1, int maskX2, int maskY2);
-	void osystem_drawMask(int roomId, int maskId);
+	// mask holds the texels of the on screen rectangle [maskX1, maskX2] x
+	// [maskY1, maskY2], row by row, non zero where the background is drawn
+	// over actors. The masks of a camera are created after osystem_clearMasks.
+	void osystem_clearMasks();
+	void osystem_createMask(const u8* mask, int roomId, int maskId, int maskX1, int maskY1, int maskX2, int maskY2);
+
+	// Draws the masks of a frame over its actors, each one within its
+	// rectangles (inclusive, on screen), in one pass.
+	struct maskRectStruct
+	{
+		int roomId;
+		int maskId;
+		int x1;
+		int y1;
+		int x2;
+		int y2;
+	};
+	void osystem_drawMasks(const maskRectStruct* rects, int numRects);
 
 	void osystem_startFrame();
 	void osystem_stopFrame();
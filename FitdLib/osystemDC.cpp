@@ -22,6 +22,7 @@
 #include "osystem.h"
 #include "vars.h"
 #include "font.h"
+#include "polys.h"
 #include <array>
 #include <vector>
 #include <algorithm>
@@ -66,10 +67,8 @@ static bool g_renderDebugHud = true;
 static int g_renderDebugCableType = -1;
 
 // Software 2D raster helpers used by the engine (8-bit indexed into frontBuffer).
-extern void fillpoly(s16* datas, int n, unsigned char c);
 extern void line(int x1, int y1, int x2, int y2, unsigned char c);
 extern void hline(int x1, int x2, int y, unsigned char c);
-extern unsigned char* polyBackBuffer;
 
 // Shared Dreamcast palette state.
 std::array<u8, 256 * 3> g_palette = {};
@@ -285,8 +284,8 @@ void dc_rgl_ensure_frame_started()
     }
 }
 
-// Track the active clip region (set by SetClip/osystem_setClip) so background
-// masks can be clipped to actor bounding boxes.
+// Track the active clip region (set by osystem_setClip). Background masks
+// bring their own clip rectangles to osystem_drawMasks.
 static bool g_dcClipActive = false;
 static int g_dcClipX1 = 0;
 static int g_dcClipY1 = 0;
@@ -660,27 +659,40 @@ void osystem_setColor(unsigned char /*i*/, unsigned char /*R*/, unsigned char /*
 void osystem_setPalette320x200(unsigned char* /*palette*/) {}
 void osystem_drawLine(int, int, int, int, unsigned char, unsigned char*) {}
 
-void osystem_createMask(const std::array<u8, 320 * 200>& mask, int roomId, int maskId,
+void osystem_clearMasks()
+{
+#ifndef USE_PVR_PAL8
+    dc_video_gl_clear_masks();
+#endif
+}
+
+void osystem_createMask(const u8* mask, int roomId, int maskId,
                         int maskX1, int maskY1, int maskX2, int maskY2)
 {
 #ifndef USE_PVR_PAL8
-    dc_video_gl_create_mask(mask.data(), roomId, maskId, maskX1, maskY1, maskX2, maskY2);
+    dc_video_gl_create_mask(mask, roomId, maskId, maskX1, maskY1, maskX2, maskY2);
 #else
     (void)mask; (void)roomId; (void)maskId; (void)maskX1; (void)maskY1; (void)maskX2; (void)maskY2;
 #endif
 }
 
-void osystem_drawMask(int roomId, int maskId)
+void osystem_drawMasks(const maskRectStruct* rects, int numRects)
 {
     if (g_gameId == TIMEGATE)
         return;
 
 #ifndef USE_PVR_PAL8
-    dc_video_gl_queue_mask_draw(roomId, maskId,
-                                g_dcClipActive,
-                                g_dcClipX1, g_dcClipY1, g_dcClipX2, g_dcClipY2);
+    // Half-open clips with the 1px border osystem_setClip adds.
+    for (int i = 0; i < numRects; i++)
+    {
+        dc_video_gl_queue_mask_draw(rects[i].roomId, rects[i].maskId, true,
+                                    std::max(0, std::min(320, rects[i].x1 - 1)),
+                                    std::max(0, std::min(200, rects[i].y1 - 1)),
+                                    std::max(0, std::min(320, rects[i].x2 + 1)),
+                                    std::max(0, std::min(200, rects[i].y2 + 1)));
+    }
 #else
-    (void)roomId; (void)maskId;
+    (void)rects; (void)numRects;
 #endif
 }
 
@@ -908,7 +920,7 @@ void osystem_fillPoly(float* buffer, int numPoint, unsigned char color, u8 polyT
 
     unsigned char* prev = polyBackBuffer;
     polyBackBuffer = frontBuffer;
-    fillpoly(coords, numPoint, color);
+    fillpolyMaterial(coords, numPoint, color, polyType);
     polyBackBuffer = prev;
 }
 
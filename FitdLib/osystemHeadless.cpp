@@ -0,0 +1,631 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark OS System (Headless) (Platform Abstraction)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+#include "common.h"
+
+#ifdef FITD_HEADLESS
+
+// Renders into a 320x200 paletted frame on the CPU, without a window, a GPU or
+// audio. Built with -DFITD_HEADLESS=ON, in place of osystemSDL.cpp,
+// rendererBGFX.cpp and osystemAL.cpp.
+//
+// Like the bgfx renderer, the draws of a frame are recorded and only run at
+// osystem_endOfFrame, so they all see the final background, UI layer and
+// palette of the frame. Primitives are painted in the order FlushObjects
+// sorts them, without a depth buffer.
+//
+//   Fitd [-frames <n>] [-dump <directory>] [-dumpevery <n>] [-input <file>]
+//
+// -frames quits after n frames and prints the time taken. -dump writes every
+// -dumpevery'th frame to <directory>/frame<number>.ppm. Each line of the
+// -input file is "<frame> <key> <JoyD> <Click>", the input of that frame.
+// Every frame advances the game by one tick, so runs are reproducible.
+
+#include "osystem.h"
+#include "polys.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// Software line of lines.cpp, drawing into polyBackBuffer like fillpoly
+extern void line(int x1, int y1, int x2, int y2, unsigned char c);
+
+void detectGame(void);
+
+extern "C" {
+    char homePath[512] = "";
+}
+
+extern "C" {
+    void Sound_Quit(void);
+}
+
+void Sound_Quit(void)
+{
+}
+
+int osystem_mouseRight;
+int osystem_mouseLeft;
+
+unsigned char frontBuffer[320 * 200];
+unsigned char physicalScreen[320 * 200];
+std::array<unsigned char, 320 * 200> uiLayer;
+
+static int s_maxFrames = 0; // 0 runs until the game quits
+static const char* s_dumpDirectory = nullptr;
+static int s_dumpEvery = 1;
+
+static u32 s_frameCount = 0;
+static double s_drawSeconds = 0;
+static std::chrono::steady_clock::time_point s_startTime;
+
+static std::array<u8, 320 * 200> s_frame;
+static std::array<u8, 256 * 3> s_palette;
+
+enum headlessDrawType
+{
+    HEADLESS_BACKGROUND,
+    HEADLESS_POLY,
+    HEADLESS_LINE,
+    HEADLESS_DISC,
+    HEADLESS_MASK,
+};
+
+struct headlessDrawStruct
+{
+    u8 type;
+    u8 color;
+    u8 material;
+
+    int firstPoint; // in s_drawPoints, x y pairs
+    int numPoints;
+
+    float X;
+    float Y;
+    float size;
+
+    int roomId;
+    int maskId;
+    int clipX1;
+    int clipY1;
+    int clipX2;
+    int clipY2;
+};
+
+static std::vector<headlessDrawStruct> s_draws;
+static std::vector<s16> s_drawPoints;
+
+struct maskStruct
+{
+    std::vector<u8> mask; // cropped to the rectangle
+    int maskX1;
+    int maskY1;
+    int maskX2; // excluded
+    int maskY2; // excluded
+};
+
+static std::vector<std::vector<maskStruct>> s_masks; // [room][mask]
+
+// half-open scissor of the masks, like the bgfx one
+static int s_clipX1 = 0;
+static int s_clipY1 = 0;
+static int s_clipX2 = 320;
+static int s_clipY2 = 200;
+
+struct headlessInputStruct
+{
+    u32 frame;
+    char key;
+    char joyD;
+    char click;
+};
+
+static std::vector<headlessInputStruct> s_input;
+static size_t s_nextInput = 0;
+
+static bool loadInput(const char* filename)
+{
+    FILE* fHandle = fopen(filename, "r");
+    if (!fHandle)
+        return false;
+
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), fHandle))
+    {
+        unsigned int frame;
+        int key;
+        int joyD;
+        int click;
+
+        if (buffer[0] == '#')
+            continue;
+
+        if (sscanf(buffer, "%u %i %i %i", &frame, &key, &joyD, &click) == 4)
+        {
+            s_input.push_back({ frame, (char)key, (char)joyD, (char)click });
+        }
+    }
+    fclose(fHandle);
+
+    std::stable_sort(s_input.begin(), s_input.end(), [](const headlessInputStruct& a, const headlessInputStruct& b) { return a.frame < b.frame; });
+    return true;
+}
+
+void readKeyboard(void)
+{
+    JoyD = 0;
+    Click = 0;
+    key = 0;
+
+    while (s_nextInput < s_input.size() && s_input[s_nextInput].frame <= s_frameCount)
+    {
+        const headlessInputStruct& input = s_input[s_nextInput++];
+        if (input.frame == s_frameCount)
+        {
+            key = input.key;
+            JoyD |= input.joyD;
+            Click |= input.click;
+        }
+    }
+}
+
+int FitdInit(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-frames") && i + 1 < argc)
+        {
+            s_maxFrames = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-dump") && i + 1 < argc)
+        {
+            s_dumpDirectory = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-dumpevery") && i + 1 < argc)
+        {
+            s_dumpEvery = std::max(atoi(argv[++i]), 1);
+        }
+        else if (!strcmp(argv[i], "-input") && i + 1 < argc)
+        {
+            if (!loadInput(argv[++i]))
+            {
+                printf("Can't open %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else
+        {
+            printf("usage: Fitd [-frames <n>] [-dump <directory>] [-dumpevery <n>] [-input <file>]\n");
+            exit(1);
+        }
+    }
+
+    osystem_init();
+
+    char version[256];
+
+    getVersion(version);
+
+    printf("%s", version);
+
+    detectGame();
+
+    return 0;
+}
+
+void osystem_init()
+{
+    osystem_mouseLeft = 0;
+    osystem_mouseRight = 0;
+
+    s_frame.fill(0);
+    s_palette.fill(0);
+    uiLayer.fill(0);
+
+    s_startTime = std::chrono::steady_clock::now();
+}
+
+void osystem_initGL(int /*screenWidth*/, int /*screenHeight*/)
+{
+}
+
+void osystem_delay(int /*time*/)
+{
+}
+
+void osystem_updateImage()
+{
+}
+
+void osystem_initBuffer()
+{
+}
+
+void osystem_refreshFrontTextureBuffer()
+{
+}
+
+void osystem_setPalette(unsigned char* palette)
+{
+    memcpy(s_palette.data(), palette, 256 * 3);
+}
+
+void osystem_setPalette(palette_t* palette)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            s_palette[i * 3 + j] = palette->at(i)[j];
+        }
+    }
+}
+
+void osystem_CopyBlockPhys(unsigned char* videoBuffer, int left, int top, int right, int bottom)
+{
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, 320);
+    bottom = std::min(bottom, 200);
+
+    for (int i = top; i < bottom; i++)
+    {
+        memcpy(physicalScreen + left + i * 320, videoBuffer + left + i * 320, right - left);
+    }
+}
+
+static headlessDrawStruct& addDraw(u8 type)
+{
+    headlessDrawStruct& draw = s_draws.emplace_back();
+    draw.type = type;
+    return draw;
+}
+
+void osystem_startFrame()
+{
+    osystem_drawBackground();
+}
+
+void osystem_stopFrame()
+{
+}
+
+void osystem_drawBackground()
+{
+    addDraw(HEADLESS_BACKGROUND);
+}
+
+void osystem_flip(unsigned char* /*videoBuffer*/)
+{
+    osystem_flushPendingPrimitives();
+}
+
+void osystem_flushPendingPrimitives()
+{
+    // Primitives are recorded in the order they come
+}
+
+void osystem_fillPoly(float* buffer, int numPoint, unsigned char color, u8 polyType)
+{
+    // The bgfx renderer never draws its transparent batch
+    if (polyType == 2 || numPoint <= 0)
+        return;
+
+    headlessDrawStruct& draw = addDraw(HEADLESS_POLY);
+    draw.color = color;
+    draw.material = polyType;
+    draw.firstPoint = (int)s_drawPoints.size();
+    draw.numPoints = numPoint;
+
+    for (int i = 0; i < numPoint; i++)
+    {
+        s_drawPoints.push_back((s16)std::lround(buffer[i * 3 + 0]));
+        s_drawPoints.push_back((s16)std::lround(buffer[i * 3 + 1]));
+    }
+}
+
+void osystem_draw3dLine(float x1, float y1, float /*z1*/, float x2, float y2, float /*z2*/, unsigned char color)
+{
+    headlessDrawStruct& draw = addDraw(HEADLESS_LINE);
+    draw.color = color;
+    draw.firstPoint = (int)s_drawPoints.size();
+    draw.numPoints = 2;
+
+    s_drawPoints.push_back((s16)std::lround(x1));
+    s_drawPoints.push_back((s16)std::lround(y1));
+    s_drawPoints.push_back((s16)std::lround(x2));
+    s_drawPoints.push_back((s16)std::lround(y2));
+}
+
+void osystem_draw3dQuad(float x1, float y1, float z1, float x2, float y2, float z2, float x3, float y3, float z3, float x4, float y4, float z4, unsigned char color, int /*transparency*/)
+{
+    osystem_draw3dLine(x1, y1, z1, x2, y2, z2, color);
+    osystem_draw3dLine(x2, y2, z2, x3, y3, z3, color);
+    osystem_draw3dLine(x3, y3, z3, x4, y4, z4, color);
+    osystem_draw3dLine(x4, y4, z4, x1, y1, z1, color);
+}
+
+void osystem_drawSphere(float X, float Y, float Z, u8 color, u8 material, float size)
+{
+    osystem_drawPoint(X, Y, Z, color, material, size);
+}
+
+void osystem_drawPoint(float X, float Y, float /*Z*/, u8 color, u8 material, float size)
+{
+    headlessDrawStruct& draw = addDraw(HEADLESS_DISC);
+    draw.color = color;
+    draw.material = material;
+    draw.X = X;
+    draw.Y = Y;
+    draw.size = size;
+}
+
+void osystem_clearMasks()
+{
+    s_masks.clear();
+}
+
+void osystem_createMask(const u8* mask, int roomId, int maskId, int maskX1, int maskY1, int maskX2, int maskY2)
+{
+    if (roomId < 0 || maskId < 0)
+        return;
+
+    if (s_masks.size() < (size_t)roomId + 1)
+    {
+        s_masks.resize(roomId + 1);
+    }
+    if (s_masks[roomId].size() < (size_t)maskId + 1)
+    {
+        s_masks[roomId].resize(maskId + 1);
+    }
+
+    maskStruct& entry = s_masks[roomId][maskId];
+    entry.maskX1 = maskX1;
+    entry.maskY1 = maskY1;
+    entry.maskX2 = maskX2 + 1;
+    entry.maskY2 = maskY2 + 1;
+
+    int width = entry.maskX2 - entry.maskX1;
+    int height = entry.maskY2 - entry.maskY1;
+    if (width > 0 && height > 0)
+        entry.mask.assign(mask, mask + width * height);
+    else
+        entry.mask.clear();
+}
+
+void osystem_drawMasks(const maskRectStruct* rects, int numRects)
+{
+    if (g_gameId == TIMEGATE)
+        return;
+
+    for (int i = 0; i < numRects; i++)
+    {
+        // clipped like osystem_setClip clips
+        headlessDrawStruct& draw = addDraw(HEADLESS_MASK);
+        draw.roomId = rects[i].roomId;
+        draw.maskId = rects[i].maskId;
+        draw.clipX1 = std::clamp(rects[i].x1 - 1, 0, 320);
+        draw.clipY1 = std::clamp(rects[i].y1 - 1, 0, 200);
+        draw.clipX2 = std::clamp(rects[i].x2 + 1, 0, 320);
+        draw.clipY2 = std::clamp(rects[i].y2 + 1, 0, 200);
+    }
+}
+
+void osystem_setClip(float left, float top, float right, float bottom)
+{
+    // inclusive clip, grown by a pixel like the bgfx scissor
+    s_clipX1 = std::clamp((int)std::lround(left) - 1, 0, 320);
+    s_clipY1 = std::clamp((int)std::lround(top) - 1, 0, 200);
+    s_clipX2 = std::clamp((int)std::lround(right) + 1, 0, 320);
+    s_clipY2 = std::clamp((int)std::lround(bottom) + 1, 0, 200);
+}
+
+void osystem_clearClip()
+{
+    s_clipX1 = 0;
+    s_clipY1 = 0;
+    s_clipX2 = 320;
+    s_clipY2 = 200;
+}
+
+void osystem_drawUILayer()
+{
+    for (int i = 0; i < 320 * 200; i++)
+    {
+        if (uiLayer[i])
+        {
+            s_frame[i] = uiLayer[i];
+        }
+    }
+}
+
+// The sphere shader: a disc squeezed to 5/6 of its height horizontally,
+// shaded across its width for the marble material
+static void drawDisc(const headlessDrawStruct& draw)
+{
+    if (draw.size <= 0.f)
+        return;
+
+    float extent = draw.size * 6.f / 5.f;
+    int x1 = std::max((int)std::floor(draw.X - extent), 0);
+    int x2 = std::min((int)std::ceil(draw.X + extent), 319);
+    int y1 = std::max((int)std::floor(draw.Y - extent), 0);
+    int y2 = std::min((int)std::ceil(draw.Y + extent), 199);
+
+    for (int y = y1; y <= y2; y++)
+    {
+        float normalizedY = (y + 0.5f - draw.Y) / draw.size;
+
+        for (int x = x1; x <= x2; x++)
+        {
+            float normalizedX = (x + 0.5f - draw.X) / draw.size * (5.f / 6.f);
+
+            if (normalizedX * normalizedX + normalizedY * normalizedY > 1.f)
+                continue;
+
+            u8 color = draw.color;
+            if (draw.material == 3) // marbre
+            {
+                float halfWidth = std::sqrt(std::max(1.f - normalizedY * normalizedY, 0.f));
+                float distance = halfWidth > 0.f ? (normalizedX / halfWidth) / 2.f + 0.5f : 0.5f;
+                color = (draw.color & 0xF0) | std::clamp((int)(distance * 15.f), 0, 15);
+            }
+
+            s_frame[y * 320 + x] = color;
+        }
+    }
+}
+
+static void drawMaskPixels(const headlessDrawStruct& draw)
+{
+    if (draw.roomId < 0 || draw.maskId < 0)
+        return;
+    if ((size_t)draw.roomId >= s_masks.size() || (size_t)draw.maskId >= s_masks[draw.roomId].size())
+        return;
+
+    const maskStruct& entry = s_masks[draw.roomId][draw.maskId];
+    if (entry.mask.empty())
+        return;
+
+    int x1 = std::max({ entry.maskX1, draw.clipX1, 0 });
+    int y1 = std::max({ entry.maskY1, draw.clipY1, 0 });
+    int x2 = std::min({ entry.maskX2, draw.clipX2, 320 });
+    int y2 = std::min({ entry.maskY2, draw.clipY2, 200 });
+    int width = entry.maskX2 - entry.maskX1;
+
+    for (int y = y1; y < y2; y++)
+    {
+        const u8* mask = &entry.mask[(y - entry.maskY1) * width];
+        for (int x = x1; x < x2; x++)
+        {
+            if (mask[x - entry.maskX1])
+            {
+                s_frame[y * 320 + x] = physicalScreen[y * 320 + x];
+            }
+        }
+    }
+}
+
+static void drawFrame()
+{
+    s_frame.fill(0);
+
+    unsigned char* previousBuffer = polyBackBuffer;
+    polyBackBuffer = s_frame.data();
+
+    for (const headlessDrawStruct& draw : s_draws)
+    {
+        switch (draw.type)
+        {
+        case HEADLESS_BACKGROUND:
+            memcpy(s_frame.data(), physicalScreen, 320 * 200);
+            break;
+        case HEADLESS_POLY:
+            fillpolyMaterial(&s_drawPoints[draw.firstPoint], draw.numPoints, draw.color, draw.material);
+            break;
+        case HEADLESS_LINE:
+        {
+            const s16* points = &s_drawPoints[draw.firstPoint];
+            line(points[0], points[1], points[2], points[3], draw.color);
+            break;
+        }
+        case HEADLESS_DISC:
+            drawDisc(draw);
+            break;
+        case HEADLESS_MASK:
+            drawMaskPixels(draw);
+            break;
+        }
+    }
+
+    polyBackBuffer = previousBuffer;
+
+    s_draws.clear();
+    s_drawPoints.clear();
+}
+
+static void dumpFrame()
+{
+    char filename[1024];
+    snprintf(filename, sizeof(filename), "%s/frame%06u.ppm", s_dumpDirectory, s_frameCount);
+
+    FILE* fHandle = fopen(filename, "wb");
+    if (!fHandle)
+    {
+        printf("Can't write %s\n", filename);
+        return;
+    }
+
+    std::array<u8, 320 * 200 * 3> pixels;
+    for (int i = 0; i < 320 * 200; i++)
+    {
+        memcpy(&pixels[i * 3], &s_palette[s_frame[i] * 3], 3);
+    }
+
+    fprintf(fHandle, "P6\n320 200\n255\n");
+    fwrite(pixels.data(), 1, pixels.size(), fHandle);
+    fclose(fHandle);
+}
+
+u32 osystem_startOfFrame()
+{
+    readKeyboard();
+
+    osystem_startFrame();
+
+    return 1;
+}
+
+void osystem_endOfFrame()
+{
+    osystem_flushPendingPrimitives();
+
+    auto start = std::chrono::steady_clock::now();
+    drawFrame();
+    osystem_drawUILayer();
+    s_drawSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (s_dumpDirectory && (s_frameCount % s_dumpEvery) == 0)
+    {
+        dumpFrame();
+    }
+
+    s_frameCount++;
+
+    if (s_maxFrames && s_frameCount >= (u32)s_maxFrames)
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - s_startTime).count();
+        printf("%u frames in %.2f s (%.1f frames/s), drawing %.3f ms/frame\n", s_frameCount, seconds,
+            seconds > 0 ? s_frameCount / seconds : 0, s_drawSeconds * 1000.0 / s_frameCount);
+        cleanupAndExit();
+    }
+}
+
+void osystem_playSample(char* /*samplePtr*/, int /*size*/)
+{
+}
+
+int osystem_playTrack(int /*trackId*/)
+{
+    return 0;
+}
+
+#endif // FITD_HEADLESS
@@ -21,6 +21,7 @@
 #include "common.h"
 
 #include "fitd_endian_read.h"
+#include "pakContainer.h"
 
 #ifdef DREAMCAST
 extern "C" {
@@ -30,24 +31,52 @@ extern "C" {
 
 #ifdef WIN32
 #include <direct.h>
+#include <io.h>
+#endif
+
+#include <mutex>
+
+// Read-only mapping of the whole archive, so stored entries can be handed
+// out in place and compressed ones decoded straight from the page cache.
+#if !defined(DREAMCAST) && (defined(__unix__) || defined(__APPLE__))
+#define PAK_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define PAK_USE_MMAP
 #endif
 
 extern "C" {
     extern char homePath[512];
 }
 
-typedef struct pakInfoStruct // warning: alignment unsafe
+//#define USE_UNPACKED_DATA
+
+std::map<std::string, std::unique_ptr<PakArchive>> PakArchive::s_archives;
+
+// The prefetch worker loads entries concurrently with the game thread.
+// Parsed directories and mappings are read-only once an archive is opened;
+// only the archive table, the shared file handles and the explode state
+// (static tables and window) need a lock.
+static std::mutex s_pakArchiveMutex;
+static std::mutex s_pakFileMutex;
+static std::mutex s_pakExplodeMutex;
+
+// FITD.PKX built by tools/pakpack, looked up once on the first archive open.
+// Archives found in it share its file handle and mapping.
+struct pakContainerFileStruct
 {
-    s32 discSize;
-    s32 uncompressedSize;
-    char compressionFlag;
-    char info5;
-    s16 offset;
+    bool opened = false;
+    FILE* fileHandle = nullptr;
+    const u8* mappedData = nullptr;
+    size_t mappedSize = 0;
+    std::vector<pakContainerArchiveStruct> archives;
+    std::vector<pakContainerEntryStruct> entries;
+    std::vector<char> strings;
 };
 
-typedef struct pakInfoStruct pakInfoStruct;
-
-//#define USE_UNPACKED_DATA
+static pakContainerFileStruct s_pakContainer;
 
 void readPakInfo(pakInfoStruct* pPakInfo, FILE* fileHandle)
 {
@@ -62,35 +91,533 @@ void readPakInfo(pakInfoStruct* pPakInfo, FILE* fileHandle)
     pPakInfo->offset = READ_LE_U16(&pPakInfo->offset);
 }
 
-unsigned int PAK_getNumFiles(const char* name)
+PakArchive::~PakArchive()
+{
+    if (m_sharedFile)
+        return;
+
+    unmap();
+
+    if (m_fileHandle)
+        fclose(m_fileHandle);
+}
+
+// Maps the whole file read-only, leaves mappedData null where unsupported
+static void pakMapFile(FILE* fileHandle, const u8** mappedData, size_t* mappedSize)
+{
+#if defined(PAK_USE_MMAP) && defined(_WIN32)
+    HANDLE osHandle = (HANDLE)_get_osfhandle(_fileno(fileHandle));
+    LARGE_INTEGER fileSize;
+
+    if (osHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(osHandle, &fileSize) || fileSize.QuadPart == 0)
+        return;
+
+    HANDLE mappingHandle = CreateFileMappingA(osHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mappingHandle)
+        return;
+
+    void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mappingHandle); // the view keeps the mapping alive
+
+    if (data)
+    {
+        *mappedData = (const u8*)data;
+        *mappedSize = (size_t)fileSize.QuadPart;
+    }
+#elif defined(PAK_USE_MMAP)
+    int fd = fileno(fileHandle);
+    struct stat fileStat;
+
+    if (fd < 0 || fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+        return;
+
+    void* data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+        *mappedData = (const u8*)data;
+        *mappedSize = (size_t)fileStat.st_size;
+    }
+#endif
+}
+
+static void pakUnmapFile(const u8* mappedData, size_t mappedSize)
+{
+    if (!mappedData)
+        return;
+
+#if defined(PAK_USE_MMAP) && defined(_WIN32)
+    UnmapViewOfFile(mappedData);
+#elif defined(PAK_USE_MMAP)
+    munmap((void*)mappedData, mappedSize);
+#endif
+}
+
+void PakArchive::map()
+{
+    pakMapFile(m_fileHandle, &m_mappedData, &m_mappedSize);
+}
+
+void PakArchive::unmap()
+{
+    pakUnmapFile(m_mappedData, m_mappedSize);
+
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+}
+
+static void pakCloseContainer()
+{
+    pakUnmapFile(s_pakContainer.mappedData, s_pakContainer.mappedSize);
+
+    if (s_pakContainer.fileHandle)
+        fclose(s_pakContainer.fileHandle);
+
+    s_pakContainer = pakContainerFileStruct();
+}
+
+static void pakOpenContainer()
 {
     char bufferName[512];
-    FILE* fileHandle;
-    u32 fileOffset;
 
+    s_pakContainer.opened = true;
+
+    strcpy(bufferName, homePath);
+    strcat(bufferName, PAK_CONTAINER_NAME);
+
+    FILE* fileHandle = fopen(bufferName, "rb");
+    if (!fileHandle)
+        return;
+
+    pakContainerHeaderStruct header;
+    if (fread(&header, sizeof(header), 1, fileHandle) != 1
+        || READ_LE_U32(&header.magic) != PAK_CONTAINER_MAGIC
+        || READ_LE_U32(&header.version) != PAK_CONTAINER_VERSION)
+    {
+        fclose(fileHandle);
+        return;
+    }
+
+    std::vector<pakContainerArchiveStruct> archives(READ_LE_U32(&header.numArchives));
+    std::vector<pakContainerEntryStruct> entries(READ_LE_U32(&header.numEntries));
+    std::vector<char> strings(READ_LE_U32(&header.stringTableSize));
+
+    bool valid = (archives.empty() || fread(archives.data(), sizeof(pakContainerArchiveStruct), archives.size(), fileHandle) == archives.size())
+        && (entries.empty() || fread(entries.data(), sizeof(pakContainerEntryStruct), entries.size(), fileHandle) == entries.size());
+
+    if (valid && !strings.empty())
+    {
+        fseek(fileHandle, READ_LE_U32(&header.stringTableOffset), SEEK_SET);
+        valid = fread(strings.data(), strings.size(), 1, fileHandle) == 1;
+    }
+    strings.push_back(0);
+
+    for (auto& archive : archives)
+    {
+        archive.nameOffset = READ_LE_U32(&archive.nameOffset);
+        archive.firstEntry = READ_LE_U32(&archive.firstEntry);
+        archive.numEntries = READ_LE_U32(&archive.numEntries);
+        archive.sourceSize = READ_LE_U32(&archive.sourceSize);
+
+        if (archive.nameOffset >= strings.size() || (size_t)archive.firstEntry + archive.numEntries > entries.size())
+            valid = false;
+    }
+
+    for (auto& entry : entries)
+    {
+        entry.offset = READ_LE_U32(&entry.offset);
+        entry.size = READ_LE_U32(&entry.size);
+        entry.nameOffset = READ_LE_U32(&entry.nameOffset);
+
+        if (entry.nameOffset != PAK_CONTAINER_NO_NAME && entry.nameOffset >= strings.size())
+            valid = false;
+    }
+
+    if (!valid)
+    {
+        fclose(fileHandle);
+        return;
+    }
+
+    s_pakContainer.fileHandle = fileHandle;
+    s_pakContainer.archives = std::move(archives);
+    s_pakContainer.entries = std::move(entries);
+    s_pakContainer.strings = std::move(strings);
+    pakMapFile(fileHandle, &s_pakContainer.mappedData, &s_pakContainer.mappedSize);
+
+#ifdef DREAMCAST
+    dbgio_printf("[dc] %s: %d archives, %d entries\n", PAK_CONTAINER_NAME, (int)s_pakContainer.archives.size(), (int)s_pakContainer.entries.size());
+#endif
+}
+
+static bool pakNameEquals(const char* containerName, const char* name)
+{
+    while (*containerName && toupper((unsigned char)*containerName) == toupper((unsigned char)*name))
+    {
+        containerName++;
+        name++;
+    }
+
+    return toupper((unsigned char)*containerName) == toupper((unsigned char)*name);
+}
+
+bool PakArchive::parseContainer(const char* pakFileName)
+{
+    if (!s_pakContainer.fileHandle)
+        return false;
+
+    const pakContainerArchiveStruct* pContainerArchive = nullptr;
+    for (auto& archive : s_pakContainer.archives)
+    {
+        if (pakNameEquals(&s_pakContainer.strings[archive.nameOffset], m_name.c_str()))
+        {
+            pContainerArchive = &archive;
+            break;
+        }
+    }
+
+    if (!pContainerArchive)
+        return false;
+
+    // a .PAK that changed since the container was built wins
+    FILE* pakHandle = fopen(pakFileName, "rb");
+    if (pakHandle)
+    {
+        fseek(pakHandle, 0, SEEK_END);
+        long pakSize = ftell(pakHandle);
+        fclose(pakHandle);
+
+        if ((u32)pakSize != pContainerArchive->sourceSize)
+            return false;
+    }
+
+    m_entries.resize(pContainerArchive->numEntries);
+    for (u32 i = 0; i < pContainerArchive->numEntries; i++)
+    {
+        const pakContainerEntryStruct& containerEntry = s_pakContainer.entries[pContainerArchive->firstEntry + i];
+        pakEntryStruct& entry = m_entries[i];
+
+        // stored entries: getSize, getView and loadTo need nothing else
+        entry.info.discSize = containerEntry.size;
+        entry.info.uncompressedSize = containerEntry.size;
+        entry.info.compressionFlag = 0;
+        entry.info.info5 = 0;
+        entry.info.offset = 0;
+        entry.dataOffset = containerEntry.offset;
+
+        if (containerEntry.nameOffset != PAK_CONTAINER_NO_NAME)
+            entry.name = &s_pakContainer.strings[containerEntry.nameOffset];
+    }
+
+    m_fileHandle = s_pakContainer.fileHandle;
+    m_mappedData = s_pakContainer.mappedData;
+    m_mappedSize = s_pakContainer.mappedSize;
+    m_sharedFile = true;
+
+    return true;
+}
+
+PakArchive* PakArchive::get(const char* name)
+{
+    char bufferName[512];
+
+    //makeExtention(bufferName, name, ".PAK");
     strcpy(bufferName, homePath);
     strcat(bufferName, name); // temporary until makeExtention is coded
     strcat(bufferName,".PAK");
 
-    fileHandle = fopen(bufferName,"rb");
+    std::lock_guard<std::mutex> lock(s_pakArchiveMutex);
+
+    auto it = s_archives.find(bufferName);
+    if (it != s_archives.end())
+        return it->second.get();
+
+    if (!s_pakContainer.opened)
+        pakOpenContainer();
 
+    {
+        std::unique_ptr<PakArchive> archive(new PakArchive());
+        archive->m_name = name;
+
+        if (archive->parseContainer(bufferName))
+        {
+            PakArchive* pArchive = archive.get();
+            s_archives[bufferName] = std::move(archive);
+            return pArchive;
+        }
+    }
+
+    // failures are not cached, the file may show up later (disc swap)
+    FILE* fileHandle = fopen(bufferName,"rb");
     if (!fileHandle)
-        return 0;
+        return nullptr;
+
+    std::unique_ptr<PakArchive> archive(new PakArchive());
+    archive->m_name = name;
+    archive->m_fileHandle = fileHandle;
+
+    if (!archive->parse())
+        return nullptr;
 
-    ASSERT(fileHandle);
+    archive->map();
+
+    PakArchive* pArchive = archive.get();
+    s_archives[bufferName] = std::move(archive);
+    return pArchive;
+}
 
-    fseek(fileHandle,4,SEEK_CUR);
-    fread(&fileOffset,4,1,fileHandle);
-#ifdef MACOSX
+void PakArchive::closeAll()
+{
+    std::lock_guard<std::mutex> lock(s_pakArchiveMutex);
+    s_archives.clear();
+    pakCloseContainer();
+}
+
+bool PakArchive::parse()
+{
+    u32 fileOffset;
+
+    fseek(m_fileHandle,4,SEEK_SET);
+    if (fread(&fileOffset,4,1,m_fileHandle) != 1)
+        return false;
     fileOffset = READ_LE_U32(&fileOffset);
+
+    if (fileOffset < 8)
+        return false;
+
+    unsigned int numFiles = (fileOffset/4)-2;
+
+    // whole offset table in one read
+    std::vector<u32> offsetTable(numFiles);
+    fseek(m_fileHandle,4,SEEK_SET);
+    if (numFiles && fread(offsetTable.data(),4,numFiles,m_fileHandle) != numFiles)
+        return false;
+
+    m_entries.resize(numFiles);
+    for (unsigned int i = 0; i < numFiles; i++)
+    {
+        pakEntryStruct& entry = m_entries[i];
+        u32 additionalDescriptorSize;
+
+        fseek(m_fileHandle,READ_LE_U32(&offsetTable[i]),SEEK_SET);
+
+        fread(&additionalDescriptorSize,4,1,m_fileHandle);
+        additionalDescriptorSize = READ_LE_U32(&additionalDescriptorSize);
+
+        if(additionalDescriptorSize)
+        {
+            fseek(m_fileHandle, additionalDescriptorSize-4, SEEK_CUR);
+        }
+
+        readPakInfo(&entry.info,m_fileHandle);
+
+        if(entry.info.offset)
+        {
+            char nameBuffer[256] = "";
+
+            ASSERT(entry.info.offset<256);
+
+            fread(nameBuffer,entry.info.offset,1,m_fileHandle);
+            nameBuffer[255] = 0;
+            if (entry.info.offset > 2)
+                entry.name = nameBuffer + 2;
+        }
+
+        entry.dataOffset = (u32)ftell(m_fileHandle);
+    }
+
+    return true;
+}
+
+const pakEntryStruct* PakArchive::getEntry(int index) const
+{
+    if (index < 0 || index >= (int)m_entries.size())
+        return nullptr;
+
+    return &m_entries[index];
+}
+
+int PakArchive::getSize(int index) const
+{
+    const pakEntryStruct* pEntry = getEntry(index);
+
+    if (!pEntry)
+        return 0;
+
+    switch (pEntry->info.compressionFlag)
+    {
+    case 0: // uncompressed
+        return pEntry->info.discSize;
+    case 1: // compressed
+    case 4:
+        return pEntry->info.uncompressedSize;
+    default:
+        return 0;
+    }
+}
+
+const char* PakArchive::getView(int index) const
+{
+    const pakEntryStruct* pEntry = getEntry(index);
+
+    if (!pEntry || !m_mappedData || pEntry->info.compressionFlag != 0)
+        return nullptr;
+
+    if ((size_t)pEntry->dataOffset + (size_t)pEntry->info.discSize > m_mappedSize)
+        return nullptr;
+
+    return (const char*)m_mappedData + pEntry->dataOffset;
+}
+
+bool PakArchive::loadTo(int index, char* dest)
+{
+    const pakEntryStruct* pEntry = getEntry(index);
+
+    if (!pEntry || !dest)
+        return false;
+
+    const pakInfoStruct& pakInfo = pEntry->info;
+
+#ifdef FITD_DEBUGGER
+    if (!pEntry->name.empty())
+        printf("Loading %s/%s\n", m_name.c_str(), pEntry->name.c_str());
+#endif
+
+#ifdef DREAMCAST
+    // ~CA: Trying to fix the god damn screen darkening problems.
+    // NOTE: Many 320x200 images are either 64000 bytes (pixels only) or
+    // 64768/64770 bytes (palette + pixels). Log only larger assets to
+    // keep the console usable.
+    if (pEntry->name.empty())
+    {
+        int uncompressedSize = getSize(index);
+
+        if (uncompressedSize >= 60000)
+        {
+            const bool looksLikeScreen = (uncompressedSize == 64000 || uncompressedSize == 64768 || uncompressedSize == 64770);
+            dbgio_printf("[dc] loadPak(%s,%d) size=%d comp=%d%s\n",
+                         m_name.c_str(), index, uncompressedSize, (int)pakInfo.compressionFlag,
+                         looksLikeScreen ? " [320x200-ish]" : "");
+        }
+    }
+#endif
+
+    const u8* mappedSource = nullptr;
+    if (m_mappedData && (size_t)pEntry->dataOffset + (size_t)pakInfo.discSize <= m_mappedSize)
+    {
+        mappedSource = m_mappedData + pEntry->dataOffset;
+    }
+
+    switch(pakInfo.compressionFlag)
+    {
+    case 0:
+        {
+            if (mappedSource)
+            {
+                memcpy(dest, mappedSource, pakInfo.discSize);
+                return true;
+            }
+
+            std::lock_guard<std::mutex> lock(s_pakFileMutex);
+            fseek(m_fileHandle, pEntry->dataOffset, SEEK_SET);
+            return fread(dest,pakInfo.discSize,1,m_fileHandle) == 1;
+        }
+    case 1:
+    case 4:
+        {
+            char* compressedDataPtr = nullptr;
+
+            if (!mappedSource)
+            {
+                compressedDataPtr = (char *) malloc(pakInfo.discSize);
+                if(!compressedDataPtr)
+                    return false;
+
+                std::lock_guard<std::mutex> lock(s_pakFileMutex);
+                fseek(m_fileHandle, pEntry->dataOffset, SEEK_SET);
+                fread(compressedDataPtr, pakInfo.discSize, 1, m_fileHandle);
+                mappedSource = (const u8*)compressedDataPtr;
+            }
+
+            int result;
+            if(pakInfo.compressionFlag == 1)
+            {
+                std::lock_guard<std::mutex> lock(s_pakExplodeMutex);
+                result = PAK_explode((unsigned char*)mappedSource, (unsigned char*)dest, pakInfo.discSize, pakInfo.uncompressedSize, pakInfo.info5);
+            }
+            else
+                result = PAK_deflate((unsigned char*)mappedSource, (unsigned char*)dest, pakInfo.discSize, pakInfo.uncompressedSize);
+
+            free(compressedDataPtr);
+
+            return result == 0;
+        }
+    default:
+        assert(false);
+        break;
+    }
+
+    return false;
+}
+
+char* PakArchive::load(int index)
+{
+    if (!getEntry(index))
+        return NULL;
+
+    char* ptr = (char*)malloc(getSize(index));
+    if (!ptr)
+        return NULL;
+
+    if (!loadTo(index, ptr))
+    {
+        free(ptr);
+        return NULL;
+    }
+
+    return ptr;
+}
+
+unsigned int PAK_getNumFiles(const char* name)
+{
+    PakArchive* pArchive = PakArchive::get(name);
+
+    if (!pArchive)
+        return 0;
+
+    return pArchive->getNumFiles();
+}
+
+const char* PAK_getView(const char* name, int index)
+{
+#ifdef USE_UNPACKED_DATA
+    return nullptr;
+#else
+    PakArchive* pArchive = PakArchive::get(name);
+
+    if (!pArchive)
+        return nullptr;
+
+    return pArchive->getView(index);
 #endif
-    fclose(fileHandle);
+}
 
-    return((fileOffset/4)-2);
+void PAK_CloseAll()
+{
+    PakArchive::closeAll();
 }
 
 int LoadPak(const char* name, int index, char* ptr)
 {
+#ifndef USE_UNPACKED_DATA
+    if (Prefetch_Take(name, index, ptr))
+        return 1;
+#endif
+
+    return PAK_LoadDirect(name, index, ptr);
+}
+
+int PAK_LoadDirect(const char* name, int index, char* ptr)
+{
 #ifdef USE_UNPACKED_DATA
     char buffer[256];
     FILE* fHandle;
@@ -112,19 +639,13 @@ int LoadPak(const char* name, int index, char* ptr)
 
     return(1);
 #else
-    char* lptr;
-
-    lptr = loadPak(name,index);
+    PakArchive* pArchive = PakArchive::get(name);
 
-    if(!lptr)
+    if(!pArchive)
         return 0;
 
-    memcpy(ptr,lptr,getPakSize(name,index));
-
-
-    free(lptr);
-
-    return(1);
+    // decode straight into the caller's buffer, no intermediate copy
+    return pArchive->loadTo(index, ptr) ? 1 : 0;
 #endif
 }
 
@@ -150,61 +671,17 @@ int getPakSize(const char* name, int index)
 
     return (size);
 #else
-    char bufferName[512];
-    FILE* fileHandle;
-    s32 fileOffset;
-    s32 additionalDescriptorSize;
-    pakInfoStruct pakInfo;
-    s32 size=0;
-
-    strcpy(bufferName, homePath);
-    strcat(bufferName, name); // temporary until makeExtention is coded
-    strcat(bufferName,".PAK");
-
-    fileHandle = fopen(bufferName,"rb");
-
-    if(fileHandle) // a bit stupid, should return NULL right away
-    {
-        fseek(fileHandle,(index+1)*4,SEEK_SET);
-
-        fread(&fileOffset,4,1,fileHandle);
-        fileOffset = READ_LE_U32(&fileOffset);
-
-        fseek(fileHandle,fileOffset,SEEK_SET);
-
-        fread(&additionalDescriptorSize,4,1,fileHandle);
-        additionalDescriptorSize = READ_LE_U32(&additionalDescriptorSize);
+    PakArchive* pArchive = PakArchive::get(name);
 
-        readPakInfo(&pakInfo,fileHandle);
-
-        fseek(fileHandle,pakInfo.offset,SEEK_CUR);
-
-        if(pakInfo.compressionFlag == 0) // uncompressed
-        {
-            size = pakInfo.discSize;
-        }
-        else if(pakInfo.compressionFlag == 1) // compressed
-        {
-            size = pakInfo.uncompressedSize;
-        }
-        else if(pakInfo.compressionFlag == 4)
-        {
-            size = pakInfo.uncompressedSize;
-        }
-
-        fclose(fileHandle);
-    }
+    if (!pArchive)
+        return 0;
 
-    return size;
+    return pArchive->getSize(index);
 #endif
 }
 
 char* loadPak(const char* name, int index)
 {
-    if(PAK_getNumFiles(name) < index)
-        return NULL;
-    
-    
     //dumpPak(name);
 #ifdef USE_UNPACKED_DATA
     char buffer[256];
@@ -230,260 +707,43 @@ char* loadPak(const char* name, int index)
 
     return ptr;
 #else
-    char bufferName[512];
-    FILE* fileHandle;
-    u32 fileOffset;
-    u32 additionalDescriptorSize;
-    pakInfoStruct pakInfo;
-    char* ptr=0;
+    char* ptr = Prefetch_TakeBuffer(name, index);
+    if (ptr)
+        return ptr;
 
+    PakArchive* pArchive = PakArchive::get(name);
 
-    //makeExtention(bufferName, name, ".PAK");
-    strcpy(bufferName, homePath);
-    strcat(bufferName, name); // temporary until makeExtention is coded
-    strcat(bufferName,".PAK");
-
-    fileHandle = fopen(bufferName,"rb");
-
-    if(fileHandle) // a bit stupid, should return NULL right away
-    {
-        char nameBuffer[256] = "";
-
-        fseek(fileHandle,(index+1)*4,SEEK_SET);
-
-        fread(&fileOffset,4,1,fileHandle);
-        fileOffset = READ_LE_U32(&fileOffset);
-
-        fseek(fileHandle,fileOffset,SEEK_SET);
-
-        fread(&additionalDescriptorSize,4,1,fileHandle);
-        additionalDescriptorSize = READ_LE_U32(&additionalDescriptorSize);
-
-        if(additionalDescriptorSize)
-		{
-			fseek(fileHandle, additionalDescriptorSize-4, SEEK_CUR);
-		}
-
-		readPakInfo(&pakInfo,fileHandle);
-
-		if(pakInfo.offset)
-		{
-			ASSERT(pakInfo.offset<256);
-
-			fread(nameBuffer,pakInfo.offset,1,fileHandle);
-#ifdef FITD_DEBUGGER
-			printf("Loading %s/%s\n", name,nameBuffer+2);
-#endif
-		}
-		else
-		{
-			fseek(fileHandle,pakInfo.offset,SEEK_CUR);
-
-    #ifdef DREAMCAST
-            // ~CA: Trying to fix the god damn screen darkening problems.
-            // NOTE: Many 320x200 images are either 64000 bytes (pixels only) or
-            // 64768/64770 bytes (palette + pixels). Log only larger assets to
-            // keep the console usable.
-            int uncompressedSize = 0;
-            if (pakInfo.compressionFlag == 0)
-                uncompressedSize = pakInfo.discSize;
-            else
-                uncompressedSize = pakInfo.uncompressedSize;
-
-            if (uncompressedSize >= 60000)
-            {
-                const bool looksLikeScreen = (uncompressedSize == 64000 || uncompressedSize == 64768 || uncompressedSize == 64770);
-                dbgio_printf("[dc] loadPak(%s,%d) size=%d comp=%d%s\n",
-                             name, index, uncompressedSize, (int)pakInfo.compressionFlag,
-                             looksLikeScreen ? " [320x200-ish]" : "");
-            }
-    #endif
-		}
-
-		switch(pakInfo.compressionFlag)
-		{
-		case 0:
-			{
-                ptr = (char*)malloc(pakInfo.discSize);
-                if(!ptr)
-                {
-                    fclose(fileHandle);
-                    return NULL;
-                }
-                fread(ptr,pakInfo.discSize,1,fileHandle);
-				break;
-			}
-		case 1:
-			{
-                char * compressedDataPtr = (char *) malloc(pakInfo.discSize);
-                if(!compressedDataPtr)
-                {
-                    fclose(fileHandle);
-                    return NULL;
-                }
-                fread(compressedDataPtr, pakInfo.discSize, 1, fileHandle);
-                ptr = (char *) malloc(pakInfo.uncompressedSize);
-                if(!ptr)
-                {
-                    free(compressedDataPtr);
-                    fclose(fileHandle);
-                    return NULL;
-                }
-
-                if(PAK_explode((unsigned char*)compressedDataPtr, (unsigned char*)ptr, pakInfo.discSize, pakInfo.uncompressedSize, pakInfo.info5) != 0)
-                {
-                    free(compressedDataPtr);
-                    free(ptr);
-                    fclose(fileHandle);
-                    return NULL;
-                }
-
-                free(compressedDataPtr);
-                break;
-            }
-        case 4:
-            {
-                char * compressedDataPtr = (char *) malloc(pakInfo.discSize);
-                if(!compressedDataPtr)
-                {
-                    fclose(fileHandle);
-                    return NULL;
-                }
-                fread(compressedDataPtr, pakInfo.discSize, 1, fileHandle);
-                ptr = (char *) malloc(pakInfo.uncompressedSize);
-                if(!ptr)
-                {
-                    free(compressedDataPtr);
-                    fclose(fileHandle);
-                    return NULL;
-                }
-
-                if(PAK_deflate((unsigned char*)compressedDataPtr, (unsigned char*)ptr, pakInfo.discSize, pakInfo.uncompressedSize) != 0)
-                {
-                    free(compressedDataPtr);
-                    free(ptr);
-                    fclose(fileHandle);
-                    return NULL;
-                }
-
-                free(compressedDataPtr);
-                break;
-            }
-        default:
-            assert(false);
-            break;
-        }
-        fclose(fileHandle);
-    }
+    if (!pArchive)
+        return NULL;
 
-    return ptr;
+    return pArchive->load(index);
 #endif
 }
 
 void dumpPak(const char* name)
 {
 #ifdef WIN32 
-    unsigned int numEntries = PAK_getNumFiles(name);
-
-    for (unsigned int index = 0; index < numEntries; index++)
-    {
-        char bufferName[512];
-        FILE* fileHandle;
-        u32 fileOffset;
-        u32 additionalDescriptorSize;
-        pakInfoStruct pakInfo;
-        char* ptr = 0;
+    PakArchive* pArchive = PakArchive::get(name);
 
+    if (!pArchive)
+        return;
 
-        //makeExtention(bufferName, name, ".PAK");
-        strcpy(bufferName, homePath);
-        strcat(bufferName, name); // temporary until makeExtention is coded
-        strcat(bufferName, ".PAK");
-
-        fileHandle = fopen(bufferName, "rb");
+    for (unsigned int index = 0; index < pArchive->getNumFiles(); index++)
+    {
+        char* ptr = pArchive->load(index);
 
-        if (fileHandle) // a bit stupid, should return NULL right away
+        if (ptr)
         {
-            char nameBuffer[256] = "";
-
-            fseek(fileHandle, (index + 1) * 4, SEEK_SET);
-
-            fread(&fileOffset, 4, 1, fileHandle);
-            fileOffset = READ_LE_U32(&fileOffset);
-
-            fseek(fileHandle, fileOffset, SEEK_SET);
-
-            fread(&additionalDescriptorSize, 4, 1, fileHandle);
-            additionalDescriptorSize = READ_LE_U32(&additionalDescriptorSize);
-
-            if (additionalDescriptorSize)
-            {
-                fseek(fileHandle, additionalDescriptorSize - 4, SEEK_CUR);
-            }
-
-            readPakInfo(&pakInfo, fileHandle);
-
-            if (pakInfo.offset)
-            {
-                ASSERT(pakInfo.offset < 256);
-
-                fread(nameBuffer, pakInfo.offset, 1, fileHandle);
-#ifdef FITD_DEBUGGER
-                printf("Loading %s/%s\n", name, nameBuffer + 2);
-#endif
-            }
-            else
-            {
-                fseek(fileHandle, pakInfo.offset, SEEK_CUR);
-            }
-
-            switch (pakInfo.compressionFlag)
-            {
-            case 0:
-            {
-                ptr = (char*)malloc(pakInfo.discSize);
-                fread(ptr, pakInfo.discSize, 1, fileHandle);
-                break;
-            }
-            case 1:
-            {
-                char * compressedDataPtr = (char *)malloc(pakInfo.discSize);
-                fread(compressedDataPtr, pakInfo.discSize, 1, fileHandle);
-                ptr = (char *)malloc(pakInfo.uncompressedSize);
-
-                PAK_explode((unsigned char*)compressedDataPtr, (unsigned char*)ptr, pakInfo.discSize, pakInfo.uncompressedSize, pakInfo.info5);
-
-                free(compressedDataPtr);
-                break;
-            }
-            case 4:
-            {
-                char * compressedDataPtr = (char *)malloc(pakInfo.discSize);
-                fread(compressedDataPtr, pakInfo.discSize, 1, fileHandle);
-                ptr = (char *)malloc(pakInfo.uncompressedSize);
-
-                PAK_deflate((unsigned char*)compressedDataPtr, (unsigned char*)ptr, pakInfo.discSize, pakInfo.uncompressedSize);
-
-                free(compressedDataPtr);
-                break;
-            }
-            default:
-                assert(false);
-                break;
-            }
-            fclose(fileHandle);
-
+            mkdir(name);
+            char outputName[256];
+            sprintf(outputName, "%s/%02d_%s", name, index, pArchive->getEntry(index)->name.c_str());
+            FILE* foutputHandle = fopen(outputName, "wb+");
+            if (foutputHandle)
             {
-                mkdir(name);
-                char outputName[256];
-                sprintf(outputName, "%s/%02d_%s", name, index, nameBuffer + 2);
-                FILE* foutputHandle = fopen(outputName, "wb+");
-                if (foutputHandle)
-                {
-                    fwrite(ptr, pakInfo.uncompressedSize, 1, foutputHandle);
-                    fclose(foutputHandle);
-                }
+                fwrite(ptr, pArchive->getSize(index), 1, foutputHandle);
+                fclose(foutputHandle);
             }
+            free(ptr);
         }
     }
 #endif
@@ -19,10 +19,77 @@
 #ifndef _PAK_
 #define _PAK_
 
+#include <map>
+#include <memory>
+
+struct pakInfoStruct
+{
+    s32 discSize;
+    s32 uncompressedSize;
+    char compressionFlag;
+    char info5;
+    s16 offset;
+};
+
+// One parsed entry of a .PAK directory.
+struct pakEntryStruct
+{
+    pakInfoStruct info;
+    u32 dataOffset; // absolute file offset of the (possibly compressed) payload
+    std::string name;
+};
+
+// A .PAK archive opened once and kept open. The offset table and every entry
+// header are parsed up front, so size/compression queries never touch the disk.
+// Archives present in a FITD.PKX container (pakContainer.h) are served from it
+// instead, already decoded.
+class PakArchive
+{
+public:
+    ~PakArchive();
+
+    // Returns the cached archive for "name" (without extension), opening and
+    // parsing it on first use. Returns nullptr if the file can't be opened.
+    static PakArchive* get(const char* name);
+    static void closeAll();
+
+    unsigned int getNumFiles() const { return (unsigned int)m_entries.size(); }
+    const pakEntryStruct* getEntry(int index) const;
+    int getSize(int index) const; // uncompressed size, 0 if invalid
+
+    // Read-only view into the mapped archive for stored (uncompressed)
+    // entries, nullptr if the entry is compressed or the file isn't mapped.
+    // Valid until PAK_CloseAll().
+    const char* getView(int index) const;
+
+    // Decodes the entry into dest, which must hold getSize(index) bytes.
+    bool loadTo(int index, char* dest);
+    char* load(int index); // malloc'ed, caller frees
+
+private:
+    PakArchive() {}
+    bool parse();
+    bool parseContainer(const char* pakFileName);
+    void map();
+    void unmap();
+
+    std::string m_name;
+    FILE* m_fileHandle = nullptr;
+    bool m_sharedFile = false; // handle and mapping belong to the container
+    const u8* m_mappedData = nullptr;
+    size_t m_mappedSize = 0;
+    std::vector<pakEntryStruct> m_entries;
+
+    static std::map<std::string, std::unique_ptr<PakArchive>> s_archives;
+};
+
 char* loadPak(const char* name, int index);
 int LoadPak(const char* name, int index, char* ptr);
+int PAK_LoadDirect(const char* name, int index, char* ptr); // skips the prefetch staging cache
 int getPakSize(const char* name, int index);
 unsigned int PAK_getNumFiles(const char* name);
-void dumpPak(const char* name);
+void dumpPak(const char* name);
+const char* PAK_getView(const char* name, int index);
+void PAK_CloseAll();
 
 #endif
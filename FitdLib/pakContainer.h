@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark PAK container format (Resources)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// Single file built by tools/pakpack from a game install. Every entry of
+// every .PAK is stored already decoded, so loading one is a plain read (or a
+// pointer into the mapping) instead of a descriptor walk and an explode.
+//
+// Layout, all little endian:
+//   pakContainerHeaderStruct
+//   pakContainerArchiveStruct[numArchives]
+//   pakContainerEntryStruct[numEntries]
+//   string table (zero terminated names)
+//   entry data, each entry starting on a multiple of alignment
+//
+// The whole file is mapped at once, so alignment only matters for the in
+// place readers; build with --align 4096 to make every entry page aligned.
+
+#define PAK_CONTAINER_NAME "FITD.PKX"
+#define PAK_CONTAINER_MAGIC 0x31584B50 // "PKX1"
+#define PAK_CONTAINER_VERSION 1
+#define PAK_CONTAINER_NO_NAME 0xFFFFFFFF
+
+struct pakContainerHeaderStruct
+{
+    u32 magic;
+    u32 version;
+    u32 alignment;
+    u32 numArchives;
+    u32 numEntries;
+    u32 stringTableOffset;
+    u32 stringTableSize;
+    u32 dataOffset;
+};
+
+struct pakContainerArchiveStruct
+{
+    u32 nameOffset; // upper case base name, without .PAK
+    u32 firstEntry;
+    u32 numEntries;
+    u32 sourceSize; // size of the .PAK it was built from, a mismatch means the container is stale
+};
+
+struct pakContainerEntryStruct
+{
+    u32 offset; // absolute file offset of the decoded data
+    u32 size;
+    u32 nameOffset; // PAK_CONTAINER_NO_NAME if the entry had none
+    u32 reserved;
+    uint64_t hash; // pakContainerHash of the decoded data
+};
+
+// 64 bit FNV-1a
+inline uint64_t pakContainerHash(const void* data, size_t size)
+{
+    const u8* bytes = (const u8*)data;
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
@@ -17,97 +17,142 @@
 //
 //----------------------------------------------------------------------------
 #include "common.h"
+#include "polys.h"
 
-void hline(int x1, int x2, int y, unsigned char c);
 void line(int x1, int y1, int x2, int y2, unsigned char c);
 void pixel(int x, int y, unsigned char c);
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <math.h>
+#include <array>
+#include <string.h>
 
+#define SCREENWIDTH 320
 #define SCREENHEIGHT 200
-#define MAXPTS 10
-
-#define putdot(x,y) if ((y >= 0) && (y < SCREENHEIGHT)) dots[y][counters[y]++] = x;
-
-void swapFunc(int* a, int* b);
-#define swap(a,b) (swapFunc(&a,&b))
-
-void fillpoly(s16 * datas, int n, unsigned char c) {
-    static int dots[SCREENHEIGHT][MAXPTS];
-    static int counters[SCREENHEIGHT];
-    s16 x1, y1, x2, y2;
-    int i, j, k, dir = -2;
-    double step, curx;
-
-    if (n <= 2) {
-        switch (n) {
-  case 0:
-      return;
-  case 1:
-      pixel(datas[0], datas[1], c);
-      return;
-  case 2:
-      line(datas[0], datas[1], datas[2], datas[3], c);
-      return;
+#define MAXPTS 16
+
+// Edge crossings of each scanline. Only the rows between the polygon's top and
+// bottom vertex are cleared and filled, crossings past MAXPTS are dropped.
+static int s_crossings[SCREENHEIGHT][MAXPTS];
+static int s_counters[SCREENHEIGHT];
+
+static inline void putCrossing(int x, int y)
+{
+    if ((unsigned int)y < SCREENHEIGHT && s_counters[y] < MAXPTS)
+        s_crossings[y][s_counters[y]++] = x;
+}
+
+static inline int64_t floorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    if ((a % b) && ((a < 0) != (b < 0)))
+        q--;
+    return q;
+}
+
+// Crossings of the edge from (x1, y1) on the rows y1 (included) to y2
+// (excluded), within [clipY1, clipY2]. Each crossing is (int)(x + 0.5) of the
+// edge's exact x on that row, stepped as an integer quotient and remainder:
+// x = (2 * x1 * height + height + 2 * t * (x2 - x1)) / (2 * height) on the t-th row.
+static void walkEdge(int x1, int y1, int x2, int y2, int clipY1, int clipY2)
+{
+    int dir = (y2 > y1) ? 1 : -1;
+    int height = (y2 - y1) * dir;
+    int dx = x2 - x1;
+
+    int first = (dir > 0) ? (clipY1 - y1) : (y1 - clipY2);
+    int last = (dir > 0) ? (clipY2 - y1) : (y1 - clipY1);
+    if (first < 0)
+        first = 0;
+    if (last > height - 1)
+        last = height - 1;
+    if (first > last)
+        return;
+
+    int64_t denominator = 2 * (int64_t)height;
+    int64_t numerator = 2 * (int64_t)x1 * height + height + 2 * (int64_t)first * dx;
+
+    int quotient = (int)floorDiv(numerator, denominator);
+    int remainder = (int)(numerator - quotient * denominator);
+    int stepQuotient = (int)floorDiv(2 * (int64_t)dx, denominator);
+    int stepRemainder = (int)(2 * (int64_t)dx - stepQuotient * denominator);
+
+    int y = y1 + dir * first;
+
+    for (int t = first; t <= last; t++, y += dir)
+    {
+        if (s_counters[y] < MAXPTS)
+        {
+            // the conversion truncates towards 0
+            s_crossings[y][s_counters[y]++] = quotient + ((quotient < 0 && remainder) ? 1 : 0);
         }
-    }
 
-    // Reinit array counters
+        quotient += stepQuotient;
+        remainder += stepRemainder;
+        if (remainder >= denominator)
+        {
+            quotient++;
+            remainder -= denominator;
+        }
+    }
+}
 
-    for (i = 0; i < SCREENHEIGHT; i++) {
-        counters[i] = 0;
+// Walks the edges into the crossing table, then calls fillSpan(row, x1, x2, y)
+// for every span clipped to the screen, x1 <= x2.
+template <typename T>
+static void fillpolySpans(s16* datas, int n, T fillSpan)
+{
+    int minY = datas[1];
+    int maxY = datas[1];
+    for (int i = 1; i < n; i++)
+    {
+        minY = std::min<int>(minY, datas[i * 2 + 1]);
+        maxY = std::max<int>(maxY, datas[i * 2 + 1]);
     }
 
-    // Drawing lines
+    if (maxY < 0 || minY >= SCREENHEIGHT)
+        return;
+    minY = std::max(minY, 0);
+    maxY = std::min(maxY, SCREENHEIGHT - 1);
+
+    for (int i = minY; i <= maxY; i++)
+    {
+        s_counters[i] = 0;
+    }
 
-    x2 = datas[n * 2 - 2];
-    y2 = datas[n * 2 - 1];
+    // A vertex between a rising and a falling edge, or at the end of a run of
+    // horizontal ones, adds its own crossing to pair with the edge leaving it.
+    int x1, y1;
+    int x2 = datas[n * 2 - 2];
+    int y2 = datas[n * 2 - 1];
+    int dir = -2;
 
-    for (i = 0; i < n; i++) {
+    for (int i = 0; i < n; i++)
+    {
         x1 = x2;
         y1 = y2;
         x2 = datas[i * 2];
         y2 = datas[i * 2 + 1];
 
-        //  line(x1, y1, x2, y2, c);
-        //  continue;
-
-        if (y1 == y2) {
-            //      printf("Horizontal line. x1: %i, y1: %i, x2: %i, y2: %i\n", x1, y1, x2, y2);
+        if (y1 == y2)
+        {
             if (!dir)
                 continue;
-            putdot(x1, y1);
+            putCrossing(x1, y1);
             dir = 0;
             continue;
         }
 
-        step = (double) (x2 - x1) / (y2 - y1);
+        walkEdge(x1, y1, x2, y2, minY, maxY);
 
-        //  printf("x1: %i, y1 = %i, x2 = %i, y2 = %i, step: %f\n", x1, y1, x2, y2, step);
-
-        curx = x1;
-
-        if (y1 < y2) {
-            for (j = y1; j < y2; j++, curx += step) {
-                //    printf("j = %i, curx = %f\n", j, curx);
-                putdot((int)(curx + 0.5), j);
-            }
-            if (dir == -1) {
-                //    printf("Adding extra (%i, %i)\n", x1, y1);
-                putdot(x1, y1);
-            }
+        if (y1 < y2)
+        {
+            if (dir == -1)
+                putCrossing(x1, y1);
             dir = 1;
-        } else {
-            for (j = y1; j > y2; j--, curx -= step) {
-                //    printf("j = %i, curx = %f\n", j, curx);
-                putdot((int)(curx + 0.5), j);
-            }
-            if (dir == 1) {
-                //    printf("Adding extra (%i, %i)\n", x1, y1);
-                putdot(x1, y1);
-            }
+        }
+        else
+        {
+            if (dir == 1)
+                putCrossing(x1, y1);
             dir = -1;
         }
     }
@@ -117,42 +162,160 @@ void fillpoly(s16 * datas, int n, unsigned char c) {
     x2 = datas[0];
     y2 = datas[1];
 
-    if (((y1 < y2) && (dir == -1)) || ((y1 > y2) && (dir == 1)) || ((y1 == y2) && (dir == 0))) {
-        //  printf("Adding final extra (%i, %i)\n", x1, y1);
-        putdot(x1, y1);
+    if (((y1 < y2) && (dir == -1)) || ((y1 > y2) && (dir == 1)) || ((y1 == y2) && (dir == 0)))
+    {
+        putCrossing(x1, y1);
     }
 
-    // NOTE: all counters should be even now. If not, this is a bad (C) thing :-P
+    for (int y = minY; y <= maxY; y++)
+    {
+        int count = s_counters[y];
+        int* crossings = s_crossings[y];
 
-    // Sorting datas
-
-    for (i = 0; i < SCREENHEIGHT; i++) {
-        // Very bad sorting... but arrays are very small (0, 2 or 4), so it's no quite use...
-        for (j = 0; j < (counters[i] - 1); j++) {
-            for (k = 0; k < (counters[i] - 1); k++) {
-                if (dots[i][k] > dots[i][k + 1])
-                    swap(dots[i][k], dots[i][k + 1]);
+        // 2 or 4 crossings most of the time
+        for (int i = 1; i < count; i++)
+        {
+            int x = crossings[i];
+            int j = i;
+            for (; j > 0 && crossings[j - 1] > x; j--)
+            {
+                crossings[j] = crossings[j - 1];
             }
+            crossings[j] = x;
+        }
+
+        unsigned char* row = polyBackBuffer + y * SCREENWIDTH;
+        for (int i = 0; i < count - 1; i += 2)
+        {
+            int spanX1 = std::max(crossings[i], 0);
+            int spanX2 = std::min(crossings[i + 1], SCREENWIDTH - 1);
+            if (spanX1 <= spanX2)
+                fillSpan(row, spanX1, spanX2, y);
         }
     }
+}
 
-    // Drawing.
-
-    for (i = 0; i < SCREENHEIGHT; i++) {
-        if (counters[i]) {
-            //      printf("%i dots on line %i\n", counters[i], i);
-            for (j = 0; j < counters[i] - 1; j += 2) {
-                //    printf("Drawing line (%i, %i)-%i\n", dots[i][j], dots[i][j + 1], i);
-                hline(dots[i][j], dots[i][j + 1], i, c);
-#ifdef DEBUGGING_POLYS
-                if ((!dots[i][j]) || !(dots[i][j + 1])) {
-                    printf("fillpoly: BLARGH!\n");
-                    assert(0);
-                }
-#endif
-            }
+void fillpoly(s16* datas, int n, unsigned char c)
+{
+    switch (n)
+    {
+    case 0:
+        return;
+    case 1:
+        pixel(datas[0], datas[1], c);
+        return;
+    case 2:
+        line(datas[0], datas[1], datas[2], datas[3], c);
+        return;
+    }
+
+    fillpolySpans(datas, n, [c](unsigned char* row, int x1, int x2, int y) {
+        memset(row + x1, c, x2 - x1 + 1);
+    });
+}
+
+// Noise of the dither material, one byte per pixel, repeating every 256 pixels
+static const u8* getNoiseTable()
+{
+    static const std::array<u8, 256 * 256> noiseTable = [] {
+        std::array<u8, 256 * 256> table;
+        u32 seed = 0x2545F491;
+        for (auto& value : table)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            value = (u8)(seed >> 24);
         }
+        return table;
+    }();
+
+    return noiseTable.data();
+}
+
+// The ramp shader's mirrored repeat of a 16.16 shade: 0 up to 15, back down to
+// 0, and so on
+static inline int rampShade(int value)
+{
+    const int period = 30 << 16;
+
+    if ((unsigned int)value <= (15 << 16))
+        return value >> 16;
+
+    value %= period;
+    if (value < 0)
+        value += period;
+    if (value > (15 << 16))
+        value = period - value;
+
+    return value >> 16;
+}
+
+void fillpolyMaterial(s16* datas, int n, unsigned char c, u8 polyType)
+{
+    if (n <= 2)
+    {
+        fillpoly(datas, n, c);
+        return;
+    }
+
+    const int bank = c & 0xF0;
+    const int startColor = c & 0xF;
+
+    int minX = datas[0];
+    int maxX = datas[0];
+    int minY = datas[1];
+    for (int i = 1; i < n; i++)
+    {
+        minX = std::min<int>(minX, datas[i * 2]);
+        maxX = std::max<int>(maxX, datas[i * 2]);
+        minY = std::min<int>(minY, datas[i * 2 + 1]);
+    }
+
+    switch (polyType)
+    {
+    default:
+        fillpoly(datas, n, c);
+        break;
+
+    case 1: // dither: the bgfx noise shader scales the color by 0.5 to 1
+    {
+        const u8* noiseTable = getNoiseTable();
+        fillpolySpans(datas, n, [=](unsigned char* row, int x1, int x2, int y) {
+            const u8* noise = noiseTable + (y & 255) * 256;
+            for (int x = x1; x <= x2; x++)
+            {
+                row[x] = (unsigned char)(bank | ((startColor * (256 + noise[x & 255])) >> 9));
+            }
+        });
+        break;
+    }
+
+    case 4: // copper: one shade per scanline
+    case 5: // copper2: one shade every 2 scanlines
+    {
+        const int step = (polyType == 5) ? (1 << 15) : (1 << 16);
+        fillpolySpans(datas, n, [=](unsigned char* row, int x1, int x2, int y) {
+            int shade = rampShade((startColor << 16) + (y - minY) * step);
+            memset(row + x1, bank | shade, x2 - x1 + 1);
+        });
+        break;
+    }
+
+    case 3: // marbre: ramps over the 15 shades from left to right
+    case 6: // marbre2: from right to left
+    {
+        const int width = std::max(maxX - minX, 1);
+        const int step = (15 << 16) / width;
+        const bool reverse = (polyType == 6);
+        fillpolySpans(datas, n, [=](unsigned char* row, int x1, int x2, int y) {
+            int value = (startColor << 16) + (x1 - minX) * step;
+            for (int x = x1; x <= x2; x++, value += step)
+            {
+                row[x] = (unsigned char)(bank | rampShade(reverse ? (15 << 16) - value : value));
+            }
+        });
+        break;
+    }
     }
 }
-
-#undef swap
@@ -0,0 +1,35 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark polys (Rendering)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// Software polygon filler of the 8-bit 320x200 paths: the AITD1 masks, the
+// headless renderer and the Dreamcast's PAL8 fallback. Polygons are drawn into
+// polyBackBuffer.
+
+extern unsigned char* polyBackBuffer;
+
+// Fills the polygon of n (x, y) pairs in datas with the color c. Each
+// scanline is filled between pairs of sorted edge crossings, both included.
+void fillpoly(s16* datas, int n, unsigned char c);
+
+// Same polygon, shaded like the osystem_fillPoly materials of the bgfx
+// renderer: polyType 1 (dither) is the noise material, 3 and 6 the marbre
+// ramps, 4 and 5 the copper ramps and anything else flat.
+void fillpolyMaterial(s16* datas, int n, unsigned char c, u8 polyType);
@@ -0,0 +1,374 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark resource prefetcher (Resources)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "common.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct prefetchEntryStruct
+{
+    std::string name;
+    int index;
+    char* data; // malloc'ed, nullptr while queued
+    int size;
+};
+
+// One lock for the queue, the staging cache and the in-flight entry. The
+// condition wakes the worker on new requests and the game thread when the
+// entry it waits for is done.
+static std::mutex s_prefetchMutex;
+static std::condition_variable s_prefetchCond;
+
+static std::thread s_prefetchThread;
+static bool s_prefetchRunning = false;
+static bool s_prefetchQuit = false;
+
+static std::deque<prefetchEntryStruct> s_prefetchQueue;
+static std::vector<prefetchEntryStruct> s_prefetchStaged;
+
+static std::string s_prefetchInFlightName;
+static int s_prefetchInFlightIndex = -1;
+static u32 s_prefetchGeneration = 0; // bumped by flushes, so in-flight results are dropped
+
+static prefetchStatsStruct s_prefetchStats = {};
+
+static bool prefetchIsInFlight(const std::string& name, int index)
+{
+    return s_prefetchInFlightIndex == index && s_prefetchInFlightName == name;
+}
+
+static void prefetchWorker()
+{
+    std::unique_lock<std::mutex> lock(s_prefetchMutex);
+
+    for (;;)
+    {
+        s_prefetchCond.wait(lock, [] { return s_prefetchQuit || !s_prefetchQueue.empty(); });
+
+        if (s_prefetchQuit)
+            break;
+
+        prefetchEntryStruct entry = std::move(s_prefetchQueue.front());
+        s_prefetchQueue.pop_front();
+
+        s_prefetchInFlightName = entry.name;
+        s_prefetchInFlightIndex = entry.index;
+        const u32 generation = s_prefetchGeneration;
+
+        lock.unlock();
+        entry.size = getPakSize(entry.name.c_str(), entry.index);
+        lock.lock();
+
+        // keep what is already staged rather than going over the budget
+        if (entry.size > 0 && s_prefetchStats.stagedBytes + entry.size <= PREFETCH_STAGING_SIZE)
+        {
+            lock.unlock();
+            entry.data = (char*)malloc(entry.size);
+            if (entry.data && !PAK_LoadDirect(entry.name.c_str(), entry.index, entry.data))
+            {
+                free(entry.data);
+                entry.data = nullptr;
+            }
+            lock.lock();
+
+            if (entry.data && generation == s_prefetchGeneration)
+            {
+                s_prefetchStats.stagedBytes += entry.size;
+                s_prefetchStaged.push_back(std::move(entry));
+            }
+            else
+            {
+                free(entry.data);
+            }
+        }
+
+        s_prefetchInFlightIndex = -1;
+        s_prefetchInFlightName.clear();
+        s_prefetchCond.notify_all();
+    }
+}
+
+static void prefetchFreeStaged()
+{
+    for (auto& entry : s_prefetchStaged)
+    {
+        free(entry.data);
+    }
+    s_prefetchStaged.clear();
+    s_prefetchStats.stagedBytes = 0;
+}
+
+void Prefetch_Init()
+{
+    if (s_prefetchRunning)
+        return;
+
+    s_prefetchQuit = false;
+    s_prefetchThread = std::thread(prefetchWorker);
+    s_prefetchRunning = true;
+}
+
+void Prefetch_Shutdown()
+{
+    if (!s_prefetchRunning)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_prefetchMutex);
+        s_prefetchQuit = true;
+        s_prefetchQueue.clear();
+    }
+    s_prefetchCond.notify_all();
+    s_prefetchThread.join();
+    s_prefetchRunning = false;
+
+    prefetchFreeStaged();
+}
+
+// Caller holds the lock.
+static void prefetchQueue(const std::string& name, int index)
+{
+    if (prefetchIsInFlight(name, index))
+        return;
+
+    for (auto& entry : s_prefetchStaged)
+    {
+        if (entry.index == index && entry.name == name)
+            return;
+    }
+
+    for (auto& entry : s_prefetchQueue)
+    {
+        if (entry.index == index && entry.name == name)
+            return;
+    }
+
+    // entries readable in place from the mapped archive gain nothing
+    if (PAK_getView(name.c_str(), index))
+        return;
+
+    s_prefetchQueue.push_back({ name, index, nullptr, 0 });
+    s_prefetchStats.requests++;
+}
+
+void Prefetch_Request(const char* name, int index)
+{
+    if (!s_prefetchRunning || index < 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_prefetchMutex);
+        prefetchQueue(name, index);
+    }
+    s_prefetchCond.notify_all();
+}
+
+static void addUniqueRoom(std::vector<int>& rooms, int room)
+{
+    if (room < 0 || room >= (int)roomDataTable.size())
+        return;
+
+    if (std::find(rooms.begin(), rooms.end(), room) == rooms.end())
+        rooms.push_back(room);
+}
+
+void Prefetch_Neighbours()
+{
+    if (!s_prefetchRunning)
+        return;
+
+    if (currentRoom < 0 || currentRoom >= (int)roomDataTable.size())
+        return;
+
+    // the current room first, then the ones reachable through a room change
+    // zone, then the ones seen from the current camera
+    std::vector<int> rooms;
+    addUniqueRoom(rooms, currentRoom);
+
+    for (auto& zone : roomDataTable[currentRoom].sceZoneTable)
+    {
+        if (zone.type == 0)
+            addUniqueRoom(rooms, zone.parameter);
+    }
+
+    int currentCamera = -1;
+    if (NumCamera >= 0 && NumCamera < (int)cameraDataTable.size())
+    {
+        currentCamera = roomDataTable[currentRoom].cameraIdxTable[NumCamera];
+
+        for (auto& viewedRoom : cameraDataTable[NumCamera]->viewedRoomTable)
+        {
+            addUniqueRoom(rooms, viewedRoom.viewedRoomIdx);
+        }
+    }
+
+    char cameraName[16];
+    char maskName[16];
+    sprintf(cameraName, "CAMERA%02d", g_currentFloor);
+    sprintf(maskName, "MASK%02d", g_currentFloor);
+    const bool hasMasks = (g_gameId >= JACK) && (g_gameId != TIMEGATE);
+
+    std::vector<std::pair<std::string, int>> wanted;
+
+    for (int room : rooms)
+    {
+        for (u16 cameraIdx : roomDataTable[room].cameraIdxTable)
+        {
+            if (cameraIdx == currentCamera)
+                continue;
+
+            if (std::find(wanted.begin(), wanted.end(), std::make_pair(std::string(cameraName), (int)cameraIdx)) != wanted.end())
+                continue;
+
+            wanted.emplace_back(cameraName, cameraIdx);
+            if (hasMasks)
+                wanted.emplace_back(maskName, cameraIdx);
+        }
+    }
+
+    if (HQ_Bodys)
+    {
+        for (auto& object : ListWorldObjets)
+        {
+            if (object.stage != g_currentFloor || object.body == -1)
+                continue;
+
+            if (std::find(rooms.begin(), rooms.end(), object.room) == rooms.end())
+                continue;
+
+            if (!HQR_Contains(HQ_Bodys, object.body))
+                wanted.emplace_back(HQR_GetName(HQ_Bodys), object.body);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_prefetchMutex);
+
+        // retarget: whatever was predicted from the previous camera and isn't
+        // wanted anymore goes away
+        s_prefetchQueue.clear();
+
+        for (size_t i = 0; i < s_prefetchStaged.size();)
+        {
+            prefetchEntryStruct& entry = s_prefetchStaged[i];
+
+            if (std::find(wanted.begin(), wanted.end(), std::make_pair(entry.name, entry.index)) == wanted.end())
+            {
+                s_prefetchStats.dropped++;
+                s_prefetchStats.stagedBytes -= entry.size;
+                free(entry.data);
+                s_prefetchStaged.erase(s_prefetchStaged.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        for (auto& request : wanted)
+        {
+            prefetchQueue(request.first, request.second);
+        }
+    }
+    s_prefetchCond.notify_all();
+}
+
+void Prefetch_Flush()
+{
+    if (!s_prefetchRunning)
+        return;
+
+    std::lock_guard<std::mutex> lock(s_prefetchMutex);
+
+    s_prefetchQueue.clear();
+    s_prefetchStats.dropped += (u32)s_prefetchStaged.size();
+    prefetchFreeStaged();
+    s_prefetchGeneration++;
+}
+
+static char* prefetchTake(const char* name, int index, int* size)
+{
+    if (!s_prefetchRunning)
+        return nullptr;
+
+    std::unique_lock<std::mutex> lock(s_prefetchMutex);
+
+    const std::string key = name;
+
+    // the worker is on it: finishing is cheaper than decoding a second time
+    if (prefetchIsInFlight(key, index))
+    {
+        s_prefetchStats.waits++;
+        s_prefetchCond.wait(lock, [&] { return !prefetchIsInFlight(key, index); });
+    }
+
+    for (auto it = s_prefetchStaged.begin(); it != s_prefetchStaged.end(); ++it)
+    {
+        if (it->index == index && it->name == key)
+        {
+            char* data = it->data;
+            *size = it->size;
+            s_prefetchStats.stagedBytes -= it->size;
+            s_prefetchStats.hits++;
+            s_prefetchStaged.erase(it);
+            return data;
+        }
+    }
+
+    // the caller loads it now, no need for the worker to do it again
+    for (auto it = s_prefetchQueue.begin(); it != s_prefetchQueue.end(); ++it)
+    {
+        if (it->index == index && it->name == key)
+        {
+            s_prefetchQueue.erase(it);
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+bool Prefetch_Take(const char* name, int index, char* dest)
+{
+    int size = 0;
+    char* data = prefetchTake(name, index, &size);
+
+    if (!data)
+        return false;
+
+    memcpy(dest, data, size);
+    free(data);
+
+    return true;
+}
+
+char* Prefetch_TakeBuffer(const char* name, int index)
+{
+    int size = 0;
+    return prefetchTake(name, index, &size);
+}
+
+const prefetchStatsStruct& Prefetch_GetStats()
+{
+    return s_prefetchStats;
+}
@@ -0,0 +1,54 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark resource prefetcher (Resources)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// A worker thread loads and decodes PAK entries that are likely to be needed
+// soon (backgrounds and masks of the neighbouring cameras, bodies of the
+// neighbouring rooms) into a staging cache. loadPak/LoadPak take the staged
+// copy instead of hitting the disk and the decompressor.
+
+struct prefetchStatsStruct
+{
+    u32 requests; // entries queued
+    u32 hits; // loads served from the staging cache
+    u32 waits; // loads that waited for the worker to finish the entry
+    u32 dropped; // staged entries discarded without being used
+    u32 stagedBytes;
+};
+
+void Prefetch_Init();
+void Prefetch_Shutdown();
+
+// Queues the cameras, masks and bodies reachable from the current camera and room.
+void Prefetch_Neighbours();
+
+void Prefetch_Request(const char* name, int index);
+
+// Drops everything queued or staged, for floor changes.
+void Prefetch_Flush();
+
+// Copies a staged entry into dest (which must hold getPakSize bytes) and
+// releases it. Returns false if the entry wasn't prefetched.
+bool Prefetch_Take(const char* name, int index, char* dest);
+
+// Same, handing over the malloc'ed staging buffer.
+char* Prefetch_TakeBuffer(const char* name, int index);
+
+const prefetchStatsStruct& Prefetch_GetStats();
@@ -3,25 +3,12 @@
 #include "r_occlude.h"
 
 #include "fitd_endian_read.h"
+#include "polys.h"
 
 #include <algorithm>
 #include <array>
 #include <vector>
 
-struct sMaskStruct
-{
-    u16 x1;
-    u16 y1;
-    u16 x2;
-    u16 y2;
-    u16 deltaX;
-    u16 deltaY;
-
-    std::array<u8, 320 * 200> mask;
-};
-
-static std::vector<std::vector<sMaskStruct>> g_maskBuffers;
-
 void loadMask(int cameraIdx)
 {
     if (g_gameId == TIMEGATE)
@@ -38,47 +25,45 @@ void loadMask(int cameraIdx)
 
     g_MaskPtr = (unsigned char*)loadPak(name, cameraIdx);
 
-    g_maskBuffers.clear();
-    g_maskBuffers.resize(cameraDataTable[NumCamera]->numViewedRooms);
+    osystem_clearMasks();
+
+    // the spans of each mask are decoded into its own rectangle
+    std::vector<u8> mask;
+
     for (int i = 0; i < cameraDataTable[NumCamera]->numViewedRooms; i++)
     {
         cameraViewedRoomStruct* pRoomView = &cameraDataTable[NumCamera]->viewedRoomTable[i];
         unsigned char* pViewedRoomMask = g_MaskPtr + READ_LE_U32(g_MaskPtr + i * 4);
 
-        g_maskBuffers[i].reserve(pRoomView->masks.size());
         for (int j = 0; j < pRoomView->masks.size(); j++)
         {
-            g_maskBuffers[i].emplace_back();
-            sMaskStruct* pDestMask = &g_maskBuffers[i].back();
             unsigned char* pMaskData = pViewedRoomMask + READ_LE_U32(pViewedRoomMask + j * 4);
 
-            pDestMask->mask.fill(0);
-
-            pDestMask->x1 = READ_LE_U16(pMaskData);
+            u16 x1 = READ_LE_U16(pMaskData);
             pMaskData += 2;
-            pDestMask->y1 = READ_LE_U16(pMaskData);
+            u16 y1 = READ_LE_U16(pMaskData);
             pMaskData += 2;
-            pDestMask->x2 = READ_LE_U16(pMaskData);
+            u16 x2 = READ_LE_U16(pMaskData);
             pMaskData += 2;
-            pDestMask->y2 = READ_LE_U16(pMaskData);
+            u16 y2 = READ_LE_U16(pMaskData);
             pMaskData += 2;
-            pDestMask->deltaX = READ_LE_U16(pMaskData);
+            u16 deltaX = READ_LE_U16(pMaskData);
             pMaskData += 2;
-            pDestMask->deltaY = READ_LE_U16(pMaskData);
+            u16 deltaY = READ_LE_U16(pMaskData);
             pMaskData += 2;
 
-            assert(pDestMask->deltaX == pDestMask->x2 - pDestMask->x1 + 1);
-            assert(pDestMask->deltaY == pDestMask->y2 - pDestMask->y1 + 1);
+            assert(deltaX == x2 - x1 + 1);
+            assert(deltaY == y2 - y1 + 1);
 
-            for (int k = 0; k < pDestMask->deltaY; k++)
+            mask.assign(deltaX * deltaY, 0);
+
+            for (int k = 0; k < deltaY; k++)
             {
                 u16 uNumEntryForLine = READ_LE_U16(pMaskData);
                 pMaskData += 2;
 
-                unsigned char* pSourceBuffer = (unsigned char*)aux;
-                (void)pSourceBuffer;
-
-                int offset = pDestMask->x1 + pDestMask->y1 * 320 + k * 320;
+                int offset = k * deltaX;
+                int lineEnd = offset + deltaX;
 
                 for (int l = 0; l < uNumEntryForLine; l++)
                 {
@@ -87,24 +72,27 @@ void loadMask(int cameraIdx)
 
                     offset += uNumSkip;
 
-                    for (int m = 0; m < uNumCopy; m++)
-                    {
-                        pDestMask->mask[offset] = 0xFF;
-                        offset++;
-                    }
+                    // texels past x2 were never drawn
+                    int numCopy = std::min<int>(uNumCopy, lineEnd - offset);
+                    if (numCopy > 0)
+                        memset(&mask[offset], 0xFF, numCopy);
+                    offset += uNumCopy;
                 }
             }
 
-            osystem_createMask(pDestMask->mask, i, j, pDestMask->x1, pDestMask->y1, pDestMask->x2, pDestMask->y2);
+            osystem_createMask(mask.data(), i, j, x1, y1, x2, y2);
         }
     }
 }
 
-void fillpoly(s16* datas, int n, unsigned char c);
-extern unsigned char* polyBackBuffer;
-
 void createAITD1Mask()
 {
+    osystem_clearMasks();
+
+    // the polygons of each mask are drawn on screen, then cropped to their box
+    static std::array<u8, 320 * 200> screenMask;
+    std::vector<u8> mask;
+
     for (int viewedRoomIdx = 0; viewedRoomIdx < cameraDataTable[NumCamera]->numViewedRooms; viewedRoomIdx++)
     {
         cameraViewedRoomStruct* pcameraViewedRoomData = &cameraDataTable[NumCamera]->viewedRoomTable[viewedRoomIdx];
@@ -117,10 +105,7 @@ void createAITD1Mask()
 
         for (int maskIdx = 0; maskIdx < numMask; maskIdx++)
         {
-            sMaskStruct theMaskStruct;
-            sMaskStruct* pDestMask = &theMaskStruct;
-            pDestMask->mask.fill(0);
-            polyBackBuffer = pDestMask->mask.data();
+            polyBackBuffer = screenMask.data();
 
             int numMaskZone = READ_LE_U16(data);
             (void)numMaskZone;
@@ -161,7 +146,24 @@ void createAITD1Mask()
                 polyBackBuffer = nullptr;
             }
 
-            osystem_createMask(pDestMask->mask, viewedRoomIdx, maskIdx, minX - 1, minY - 1, maxX + 1, maxY + 1);
+            int x1 = std::max(minX - 1, 0);
+            int y1 = std::max(minY - 1, 0);
+            int x2 = std::min(maxX + 1, 319);
+            int y2 = std::min(maxY + 1, 199);
+
+            mask.clear();
+            if (x1 <= x2 && y1 <= y2)
+            {
+                for (int y = y1; y <= y2; y++)
+                {
+                    mask.insert(mask.end(), &screenMask[y * 320 + x1], &screenMask[y * 320 + x2 + 1]);
+                }
+
+                // fillpoly stays within the polygons' box
+                memset(&screenMask[y1 * 320], 0, (y2 - y1 + 1) * 320);
+            }
+
+            osystem_createMask(mask.data(), viewedRoomIdx, maskIdx, x1, y1, x2, y2);
 
             int numOverlay = READ_LE_U16(data);
             data += 2;
@@ -191,13 +193,111 @@ static int isBgOverlayRequired(int X1, int X2, int Z1, int Z2, char* data, int p
     return (0);
 }
 
-void drawBgOverlay(tObject* actorPtr)
+// Rectangles of the masks found in front of the actors of the frame. Those of
+// a mask don't overlap, so drawBgOverlays draws each pixel of it once.
+static std::vector<maskRectStruct> frameMaskRects;
+
+// Splits rect around other, adding the parts outside of it to pieces
+static void subtractMaskRect(const maskRectStruct& rect, const maskRectStruct& other, std::vector<maskRectStruct>& pieces)
+{
+    if (other.x1 > rect.x2 || other.x2 < rect.x1 || other.y1 > rect.y2 || other.y2 < rect.y1)
+    {
+        pieces.push_back(rect);
+        return;
+    }
+
+    maskRectStruct piece = rect;
+    if (other.y1 > rect.y1)
+    {
+        piece.y1 = rect.y1;
+        piece.y2 = other.y1 - 1;
+        pieces.push_back(piece);
+    }
+    if (other.y2 < rect.y2)
+    {
+        piece.y1 = other.y2 + 1;
+        piece.y2 = rect.y2;
+        pieces.push_back(piece);
+    }
+
+    piece.y1 = std::max(rect.y1, other.y1);
+    piece.y2 = std::min(rect.y2, other.y2);
+    if (other.x1 > rect.x1)
+    {
+        piece.x1 = rect.x1;
+        piece.x2 = other.x1 - 1;
+        pieces.push_back(piece);
+    }
+    if (other.x2 < rect.x2)
+    {
+        piece.x1 = other.x2 + 1;
+        piece.x2 = rect.x2;
+        pieces.push_back(piece);
+    }
+}
+
+// Whether a rectangle of a mask the actor isn't behind overlaps its clip
+// rectangle. Drawn at the end of the frame, it would cover the actor.
+static bool isMaskRectOverActor(int roomId, const std::vector<int>& actorMasks)
+{
+    for (const maskRectStruct& rect : frameMaskRects)
+    {
+        if (rect.x1 > clipRight || rect.x2 < clipLeft || rect.y1 > clipBottom || rect.y2 < clipTop)
+            continue;
+        if (rect.roomId == roomId && std::find(actorMasks.begin(), actorMasks.end(), rect.maskId) != actorMasks.end())
+            continue;
+        return true;
+    }
+    return false;
+}
+
+// Adds the clip rectangle to the mask, less what its rectangles already cover
+static void addMaskRect(int roomId, int maskId)
+{
+    static std::vector<maskRectStruct> pieces;
+    static std::vector<maskRectStruct> remainingPieces;
+
+    pieces.clear();
+    pieces.push_back({ roomId, maskId, clipLeft, clipTop, clipRight, clipBottom });
+
+    for (const maskRectStruct& other : frameMaskRects)
+    {
+        if (other.roomId != roomId || other.maskId != maskId)
+            continue;
+
+        remainingPieces.clear();
+        for (const maskRectStruct& piece : pieces)
+        {
+            subtractMaskRect(piece, other, remainingPieces);
+        }
+        pieces.swap(remainingPieces);
+
+        if (pieces.empty())
+            return;
+    }
+
+    frameMaskRects.insert(frameMaskRects.end(), pieces.begin(), pieces.end());
+}
+
+void drawBgOverlays()
+{
+    if (!frameMaskRects.empty())
+    {
+        osystem_drawMasks(frameMaskRects.data(), (int)frameMaskRects.size());
+        frameMaskRects.clear();
+    }
+}
+
+void drawBgOverlay(tObject* actorPtr, const objectMarkStruct& actorMark)
 {
     char* data;
     char* data2;
 
     int numOverlayZone;
 
+    static std::vector<int> actorMasks;
+    actorMasks.clear();
+
     actorPtr->screenXMin = BBox3D1;
     actorPtr->screenYMin = BBox3D2;
     actorPtr->screenXMax = BBox3D3;
@@ -220,9 +320,10 @@ void drawBgOverlay(tObject* actorPtr)
         }
     }
     if (pcameraViewedRoomData == NULL)
-        return;
-
-    if (g_gameId == AITD1)
+    {
+        // out of the rooms this camera views, the actor is behind no mask
+    }
+    else if (g_gameId == AITD1)
     {
         data2 = room_PtrCamera[NumCamera] + pcameraViewedRoomData->offsetToMask;
         data = data2;
@@ -241,9 +342,7 @@ void drawBgOverlay(tObject* actorPtr)
                                     data + 4,
                                     *(s16*)(data)))
             {
-                osystem_setClip(clipLeft, clipTop, clipRight, clipBottom);
-                osystem_drawMask(relativeCameraIndex, i);
-                osystem_clearClip();
+                actorMasks.push_back(i);
             }
 
             numOverlay = *(s16*)(data);
@@ -268,14 +367,25 @@ void drawBgOverlay(tObject* actorPtr)
 
                 if (actorX1 >= pRect->zoneX1 && actorZ1 >= pRect->zoneZ1 && actorX2 <= pRect->zoneX2 && actorZ2 <= pRect->zoneZ2)
                 {
-                    osystem_setClip(clipLeft, clipTop, clipRight, clipBottom);
-                    osystem_drawMask(relativeCameraIndex, i);
-                    osystem_clearClip();
+                    actorMasks.push_back(i);
                     break;
                 }
             }
         }
     }
 
+    // pending masks the actor isn't behind go under it: they are drawn with the
+    // actors before it, it is drawn after them
+    if (isMaskRectOverActor(relativeCameraIndex, actorMasks))
+    {
+        FlushObjectsBefore(actorMark);
+        drawBgOverlays();
+    }
+
+    for (int maskId : actorMasks)
+    {
+        addMaskRect(relativeCameraIndex, maskId);
+    }
+
     SetClip(0, 0, 319, 199);
 }
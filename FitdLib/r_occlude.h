@@ -1,8 +1,14 @@
 #pragma once
 
 struct tObject;
+struct objectMarkStruct;
 
 // Occlusion / background-mask overlay helpers.
 void loadMask(int cameraIdx);
 void createAITD1Mask();
-void drawBgOverlay(tObject* actorPtr);
+
+// Finds the masks in front of the actor, within its screen box. They are drawn
+// by drawBgOverlays, once the actors of the frame are. Pending masks the actor
+// isn't behind are drawn first, with the objects displayed before actorMark.
+void drawBgOverlay(tObject* actorPtr, const objectMarkStruct& actorMark);
+void drawBgOverlays();
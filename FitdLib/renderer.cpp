@@ -21,6 +21,8 @@
 #include <algorithm>
 
 #include "dc_fastmath.h"
+#include "vertexTransform.h"
+#include "jobs.h"
 
 #ifdef DREAMCAST
 #include "System/r_units.h"
@@ -51,23 +53,35 @@ struct primEntryStruct
 	u16 numOfVertices;
 	primTypeEnum type;
     float sortDepth;
-	rendererPointStruct vertices[NUM_MAX_VERTEX_IN_PRIM];
+	rendererPointStruct* vertices; // into primVertices
 };
 
-#define NUM_MAX_PRIM_ENTRY 500
+// Primitives of every object displayed since the last FlushObjects
+#define NUM_MAX_PRIM_ENTRY 2000
+#define NUM_MAX_PRIM_VERTEX 8000
 
-primEntryStruct primTable[NUM_MAX_PRIM_ENTRY];
+RENDER_CONTEXT primEntryStruct primTable[NUM_MAX_PRIM_ENTRY];
+RENDER_CONTEXT rendererPointStruct primVertices[NUM_MAX_PRIM_VERTEX];
 
-u32 positionInPrimEntry = 0;
+RENDER_CONTEXT u32 positionInPrimEntry = 0;
+RENDER_CONTEXT u32 positionInPrimVertex = 0;
 
-int BBox3D1=0;
-int BBox3D2=0;
-int BBox3D3=0;
-int BBox3D4=0;
+static RENDER_CONTEXT int objectBatchDepth = 0;
+static RENDER_CONTEXT u32 objectFlushSerial = 0; // counts the FlushObjects, for FlushObjectsBefore
+static u32 objectBatchSerial = 1; // counts the batches of the game thread, for PrepareActors
 
-int renderVar1=0;
+RENDER_CONTEXT int BBox3D1=0;
+RENDER_CONTEXT int BBox3D2=0;
+RENDER_CONTEXT int BBox3D3=0;
+RENDER_CONTEXT int BBox3D4=0;
 
-int numOfPrimitiveToRender=0;
+RENDER_CONTEXT int renderVar1=0;
+
+RENDER_CONTEXT int numOfPrimitiveToRender=0;
+
+bool cullBackFaces = true;
+bool cullOffScreen = true;
+RENDER_CONTEXT primCullStatsStruct primCullStats;
 
 #ifdef DREAMCAST
 static uint64_t s_dc_rdbg_next_ms = 0;
@@ -75,52 +89,69 @@ static int s_dc_rdbg_aff_calls = 0;
 static int s_dc_rdbg_prims_total = 0;
 static int s_dc_rdbg_prims_kept = 0;
 static int s_dc_rdbg_prims_culled_depth = 0;
+static int s_dc_rdbg_prims_culled_back = 0;
+static int s_dc_rdbg_prims_culled_offscreen = 0;
 #endif
 
-char renderBuffer[3261];
+RENDER_CONTEXT char renderBuffer[3261];
 
-char* renderVar2=NULL;
+RENDER_CONTEXT char* renderVar2=NULL;
 
-int modelFlags = 0;
+RENDER_CONTEXT int modelFlags = 0;
 
-int modelCosAlpha;
-int modelSinAlpha;
-int modelCosBeta;
-int modelSinBeta;
-int modelCosGamma;
-int modelSinGamma;
+RENDER_CONTEXT int modelCosAlpha;
+RENDER_CONTEXT int modelSinAlpha;
+RENDER_CONTEXT int modelCosBeta;
+RENDER_CONTEXT int modelSinBeta;
+RENDER_CONTEXT int modelCosGamma;
+RENDER_CONTEXT int modelSinGamma;
 
-bool noModelRotation;
+RENDER_CONTEXT bool noModelRotation;
 
-int renderX;
-int renderY;
-int renderZ;
+RENDER_CONTEXT int renderX;
+RENDER_CONTEXT int renderY;
+RENDER_CONTEXT int renderZ;
 
-int numOfPoints;
-int numOfBones;
+RENDER_CONTEXT int numOfPoints;
+RENDER_CONTEXT int numOfBones;
 
-std::array<point3dStruct, NUM_MAX_POINT_IN_POINT_BUFFER> pointBuffer;
-s16 cameraSpaceBuffer[NUM_MAX_POINT_IN_POINT_BUFFER*3];
-s16 bonesBuffer[NUM_MAX_BONES];
+RENDER_CONTEXT std::array<point3dStruct, NUM_MAX_POINT_IN_POINT_BUFFER> pointBuffer;
+RENDER_CONTEXT s16 bonesBuffer[NUM_MAX_BONES];
 
-bool boneRotateX;
-bool boneRotateY;
-bool boneRotateZ;
+// Bone rotation set up by InitGroupeRot
+struct groupRotationStruct
+{
+    bool x;
+    bool y;
+    bool z;
+
+    int xCos;
+    int xSin;
+    int yCos;
+    int ySin;
+    int zCos;
+    int zSin;
+};
 
-int boneRotateXCos;
-int boneRotateXSin;
-int boneRotateYCos;
-int boneRotateYSin;
-int boneRotateZCos;
-int boneRotateZSin;
+RENDER_CONTEXT groupRotationStruct boneRotation;
 
-char primBuffer[30000];
+// What a group's pose does this frame to the vertices it reaches, see
+// poseGroupVertices
+struct groupPoseStruct
+{
+    s16 type; // 1 translates, 2 zooms the group's own vertices, 0 neither
+    int deltaX;
+    int deltaY;
+    int deltaZ;
+    bool rotate;
+    groupRotationStruct rotation;
+};
 
-int renderVar3;
+static RENDER_CONTEXT std::array<groupPoseStruct, NUM_MAX_BONES> groupPoses;
 
-#ifndef AITD_UE4
-void fillpoly(s16 * datas, int n, char c);
-#endif
+RENDER_CONTEXT char primBuffer[30000];
+
+RENDER_CONTEXT int renderVar3;
 
 /*
 
@@ -192,81 +223,104 @@ void transformPoint(float* ax, float* bx, float* cx)
     *cx = (float)z;
 }
 
-void InitGroupeRot(int transX,int transY,int transZ)
+static void initGroupRotation(groupRotationStruct& rotation, int transX, int transY, int transZ)
 {
     if(transX)
     {
-        boneRotateXCos = cosTable[transX&0x3FF];
-        boneRotateXSin = cosTable[(transX+0x100)&0x3FF];
+        rotation.xCos = cosTable[transX&0x3FF];
+        rotation.xSin = cosTable[(transX+0x100)&0x3FF];
 
-        boneRotateX = true;
+        rotation.x = true;
     }
     else
     {
-        boneRotateX = false;
+        rotation.x = false;
     }
 
     if(transY)
     {
-        boneRotateYCos = cosTable[transY&0x3FF];
-        boneRotateYSin = cosTable[(transY+0x100)&0x3FF];
+        rotation.yCos = cosTable[transY&0x3FF];
+        rotation.ySin = cosTable[(transY+0x100)&0x3FF];
 
-        boneRotateY = true;
+        rotation.y = true;
     }
     else
     {
-        boneRotateY = false;
+        rotation.y = false;
     }
 
     if(transZ)
     {
-        boneRotateZCos = cosTable[transZ&0x3FF];
-        boneRotateZSin = cosTable[(transZ+0x100)&0x3FF];
+        rotation.zCos = cosTable[transZ&0x3FF];
+        rotation.zSin = cosTable[(transZ+0x100)&0x3FF];
 
-        boneRotateZ = true;
+        rotation.z = true;
     }
     else
     {
-        boneRotateZ = false;
+        rotation.z = false;
     }
 }
 
-void RotateList(point3dStruct* pointPtr, int numOfPoint)
+void InitGroupeRot(int transX,int transY,int transZ)
 {
-    for(int i=0;i<numOfPoint;i++)
+    initGroupRotation(boneRotation, transX, transY, transZ);
+}
+
+static inline void rotatePoint(point3dStruct& point, const groupRotationStruct& rotation)
+{
+    int x = point.x;
+    int y = point.y;
+    int z = point.z;
+
+    if(rotation.y)
     {
-        point3dStruct& point = pointPtr[i];
-        int x = point.x;
-        int y = point.y;
-        int z = point.z;
+        int tempX = x;
+        int tempZ = z;
+        x = ((((tempX * rotation.ySin) - (tempZ * rotation.yCos)))>>16)<<1;
+        z = ((((tempX * rotation.yCos) + (tempZ * rotation.ySin)))>>16)<<1;
+    }
 
-        if(boneRotateY)
-        {
-            int tempX = x;
-            int tempZ = z;
-            x = ((((tempX * boneRotateYSin) - (tempZ * boneRotateYCos)))>>16)<<1;
-            z = ((((tempX * boneRotateYCos) + (tempZ * boneRotateYSin)))>>16)<<1;
-        }
+    if(rotation.x)
+    {
+        int tempY = y;
+        int tempZ = z;
+        y = ((((tempY * rotation.xSin ) - (tempZ * rotation.xCos)))>>16)<<1;
+        z = ((((tempY * rotation.xCos ) + (tempZ * rotation.xSin)))>>16)<<1;
+    }
 
-        if(boneRotateX)
-        {
-            int tempY = y;
-            int tempZ = z;
-            y = ((((tempY * boneRotateXSin ) - (tempZ * boneRotateXCos)))>>16)<<1;
-            z = ((((tempY * boneRotateXCos ) + (tempZ * boneRotateXSin)))>>16)<<1;
-        }
+    if(rotation.z)
+    {
+        int tempX = x;
+        int tempY = y;
+        x = ((((tempX * rotation.zSin) - ( tempY * rotation.zCos)))>>16)<<1;
+        y = ((((tempX * rotation.zCos) + ( tempY * rotation.zSin)))>>16)<<1;
+    }
+
+    point.x = x;
+    point.y = y;
+    point.z = z;
+}
 
-		if(boneRotateZ)
-		{
-			int tempX = x;
-			int tempY = y;
-			x = ((((tempX * boneRotateZSin) - ( tempY * boneRotateZCos)))>>16)<<1;
-			y = ((((tempX * boneRotateZCos) + ( tempY * boneRotateZSin)))>>16)<<1;
-		}
+static inline void translatePoint(point3dStruct& point, int transX, int transY, int transZ)
+{
+    point.x += transX;
+    point.y += transY;
+    point.z += transZ;
+}
+
+static inline void zoomPoint(point3dStruct& point, int zoomX, int zoomY, int zoomZ)
+{
+    point.x = (point.x * (zoomX + 256)) / 256;
+    point.y = (point.y * (zoomY + 256)) / 256;
+    point.z = (point.z * (zoomZ + 256)) / 256;
+}
 
-        point.x = x;
-        point.y = y;
-        point.z = z;
+void RotateList(point3dStruct* pointPtr, int numOfPoint)
+{
+    for(int i=0;i<numOfPoint;i++)
+    {
+        rotatePoint(pointPtr[i], boneRotation);
     }
 }
 
@@ -309,10 +363,7 @@ void TranslateGroupe(int transX, int transY, int transZ, sGroup* ptr)
 {
     for (int i = 0; i < ptr->m_numVertices; i++)
     {
-        point3dStruct& point = pointBuffer[ptr->m_start + i];
-        point.x += transX;
-        point.y += transY;
-        point.z += transZ;
+        translatePoint(pointBuffer[ptr->m_start + i], transX, transY, transZ);
     }
 }
 
@@ -320,15 +371,163 @@ void ZoomGroupe(int zoomX, int zoomY, int zoomZ, sGroup* ptr)
 {
     for (int i = 0; i < ptr->m_numVertices; i++)
     {
-        point3dStruct& point = pointBuffer[ptr->m_start + i];
-        point.x = (point.x * (zoomX + 256)) / 256;
-        point.y = (point.y * (zoomY + 256)) / 256;
-        point.z = (point.z * (zoomZ + 256)) / 256;
+        zoomPoint(pointBuffer[ptr->m_start + i], zoomX, zoomY, zoomZ);
+    }
+}
+
+// Sets up groupPoses from the groups' state in pPose, the way the group loop
+// of AnimateCloud would apply it
+static void initGroupPoses(sBody* pBody, const sPoseInstance* pPose)
+{
+    for (int i = 0; i < pBody->m_groups.size(); i++)
+    {
+        const sGroup& group = pBody->m_groups[i];
+        const sGroupState& state = pPose->m_groups[i];
+        groupPoseStruct& pose = groupPoses[i];
+
+        bool hasDelta = state.m_delta.x || state.m_delta.y || state.m_delta.z;
+
+        pose.type = (hasDelta && (state.m_type == 1 || state.m_type == 2)) ? state.m_type : 0;
+        pose.deltaX = state.m_delta.x;
+        pose.deltaY = state.m_delta.y;
+        pose.deltaZ = state.m_delta.z;
+
+        if (pBody->m_flags & INFO_OPTIMISE)
+        {
+            if (state.m_hasRotateDelta)
+                initGroupRotation(pose.rotation, state.m_rotateDelta.x, state.m_rotateDelta.y, state.m_rotateDelta.z);
+            else
+                initGroupRotation(pose.rotation, 0, 0, 0);
+
+            pose.rotate = group.m_numGroup && (pose.rotation.x || pose.rotation.y || pose.rotation.z);
+        }
+        else
+        {
+            initGroupRotation(pose.rotation, pose.deltaX, pose.deltaY, pose.deltaZ);
+
+            pose.rotate = hasDelta && state.m_type == 0;
+        }
+    }
+}
+
+// Applies to the vertices of a group, in order, every pose on its chain: its
+// own translation or zoom, and its own and its parents' rotations.
+static void poseGroupVertices(sBody* pBody, int group, point3dStruct* points, int numPoints)
+{
+    const sGroupLink& link = pBody->m_groupLinks[group];
+    for (int i = 0; i < link.m_chainSize; i++)
+    {
+        int posed = pBody->m_groupChains[link.m_chainStart + i];
+        const groupPoseStruct pose = groupPoses[posed];
+
+        if (posed == group)
+        {
+            if (pose.type == 1)
+            {
+                for (int j = 0; j < numPoints; j++)
+                    translatePoint(points[j], pose.deltaX, pose.deltaY, pose.deltaZ);
+            }
+            else if (pose.type == 2)
+            {
+                for (int j = 0; j < numPoints; j++)
+                    zoomPoint(points[j], pose.deltaX, pose.deltaY, pose.deltaZ);
+            }
+        }
+
+        if (pose.rotate)
+        {
+            for (int j = 0; j < numPoints; j++)
+                rotatePoint(points[j], pose.rotation);
+        }
+    }
+}
+
+static inline point3dStruct bodyVertex(sBody* pBody, int vertex)
+{
+    point3dStruct point;
+    point.x = pBody->m_vertices.x[vertex];
+    point.y = pBody->m_vertices.y[vertex];
+    point.z = pBody->m_vertices.z[vertex];
+    return point;
+}
+
+// Poses a body whose groups are disjoint one group at a time, in place in
+// pointBuffer: same result as the group loop of AnimateCloud followed by its
+// base vertex loop, without rescanning the hierarchy or the whole buffer.
+static void poseFlatGroups(sBody* pBody, const sPoseInstance* pPose)
+{
+    initGroupPoses(pBody, pPose);
+
+    for (int i = 0; i < pBody->m_groups.size(); i++)
+    {
+        const sGroup& group = pBody->m_groups[i];
+        const int baseGroup = pBody->m_groupLinks[i].m_baseGroup;
+        point3dStruct* points = pointBuffer.data() + group.m_start;
+
+        poseGroupVertices(pBody, i, points, group.m_numVertices);
+
+        // the base vertex as the base vertex loop would read it: final once
+        // its group went through that loop, only posed before, untouched
+        // outside of any group
+        point3dStruct base;
+        if (baseGroup > i)
+        {
+            base = bodyVertex(pBody, group.m_baseVertices);
+            poseGroupVertices(pBody, baseGroup, &base, 1);
+        }
+        else
+        {
+            base = pointBuffer[group.m_baseVertices];
+        }
+
+        for (int j = 0; j < group.m_numVertices; j++)
+        {
+            translatePoint(points[j], base.x, base.y, base.z);
+
+            if (group.m_start + j == group.m_baseVertices)
+                base = points[j];
+        }
     }
 }
 
-static int AnimateCloud(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
+// Camera and projection state for projectVertices
+static void initProjectParams(projectParamsStruct& params, bool cloud)
 {
+    params.renderX = renderX;
+    params.renderY = renderY;
+    params.renderZ = renderZ;
+    params.translateY = translateY;
+
+    params.useX = transformUseX;
+    params.useY = transformUseY;
+    params.useZ = transformUseZ;
+    params.xSin = transformXSin;
+    params.xCos = transformXCos;
+    params.ySin = transformYSin;
+    params.yCos = transformYCos;
+    params.zSin = transformZSin;
+    params.zCos = transformZCos;
+
+    params.fovX = (float)cameraFovX;
+    params.fovY = (float)cameraFovY;
+    params.centerX = (float)cameraCenterX;
+    params.centerY = (float)cameraCenterY;
+    params.perspective = (float)cameraPerspective;
+
+    params.cloud = cloud;
+}
+
+// The pose of the objects displayed without one: the body's own, as loaded
+static RENDER_CONTEXT sPoseInstance bodyPose;
+
+static int AnimateCloud(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody, sPoseInstance* pPose)
+{
+    if (!pPose)
+    {
+        pPose = &bodyPose;
+        InitPose(pPose, pBody);
+    }
+
     renderX = x - translateX;
     renderY = y;
     renderZ = z - translateZ;
@@ -337,40 +536,57 @@ static int AnimateCloud(int x,int y,int z,int alpha,int beta,int gamma, sBody* p
 
     for (int i = 0; i < pBody->m_vertices.size(); i++)
     {
-        pointBuffer[i] = pBody->m_vertices[i];
+        pointBuffer[i].x = pBody->m_vertices.x[i];
+        pointBuffer[i].y = pBody->m_vertices.y[i];
+        pointBuffer[i].z = pBody->m_vertices.z[i];
     }
 
     numOfPoints = pBody->m_vertices.size();
     numOfBones = pBody->m_groupOrder.size();
     ASSERT(numOfBones<NUM_MAX_BONES);
 
-    if(pBody->m_flags & INFO_OPTIMISE)
+    // overlapping or malformed groups keep the group by group passes below
+    const bool flatGroups = pBody->m_flatGroups && pBody->m_groups.size() <= NUM_MAX_BONES;
+
+    if(flatGroups)
+    {
+        if(!(pBody->m_flags & INFO_OPTIMISE))
+        {
+            pPose->m_groups[0].m_delta.x = alpha;
+            pPose->m_groups[0].m_delta.y = beta;
+            pPose->m_groups[0].m_delta.z = gamma;
+        }
+
+        poseFlatGroups(pBody, pPose);
+    }
+    else if(pBody->m_flags & INFO_OPTIMISE)
     {
         for(int i=0;i<pBody->m_groupOrder.size();i++)
         {
             int boneDataOffset = pBody->m_groupOrder[i];
             sGroup* pGroup = &pBody->m_groups[pBody->m_groupOrder[i]];
+            const sGroupState* pState = &pPose->m_groups[pBody->m_groupOrder[i]];
 
-            switch(pGroup->m_state.m_type)
+            switch(pState->m_type)
             {
             case 1:
-                if(pGroup->m_state.m_delta.x || pGroup->m_state.m_delta.y || pGroup->m_state.m_delta.z)
+                if(pState->m_delta.x || pState->m_delta.y || pState->m_delta.z)
                 {
-                    TranslateGroupe(pGroup->m_state.m_delta.x, pGroup->m_state.m_delta.y, pGroup->m_state.m_delta.z, pGroup);
+                    TranslateGroupe(pState->m_delta.x, pState->m_delta.y, pState->m_delta.z, pGroup);
                 }
                 break;
             case 2:
-                if (pGroup->m_state.m_delta.x || pGroup->m_state.m_delta.y || pGroup->m_state.m_delta.z)
+                if (pState->m_delta.x || pState->m_delta.y || pState->m_delta.z)
                 {
-                    ZoomGroupe(pGroup->m_state.m_delta.x, pGroup->m_state.m_delta.y, pGroup->m_state.m_delta.z, pGroup);
+                    ZoomGroupe(pState->m_delta.x, pState->m_delta.y, pState->m_delta.z, pGroup);
                 }
                 break;
             }
 
-            if (pGroup->m_state.m_hasRotateDelta)
-                InitGroupeRot(pGroup->m_state.m_rotateDelta.x,
-                             pGroup->m_state.m_rotateDelta.y,
-                             pGroup->m_state.m_rotateDelta.z);
+            if (pState->m_hasRotateDelta)
+                InitGroupeRot(pState->m_rotateDelta.x,
+                             pState->m_rotateDelta.y,
+                             pState->m_rotateDelta.z);
             else
                 InitGroupeRot(0, 0, 0);
             RotateGroupeOptimise(pGroup);
@@ -378,22 +594,23 @@ static int AnimateCloud(int x,int y,int z,int alpha,int beta,int gamma, sBody* p
     }
     else
     {
-        pBody->m_groups[0].m_state.m_delta.x = alpha;
-        pBody->m_groups[0].m_state.m_delta.y = beta;
-        pBody->m_groups[0].m_state.m_delta.z = gamma;
+        pPose->m_groups[0].m_delta.x = alpha;
+        pPose->m_groups[0].m_delta.y = beta;
+        pPose->m_groups[0].m_delta.z = gamma;
 
         for(int i=0;i<pBody->m_groups.size();i++)
         {
             int boneDataOffset = pBody->m_groupOrder[i];
             sGroup* pGroup = &pBody->m_groups[pBody->m_groupOrder[i]];
+            const sGroupState* pState = &pPose->m_groups[pBody->m_groupOrder[i]];
 
-            int transX = pGroup->m_state.m_delta.x;
-            int transY = pGroup->m_state.m_delta.y;
-            int transZ = pGroup->m_state.m_delta.z;
+            int transX = pState->m_delta.x;
+            int transY = pState->m_delta.y;
+            int transZ = pState->m_delta.z;
 
             if(transX || transY || transZ)
             {
-                switch(pGroup->m_state.m_type)
+                switch(pState->m_type)
                 {
                 case 0:
                     { 
@@ -416,7 +633,7 @@ static int AnimateCloud(int x,int y,int z,int alpha,int beta,int gamma, sBody* p
         }
     }
 
-    for(int i=0;i<pBody->m_groups.size();i++)
+    for(int i=0;!flatGroups && i<pBody->m_groups.size();i++)
     {
         sGroup* pGroup = &pBody->m_groups[i];
         for(int j=0;j< pGroup->m_numVertices;j++)
@@ -433,127 +650,43 @@ static int AnimateCloud(int x,int y,int z,int alpha,int beta,int gamma, sBody* p
         RotateList(pointBuffer.data(),numOfPoints);
     }
 
-    {
-        s16* outPtr = cameraSpaceBuffer;
-        for(int i=0;i<numOfPoints;i++)
-        {
-            float X = pointBuffer[i].x;
-            float Y = pointBuffer[i].y;
-            float Z = pointBuffer[i].z;
-
-
-            X += renderX;
-            Y += renderY;
-            Z += renderZ;
-
 #if defined(AITD_UE4)
-            *(outPtr++) = (s16)X;
-            *(outPtr++) = (s16)Y;
-            *(outPtr++) = (s16)Z;
+    for(int i=0;i<numOfPoints;i++)
+    {
+        renderPointList[i * 3 + 0] = (s16)(pointBuffer[i].x + renderX);
+        renderPointList[i * 3 + 1] = (s16)(pointBuffer[i].y + renderY);
+        renderPointList[i * 3 + 2] = (s16)(pointBuffer[i].z + renderZ);
+    }
 #else
-            if(Y>10000) // height clamp
-            {
-                *(outPtr++) = -10000;
-                *(outPtr++) = -10000;
-                *(outPtr++) = -10000;
-            }
-            else
-            {
-                Y -= translateY;
-
-                transformPoint(&X,&Y,&Z);
-
-                *(outPtr++) = (s16)X;
-                *(outPtr++) = (s16)Y;
-                *(outPtr++) = (s16)Z;
-            }
-#endif
-        }
-
-        s16* ptr = cameraSpaceBuffer;
-        float* outPtr2 = renderPointList;
-
+    {
     #ifdef DREAMCAST
         // Make sure SH-4 fmath ops stay in single precision for consistency/speed.
         uint32_t old_fpscr = fitd_fpscr_force_single();
     #endif
 
-        int k = numOfPoints;
-        do
-        {
-            float X;
-            float Y;
-            float Z;
-
-            X = ptr[0];
-            Y = ptr[1];
-            Z = ptr[2];
-            ptr+=3;
-
-#if defined(AITD_UE4)
-            *(outPtr2++) = X;
-            *(outPtr2++) = Y;
-            *(outPtr2++) = Z;
-#else
-            Z += cameraPerspective;
-
-            if( Z<=50 ) // clipping
-            {
-                *(outPtr2++) = -10000;
-                *(outPtr2++) = -10000;
-                *(outPtr2++) = -10000;
-            }
-            else
-            {
-                const float invZ = fitd_rcpf_fast(Z);
-                float transformedX = (X * cameraFovX * invZ) + cameraCenterX;
-                float transformedY;
-
-                *(outPtr2++) = transformedX;
-
-                if(transformedX < BBox3D1)
-                    BBox3D1 = (int)transformedX;
-
-                if(transformedX > BBox3D3)
-                    BBox3D3 = (int)transformedX;
+        projectParamsStruct params;
+        initProjectParams(params, true);
 
-                transformedY = (Y * cameraFovY * invZ) + cameraCenterY;
-
-                *(outPtr2++) = transformedY;
-
-                if(transformedY < BBox3D2)
-                    BBox3D2 = (int)transformedY;
-
-                if(transformedY > BBox3D4)
-                    BBox3D4 = (int)transformedY;
-
-                *(outPtr2++) = Z; 
-            }
-#endif
-
-            k--;
-            if(k==0)
-            {
-#ifdef DREAMCAST
-                fitd_fpscr_restore(old_fpscr);
-#endif
-                return(1);
-            }
-
-        }while(renderVar1 == 0);
+        projectBBoxStruct bbox = { BBox3D1, BBox3D2, BBox3D3, BBox3D4 };
+        projectVertices(params, &pointBuffer[0].x, &pointBuffer[0].y, &pointBuffer[0].z, 3, numOfPoints, renderPointList, bbox);
+        BBox3D1 = bbox.x1;
+        BBox3D2 = bbox.y1;
+        BBox3D3 = bbox.x2;
+        BBox3D4 = bbox.y2;
 
     #ifdef DREAMCAST
         fitd_fpscr_restore(old_fpscr);
     #endif
     }
+#endif
 
-    return(0);
+    return(1);
 }
 
 // Compatibility wrapper (old French name).
-int AnimNuage(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
+int AnimNuage(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody, sPoseInstance* pPose)
 {
-    return AnimateCloud(x,y,z,alpha,beta,gamma, pBody);
+    return AnimateCloud(x,y,z,alpha,beta,gamma, pBody, pPose);
 }
 
 /*
@@ -565,8 +698,6 @@ z - cameraZ
 
 static int RotateAndProjectBody(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
 {
-    float* outPtr;
-
 #if !defined(AITD_UE4) && defined(DREAMCAST)
     uint32_t old_fpscr = fitd_fpscr_force_single();
 #endif
@@ -593,7 +724,9 @@ static int RotateAndProjectBody(int x,int y,int z,int alpha,int beta,int gamma,
         modelSinGamma = cosTable[(gamma+0x100)&0x3FF];
     }
 
-    outPtr = renderPointList;
+    // the other builds project through projectVertices
+#if defined(DREAMCAST) || defined(AITD_UE4)
+    float* outPtr = renderPointList;
 
     // Cache frequently-used globals into locals for the hot loop.
     const float fovX = cameraFovX;
@@ -723,6 +856,7 @@ static int RotateAndProjectBody(int x,int y,int z,int alpha,int beta,int gamma,
         }
 #endif
     };
+#endif
 
 #if defined(DREAMCAST) && !defined(AITD_UE4)
     if (!noModelRotation)
@@ -746,12 +880,15 @@ static int RotateAndProjectBody(int x,int y,int z,int alpha,int beta,int gamma,
         const vec2 cA = { cA0, cA0 };
 
         const int n = (int)pBody->m_vertices.size();
+        const s16* vertexX = pBody->m_vertices.x;
+        const s16* vertexY = pBody->m_vertices.y;
+        const s16* vertexZ = pBody->m_vertices.z;
         int i = 0;
         for (; i + 1 < n; i += 2)
         {
-            vec2 X = { (float)pBody->m_vertices[i + 0].x, (float)pBody->m_vertices[i + 1].x };
-            vec2 Y = { (float)pBody->m_vertices[i + 0].y, (float)pBody->m_vertices[i + 1].y };
-            vec2 Z = { (float)pBody->m_vertices[i + 0].z, (float)pBody->m_vertices[i + 1].z };
+            vec2 X = { (float)vertexX[i + 0], (float)vertexX[i + 1] };
+            vec2 Y = { (float)vertexY[i + 0], (float)vertexY[i + 1] };
+            vec2 Z = { (float)vertexZ[i + 0], (float)vertexZ[i + 1] };
 
             // Y rotation
             {
@@ -788,9 +925,9 @@ static int RotateAndProjectBody(int x,int y,int z,int alpha,int beta,int gamma,
         // Tail
         for (; i < n; i++)
         {
-            float X = pBody->m_vertices[i].x;
-            float Y = pBody->m_vertices[i].y;
-            float Z = pBody->m_vertices[i].z;
+            float X = vertexX[i];
+            float Y = vertexY[i];
+            float Z = vertexZ[i];
 
             // Scalar fallback for last vertex
             {
@@ -818,13 +955,26 @@ static int RotateAndProjectBody(int x,int y,int z,int alpha,int beta,int gamma,
     else
 #endif
     {
-        for(int i=0; i<pBody->m_vertices.size(); i++)
+#if defined(AITD_UE4)
+        const int n = (int)pBody->m_vertices.size();
+        const s16* vertexX = pBody->m_vertices.x;
+        const s16* vertexY = pBody->m_vertices.y;
+        const s16* vertexZ = pBody->m_vertices.z;
+        for(int i=0; i<n; i++)
         {
-            float X = pBody->m_vertices[i].x;
-            float Y = pBody->m_vertices[i].y;
-            float Z = pBody->m_vertices[i].z;
-            emitProjectedVertex(X, Y, Z);
+            emitProjectedVertex(vertexX[i], vertexY[i], vertexZ[i]);
         }
+#else
+        projectParamsStruct params;
+        initProjectParams(params, false);
+
+        projectBBoxStruct bbox = { BBox3D1, BBox3D2, BBox3D3, BBox3D4 };
+        projectVertices(params, pBody->m_vertices.x, pBody->m_vertices.y, pBody->m_vertices.z, 1, pBody->m_vertices.size(), renderPointList, bbox);
+        BBox3D1 = bbox.x1;
+        BBox3D2 = bbox.y1;
+        BBox3D3 = bbox.x2;
+        BBox3D4 = bbox.y2;
+#endif
     }
 
 #if !defined(AITD_UE4) && defined(DREAMCAST)
@@ -848,12 +998,72 @@ void primFunctionDefault(int primType,char** ptr,char** out)
     assert(0);
 }
 
+// Back facing the way the bgfx renderer culls (CULL_CCW, once flat_vs flips
+// Y): every triangle of osystem_fillPoly's fan is clockwise or flat on screen.
+static bool isBackFacing(const primEntryStruct* pEntry)
+{
+    const rendererPointStruct* v = pEntry->vertices;
+    for (int i = 2; i < pEntry->numOfVertices; i++)
+    {
+        float cross = (v[i - 1].X - v[0].X) * (v[i].Y - v[0].Y) - (v[i - 1].Y - v[0].Y) * (v[i].X - v[0].X);
+        if (cross > 0.f)
+            return false;
+    }
+    return true;
+}
+
+// Against the whole screen: SetClip doesn't clip objects, and is left on the
+// last actor's box by drawBgOverlay
+static bool isOffScreen(const primEntryStruct* pEntry)
+{
+    const rendererPointStruct* v = pEntry->vertices;
+    float minX = v[0].X;
+    float maxX = v[0].X;
+    float minY = v[0].Y;
+    float maxY = v[0].Y;
+    for (int i = 1; i < pEntry->numOfVertices; i++)
+    {
+        minX = std::min(minX, v[i].X);
+        maxX = std::max(maxX, v[i].X);
+        minY = std::min(minY, v[i].Y);
+        maxY = std::max(maxY, v[i].Y);
+    }
+    return maxX < 0 || minX > 319 || maxY < 0 || minY > 199;
+}
+
+// Optional rejection of lines and polygons that would draw nothing, before
+// they are sorted and sent to the osystem
+static bool isPrimitiveCulled(const primEntryStruct* pEntry)
+{
+    if (cullBackFaces && pEntry->type == primTypeEnum_Poly && isBackFacing(pEntry))
+    {
+        primCullStats.backFacing++;
+#ifdef DREAMCAST
+        s_dc_rdbg_prims_culled_back++;
+#endif
+        return true;
+    }
+
+    if (cullOffScreen && isOffScreen(pEntry))
+    {
+        primCullStats.offScreen++;
+#ifdef DREAMCAST
+        s_dc_rdbg_prims_culled_offscreen++;
+#endif
+        return true;
+    }
+
+    primCullStats.kept++;
+    return false;
+}
+
 void processPrim_Line(int primType, sPrimitive* ptr, char** out)
 {
     primEntryStruct* pCurrentPrimEntry = &primTable[positionInPrimEntry];
 
     ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
 
+    pCurrentPrimEntry->vertices = primVertices + positionInPrimVertex;
     pCurrentPrimEntry->type = primTypeEnum_Line;
     pCurrentPrimEntry->numOfVertices = 2;
     pCurrentPrimEntry->color = ptr->m_color;
@@ -883,14 +1093,17 @@ void processPrim_Line(int primType, sPrimitive* ptr, char** out)
     pCurrentPrimEntry->sortDepth = depth;
 
 #if !defined(AITD_UE4)
+#ifdef DREAMCAST
     s_dc_rdbg_prims_total++;
-    if (depth > 100)
+#endif
+    if (depth > 100 && !isPrimitiveCulled(pCurrentPrimEntry))
 #endif
     {
 #ifdef DREAMCAST
         s_dc_rdbg_prims_kept++;
 #endif
         positionInPrimEntry++;
+        positionInPrimVertex += pCurrentPrimEntry->numOfVertices;
 
         numOfPrimitiveToRender++;
         ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
@@ -899,7 +1112,8 @@ void processPrim_Line(int primType, sPrimitive* ptr, char** out)
     else
     {
 #ifdef DREAMCAST
-        s_dc_rdbg_prims_culled_depth++;
+        if (depth <= 100)
+            s_dc_rdbg_prims_culled_depth++;
 #endif
     }
 #endif
@@ -911,8 +1125,9 @@ void processPrim_Poly(int primType, sPrimitive* ptr, char** out)
 
     ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
 
+    pCurrentPrimEntry->vertices = primVertices + positionInPrimVertex;
     pCurrentPrimEntry->type = primTypeEnum_Poly;
-    pCurrentPrimEntry->numOfVertices = ptr->m_points.size();
+    pCurrentPrimEntry->numOfVertices = ptr->m_numPoints;
     pCurrentPrimEntry->color = ptr->m_color;
     pCurrentPrimEntry->material = ptr->m_material;
 
@@ -939,14 +1154,17 @@ void processPrim_Poly(int primType, sPrimitive* ptr, char** out)
     pCurrentPrimEntry->sortDepth = depth;
 
 #if !defined(AITD_UE4)
+#ifdef DREAMCAST
     s_dc_rdbg_prims_total++;
-    if (depth > 100)
+#endif
+    if (depth > 100 && !isPrimitiveCulled(pCurrentPrimEntry))
 #endif
     {
 #ifdef DREAMCAST
         s_dc_rdbg_prims_kept++;
 #endif
         positionInPrimEntry++;
+        positionInPrimVertex += pCurrentPrimEntry->numOfVertices;
 
         numOfPrimitiveToRender++;
         ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
@@ -955,7 +1173,8 @@ void processPrim_Poly(int primType, sPrimitive* ptr, char** out)
     else
     {
 #ifdef DREAMCAST
-        s_dc_rdbg_prims_culled_depth++;
+        if (depth <= 100)
+            s_dc_rdbg_prims_culled_depth++;
 #endif
     }
 #endif
@@ -967,6 +1186,7 @@ void processPrim_Point(primTypeEnum primType, sPrimitive* ptr, char** out)
 
     ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
 
+    pCurrentPrimEntry->vertices = primVertices + positionInPrimVertex;
     pCurrentPrimEntry->type = primType;
     pCurrentPrimEntry->numOfVertices = 1;
     pCurrentPrimEntry->color = ptr->m_color;
@@ -987,7 +1207,9 @@ void processPrim_Point(primTypeEnum primType, sPrimitive* ptr, char** out)
     pCurrentPrimEntry->sortDepth = depth;
 
 #if !defined(AITD_UE4)
+#ifdef DREAMCAST
     s_dc_rdbg_prims_total++;
+#endif
     if (depth > 100)
 #endif
     {
@@ -995,6 +1217,7 @@ void processPrim_Point(primTypeEnum primType, sPrimitive* ptr, char** out)
         s_dc_rdbg_prims_kept++;
 #endif
         positionInPrimEntry++;
+        positionInPrimVertex += pCurrentPrimEntry->numOfVertices;
 
         numOfPrimitiveToRender++;
         ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
@@ -1015,6 +1238,7 @@ void processPrim_Sphere(int primType, sPrimitive* ptr, char** out)
 
     ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
 
+    pCurrentPrimEntry->vertices = primVertices + positionInPrimVertex;
     pCurrentPrimEntry->type = primTypeEnum_Sphere;
     pCurrentPrimEntry->numOfVertices = 1;
     pCurrentPrimEntry->color = ptr->m_color;
@@ -1036,7 +1260,9 @@ void processPrim_Sphere(int primType, sPrimitive* ptr, char** out)
     pCurrentPrimEntry->sortDepth = depth;
 
 #if !defined(AITD_UE4)
+#ifdef DREAMCAST
     s_dc_rdbg_prims_total++;
+#endif
     if (depth > 100)
 #endif
     {
@@ -1044,6 +1270,7 @@ void processPrim_Sphere(int primType, sPrimitive* ptr, char** out)
         s_dc_rdbg_prims_kept++;
 #endif
         positionInPrimEntry++;
+        positionInPrimVertex += pCurrentPrimEntry->numOfVertices;
 
         numOfPrimitiveToRender++;
         ASSERT(positionInPrimEntry < NUM_MAX_PRIM_ENTRY);
@@ -1132,15 +1359,135 @@ renderFunction renderFunctions[]={
 	renderZixel,
 };
 
-int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
+// Draw order of the pending primitives: far to near on sortDepth quantised to
+// 16 bits, equal depths in the order they were emitted. Two stable counting
+// passes over the bytes of the key.
+static u16 primSortKeys[NUM_MAX_PRIM_ENTRY];
+static u16 primSortOrder[NUM_MAX_PRIM_ENTRY];
+static u16 primSortScratch[NUM_MAX_PRIM_ENTRY];
+
+static void sortPrimitives(int numPrim)
+{
+    for (int i = 0; i < numPrim; i++)
+    {
+        float depth = primTable[i].sortDepth;
+        int quantised = depth <= 0.f ? 0 : (depth >= 65535.f ? 65535 : (int)depth);
+        primSortKeys[i] = (u16)(65535 - quantised);
+        primSortOrder[i] = (u16)i;
+    }
+
+    u16* in = primSortOrder;
+    u16* out = primSortScratch;
+    for (int shift = 0; shift < 16; shift += 8)
+    {
+        int offsets[256] = {};
+        for (int i = 0; i < numPrim; i++)
+            offsets[(primSortKeys[i] >> shift) & 0xFF]++;
+
+        int position = 0;
+        for (int i = 0; i < 256; i++)
+        {
+            int count = offsets[i];
+            offsets[i] = position;
+            position += count;
+        }
+
+        for (int i = 0; i < numPrim; i++)
+            out[offsets[(primSortKeys[in[i]] >> shift) & 0xFF]++] = in[i];
+
+        std::swap(in, out);
+    }
+    // after an even number of passes the order is back in primSortOrder
+}
+
+void FlushObjects()
+{
+    if (positionInPrimEntry)
+    {
+        sortPrimitives(positionInPrimEntry);
+
+        for (u32 i = 0; i < positionInPrimEntry; i++)
+        {
+            primEntryStruct* pEntry = &primTable[primSortOrder[i]];
+            renderFunctions[pEntry->type](pEntry);
+        }
+
+        osystem_flushPendingPrimitives();
+    }
+
+    positionInPrimEntry = 0;
+    positionInPrimVertex = 0;
+    objectFlushSerial++;
+}
+
+objectMarkStruct GetObjectMark()
+{
+    return { positionInPrimEntry, positionInPrimVertex, objectFlushSerial };
+}
+
+void FlushObjectsBefore(const objectMarkStruct& mark)
+{
+    // a FlushObjects since the mark already drew them
+    if (mark.flushSerial != objectFlushSerial || mark.primEntry == 0)
+        return;
+
+    sortPrimitives(mark.primEntry);
+
+    for (u32 i = 0; i < mark.primEntry; i++)
+    {
+        primEntryStruct* pEntry = &primTable[primSortOrder[i]];
+        renderFunctions[pEntry->type](pEntry);
+    }
+
+    osystem_flushPendingPrimitives();
+
+    // the primitives after the mark stay pending, moved to the front
+    u32 numPrimEntry = positionInPrimEntry - mark.primEntry;
+    u32 numPrimVertex = positionInPrimVertex - mark.primVertex;
+    std::copy(primTable + mark.primEntry, primTable + positionInPrimEntry, primTable);
+    std::copy(primVertices + mark.primVertex, primVertices + positionInPrimVertex, primVertices);
+    for (u32 i = 0; i < numPrimEntry; i++)
+        primTable[i].vertices -= mark.primVertex;
+
+    positionInPrimEntry = numPrimEntry;
+    positionInPrimVertex = numPrimVertex;
+}
+
+void BeginObjectBatch()
+{
+    objectBatchDepth++;
+}
+
+void EndObjectBatch()
+{
+    ASSERT(objectBatchDepth > 0);
+    if (--objectBatchDepth == 0)
+    {
+        FlushObjects();
+        objectBatchSerial++;
+    }
+}
+
+// Makes room for numPrim more primitives after the pending ones
+static void reservePrimitives(u32 numPrim, u32 numVertices)
+{
+    if (positionInPrimEntry + numPrim >= NUM_MAX_PRIM_ENTRY
+        || positionInPrimVertex + numVertices > NUM_MAX_PRIM_VERTEX)
+    {
+        FlushObjects();
+    }
+}
+
+int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody, sPoseInstance* pPose)
 {
     int numPrim;
     int i;
     char* out;
 
-    // reinit the 2 static tables
-    positionInPrimEntry = 0;
-    //
+    reservePrimitives(pBody->m_primitives.size(), pBody->m_pointIndices.size());
+
+    const u32 firstPrimEntry = positionInPrimEntry;
+    const u32 firstPrimVertex = positionInPrimVertex;
 
 #ifdef DREAMCAST
     s_dc_rdbg_aff_calls++;
@@ -1162,7 +1509,7 @@ int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
 
     if(modelFlags&INFO_ANIM)
     {
-        if(!AnimNuage(x,y,z,alpha,beta,gamma, pBody))
+        if(!AnimNuage(x,y,z,alpha,beta,gamma, pBody, pPose))
         {
             BBox3D3 = -32000;
             BBox3D4 = -32000;
@@ -1234,23 +1581,15 @@ int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
                 processPrim_Poly(primType, pPrimitive, &out);
                 break;
 			default:
+				// drop what this body already emitted
+				positionInPrimEntry = firstPrimEntry;
+				positionInPrimVertex = firstPrimVertex;
 				return 0;
 				assert(0);
 			}
 
         }
 
-        // Sort primitives by depth (painter's algorithm) to reduce poly overlap issues
-        // on renderers without a Z-buffer. Draw far -> near.
-        std::array<primEntryStruct*, NUM_MAX_PRIM_ENTRY> sorted;
-        for (i = 0; i < numOfPrimitiveToRender; i++)
-            sorted[i] = &primTable[i];
-
-        std::sort(sorted.begin(), sorted.begin() + numOfPrimitiveToRender,
-                  [](const primEntryStruct* a, const primEntryStruct* b) {
-                      return a->sortDepth > b->sortDepth;
-                  });
-
         if(!numOfPrimitiveToRender)
         {
             BBox3D3 = -32000;
@@ -1260,9 +1599,6 @@ int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
             return(1); // model ok, but out of screen
         }
 
-        for(i=0;i<numOfPrimitiveToRender;i++)
-            renderFunctions[sorted[i]->type](sorted[i]);
-
         //DEBUG
         /*  for(i=0;i<numPointInPoly;i++)
         {
@@ -1279,7 +1615,11 @@ int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
         }*/
         //
 
-        osystem_flushPendingPrimitives();
+        // Primitives are depth sorted (painter's algorithm, for renderers
+        // without a Z-buffer) and drawn by FlushObjects, together with the
+        // other objects of the batch
+        if (!objectBatchDepth)
+            FlushObjects();
 
 #ifdef DREAMCAST
         if (!DC_IsMenuActive())
@@ -1291,11 +1631,13 @@ int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
                 const int rglTris = (int)(g_rglTriVtx.size() / 3);
                 const int rglLines = (int)(g_rglLineVtx.size() / 2);
 
-                I_Printf("[dc][render] DisplayObject:%d prims:%d kept:%d culled_depth:%d rgl_tris:%d rgl_lines:%d rgl_tri_vec:%p rgl_line_vec:%p\n",
+                I_Printf("[dc][render] DisplayObject:%d prims:%d kept:%d culled_depth:%d culled_back:%d culled_offscreen:%d rgl_tris:%d rgl_lines:%d rgl_tri_vec:%p rgl_line_vec:%p\n",
                          s_dc_rdbg_aff_calls,
                          s_dc_rdbg_prims_total,
                          s_dc_rdbg_prims_kept,
                          s_dc_rdbg_prims_culled_depth,
+                         s_dc_rdbg_prims_culled_back,
+                         s_dc_rdbg_prims_culled_offscreen,
                          rglTris,
                          rglLines,
                          (void*)&g_rglTriVtx,
@@ -1304,19 +1646,289 @@ int DisplayObject(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
                 s_dc_rdbg_prims_total = 0;
                 s_dc_rdbg_prims_kept = 0;
                 s_dc_rdbg_prims_culled_depth = 0;
+                s_dc_rdbg_prims_culled_back = 0;
+                s_dc_rdbg_prims_culled_offscreen = 0;
             }
         }
 #endif
         return(0);
 }
 
+// Everything besides the body's pose that DisplayObject's result depends on
+typedef std::array<int, 28> displayCacheKey;
+
+static displayCacheKey makeDisplayCacheKey(int x, int y, int z, int alpha, int beta, int gamma)
+{
+    return displayCacheKey{
+        x, y, z, alpha, beta, gamma,
+        transformX, transformY, transformZ,
+        translateX, translateY, translateZ,
+        transformUseX, transformXSin, transformXCos,
+        transformUseY, transformYSin, transformYCos,
+        transformUseZ, transformZSin, transformZCos,
+        cameraFovX, cameraFovY, cameraCenterX, cameraCenterY, cameraPerspective,
+        cullBackFaces, cullOffScreen,
+    };
+}
+
+static bool isSameGroupState(const sGroupState& a, const sGroupState& b)
+{
+    return a.m_type == b.m_type
+        && a.m_delta.x == b.m_delta.x && a.m_delta.y == b.m_delta.y && a.m_delta.z == b.m_delta.z
+        && a.m_hasRotateDelta == b.m_hasRotateDelta
+        && (!a.m_hasRotateDelta || (a.m_rotateDelta.x == b.m_rotateDelta.x && a.m_rotateDelta.y == b.m_rotateDelta.y && a.m_rotateDelta.z == b.m_rotateDelta.z));
+}
+
+// What displaying an object leaves behind: DisplayObject's result, the
+// globals its callers read and the primitives it added
+struct displayResultStruct
+{
+    int result = 0;
+    int bbox[4] = {};
+    int numPoints = 0;
+    std::vector<point3dStruct> points; // pointBuffer of animated bodies, for getHotPoint
+    std::vector<primEntryStruct> prims;
+    std::vector<rendererPointStruct> vertices; // of prims, in order
+};
+
+// Keeps what DisplayObject just added after firstPrimEntry/firstPrimVertex
+static void storeDisplayResult(displayResultStruct& display, sBody* pBody, int result, u32 firstPrimEntry, u32 firstPrimVertex)
+{
+    display.result = result;
+    display.bbox[0] = BBox3D1;
+    display.bbox[1] = BBox3D2;
+    display.bbox[2] = BBox3D3;
+    display.bbox[3] = BBox3D4;
+    display.numPoints = numOfPoints;
+    if (pBody->m_flags & INFO_ANIM)
+        display.points.assign(pointBuffer.begin(), pointBuffer.begin() + numOfPoints);
+    else
+        display.points.clear();
+    display.prims.assign(primTable + firstPrimEntry, primTable + positionInPrimEntry);
+    display.vertices.assign(primVertices + firstPrimVertex, primVertices + positionInPrimVertex);
+}
+
+// Does what DisplayObject did again, the caller made room for the primitives
+static int replayDisplayResult(const displayResultStruct& display, sBody* pBody, sPoseInstance* pPose, int alpha, int beta, int gamma)
+{
+    rendererPointStruct* vertices = primVertices + positionInPrimVertex;
+    std::copy(display.vertices.begin(), display.vertices.end(), vertices);
+    for (const primEntryStruct& prim : display.prims)
+    {
+        primEntryStruct& out = primTable[positionInPrimEntry++];
+        out = prim;
+        out.vertices = vertices;
+        vertices += prim.numOfVertices;
+    }
+    positionInPrimVertex += display.vertices.size();
+
+    BBox3D1 = display.bbox[0];
+    BBox3D2 = display.bbox[1];
+    BBox3D3 = display.bbox[2];
+    BBox3D4 = display.bbox[3];
+    modelFlags = pBody->m_flags;
+    numOfPoints = display.numPoints;
+    std::copy(display.points.begin(), display.points.end(), pointBuffer.begin());
+
+    // as AnimateCloud does, StockInterAnim blends from these
+    if ((pBody->m_flags & INFO_ANIM) && !(pBody->m_flags & INFO_OPTIMISE) && !pPose->m_groups.empty())
+    {
+        pPose->m_groups[0].m_delta.x = alpha;
+        pPose->m_groups[0].m_delta.y = beta;
+        pPose->m_groups[0].m_delta.z = gamma;
+    }
+
+    return display.result;
+}
+
+// Last display of one ListObjets slot
+struct displayCacheEntry
+{
+    sBody* pBody = nullptr;
+    u32 bodySerial = 0;
+    displayCacheKey key = {};
+    std::vector<sGroupState> pose; // as it was before DisplayObject ran
+
+    // once the same key was displayed twice in a row
+    bool stored = false;
+    displayResultStruct display;
+};
+
+static std::array<displayCacheEntry, NUM_MAX_OBJECT> displayCache;
+
+bool displayCacheEnabled = true;
+displayCacheStatsStruct displayCacheStats;
+
+static bool isSameDisplay(const displayCacheEntry& entry, const displayCacheKey& key, sBody* pBody, const sPoseInstance* pPose)
+{
+    bool same = entry.pBody == pBody && entry.bodySerial == pBody->m_serial && entry.key == key
+        && entry.pose.size() == pPose->m_groups.size();
+    for (u32 i = 0; same && i < pPose->m_groups.size(); i++)
+        same = isSameGroupState(entry.pose[i], pPose->m_groups[i]);
+    return same;
+}
+
+// An object displayed by PrepareActors, for the DisplayActor call of the
+// same object in the same batch
+struct preparedActorStruct
+{
+    u32 batch = 0; // objectBatchSerial when prepared
+    sBody* pBody = nullptr;
+    u32 bodySerial = 0;
+    displayCacheKey key = {};
+    displayResultStruct display;
+    primCullStatsStruct cullStats;
+};
+
+static std::array<preparedActorStruct, NUM_MAX_OBJECT> preparedActors;
+
+bool prepareActorsEnabled = true;
+
+static void prepareActor(const actorDisplayStruct& actor, u32 batch)
+{
+    preparedActorStruct& prepared = preparedActors[actor.actorIdx];
+    sBody* pBody = actor.pBody;
+    sPoseInstance* pPose = GetObjectPose(actor.actorIdx, pBody);
+
+    // into this thread's primitive table, after what it may have pending
+    const u32 firstPrimEntry = positionInPrimEntry;
+    const u32 firstPrimVertex = positionInPrimVertex;
+    if (firstPrimEntry + pBody->m_primitives.size() >= NUM_MAX_PRIM_ENTRY
+        || firstPrimVertex + pBody->m_pointIndices.size() > NUM_MAX_PRIM_VERTEX)
+    {
+        return; // left to DisplayActor
+    }
+
+    const primCullStatsStruct cullStats = primCullStats;
+    primCullStats = primCullStatsStruct();
+    objectBatchDepth++; // only emit, never draw
+
+    int result = DisplayObject(actor.x, actor.y, actor.z, actor.alpha, actor.beta, actor.gamma, pBody, pPose);
+    storeDisplayResult(prepared.display, pBody, result, firstPrimEntry, firstPrimVertex);
+
+    objectBatchDepth--;
+    positionInPrimEntry = firstPrimEntry;
+    positionInPrimVertex = firstPrimVertex;
+    prepared.cullStats = primCullStats;
+    primCullStats = cullStats;
+
+    prepared.batch = batch;
+    prepared.pBody = pBody;
+    prepared.bodySerial = pBody->m_serial;
+    prepared.key = makeDisplayCacheKey(actor.x, actor.y, actor.z, actor.alpha, actor.beta, actor.gamma);
+}
+
+void PrepareActors(const actorDisplayStruct* actors, int numActors)
+{
+    ASSERT(objectBatchDepth > 0);
+
+    if (!prepareActorsEnabled || Jobs_GetNumThreads() < 2)
+        return;
+
+    // each object has its own pose, even those sharing a body
+    std::array<int, NUM_MAX_OBJECT> toPrepare;
+    int numPrepared = 0;
+
+    for (int i = 0; i < numActors && i < NUM_MAX_OBJECT; i++)
+    {
+        const actorDisplayStruct& actor = actors[i];
+
+        if (actor.actorIdx < 0 || actor.actorIdx >= NUM_MAX_OBJECT || !actor.pBody)
+            continue;
+
+        // the display cache already has it
+        const displayCacheEntry& entry = displayCache[actor.actorIdx];
+        if (displayCacheEnabled && entry.stored && isSameDisplay(entry, makeDisplayCacheKey(actor.x, actor.y, actor.z, actor.alpha, actor.beta, actor.gamma), actor.pBody, GetObjectPose(actor.actorIdx, actor.pBody)))
+            continue;
+
+        toPrepare[numPrepared++] = i;
+    }
+
+    // a single object is as fast displayed by DisplayActor
+    if (numPrepared < 2)
+        return;
+
+    const u32 batch = objectBatchSerial;
+    Jobs_Run(numPrepared, [&](int i) {
+        prepareActor(actors[toPrepare[i]], batch);
+    });
+}
+
+int DisplayActor(int actorIdx, int x, int y, int z, int alpha, int beta, int gamma, sBody* pBody)
+{
+    if (actorIdx < 0 || actorIdx >= NUM_MAX_OBJECT)
+        return DisplayObject(x, y, z, alpha, beta, gamma, pBody, nullptr);
+
+    sPoseInstance* pPose = GetObjectPose(actorIdx, pBody);
+    const displayCacheKey key = makeDisplayCacheKey(x, y, z, alpha, beta, gamma);
+    displayCacheEntry& entry = displayCache[actorIdx];
+    const bool same = displayCacheEnabled && isSameDisplay(entry, key, pBody, pPose);
+
+    // draws with the batch, or right away outside of one
+    BeginObjectBatch();
+
+    int result;
+    if (same && entry.stored)
+    {
+        displayCacheStats.hits++;
+
+        reservePrimitives(entry.display.prims.size(), entry.display.vertices.size());
+        result = replayDisplayResult(entry.display, pBody, pPose, alpha, beta, gamma);
+    }
+    else
+    {
+        if (displayCacheEnabled)
+        {
+            displayCacheStats.misses++;
+
+            if (!same)
+            {
+                entry.pBody = pBody;
+                entry.bodySerial = pBody->m_serial;
+                entry.key = key;
+                entry.pose = pPose->m_groups;
+                entry.stored = false;
+            }
+        }
+
+        reservePrimitives(pBody->m_primitives.size(), pBody->m_pointIndices.size());
+        const u32 firstPrimEntry = positionInPrimEntry;
+        const u32 firstPrimVertex = positionInPrimVertex;
+
+        preparedActorStruct& prepared = preparedActors[actorIdx];
+        if (prepared.batch == objectBatchSerial && prepared.pBody == pBody && prepared.bodySerial == pBody->m_serial && prepared.key == key)
+        {
+            result = replayDisplayResult(prepared.display, pBody, pPose, alpha, beta, gamma);
+
+            primCullStats.kept += prepared.cullStats.kept;
+            primCullStats.backFacing += prepared.cullStats.backFacing;
+            primCullStats.offScreen += prepared.cullStats.offScreen;
+        }
+        else
+        {
+            result = DisplayObject(x, y, z, alpha, beta, gamma, pBody, pPose);
+        }
+        prepared.batch = 0;
+
+        // only objects that stay put are worth keeping
+        if (same)
+        {
+            entry.stored = true;
+            storeDisplayResult(entry.display, pBody, result, firstPrimEntry, firstPrimVertex);
+        }
+    }
+
+    EndObjectBatch();
+    return result;
+}
+
 // Compatibility wrapper (old French name).
 int AffObjet(int x,int y,int z,int alpha,int beta,int gamma, sBody* pBody)
 {
-    return DisplayObject(x, y, z, alpha, beta, gamma, pBody);
+    return DisplayObject(x, y, z, alpha, beta, gamma, pBody, nullptr);
 }
 
-void computeScreenBox(int x, int y, int z, int alpha, int beta, int gamma, sBody* bodyPtr)
+void computeScreenBox(int x, int y, int z, int alpha, int beta, int gamma, sBody* bodyPtr, sPoseInstance* pPose)
 {
     BBox3D1 = 0x7FFF;
     BBox3D2 = 0x7FFF;
@@ -1334,6 +1946,6 @@ void computeScreenBox(int x, int y, int z, int alpha, int beta, int gamma, sBody
 
     if(modelFlags&INFO_ANIM)
     {
-        AnimNuage(x,y,z,alpha,beta,gamma, bodyPtr);
+        AnimNuage(x,y,z,alpha,beta,gamma, bodyPtr, pPose);
     }
 }
@@ -19,24 +19,92 @@
 #ifndef _RENDERER_H_
 #define _RENDERER_H_
 
-extern int BBox3D1;
-extern int BBox3D2;
-extern int BBox3D3;
-extern int BBox3D4;
+extern RENDER_CONTEXT int BBox3D1;
+extern RENDER_CONTEXT int BBox3D2;
+extern RENDER_CONTEXT int BBox3D3;
+extern RENDER_CONTEXT int BBox3D4;
 
 #define NUM_MAX_POINT_IN_POINT_BUFFER 800
 #define NUM_MAX_BONES 50
 
-extern std::array<point3dStruct, NUM_MAX_POINT_IN_POINT_BUFFER> pointBuffer;
-extern int numOfPoints;
+extern RENDER_CONTEXT std::array<point3dStruct, NUM_MAX_POINT_IN_POINT_BUFFER> pointBuffer;
+extern RENDER_CONTEXT int numOfPoints;
 
 void transformPoint(float* ax, float* bx, float* cx);
 
-int DisplayObject(int x, int y, int z, int alpha, int beta, int gamma, sBody* pBody);
+// pPose is the pose of an animated body, nullptr for the body's own
+int DisplayObject(int x, int y, int z, int alpha, int beta, int gamma, sBody* pBody, sPoseInstance* pPose);
+
+// Optional CPU culling of lines and polygons in DisplayObject: back facing
+// polygons, and primitives outside the screen
+struct primCullStatsStruct
+{
+    u32 kept;
+    u32 backFacing;
+    u32 offScreen;
+};
+
+extern bool cullBackFaces;
+extern bool cullOffScreen;
+extern RENDER_CONTEXT primCullStatsStruct primCullStats; // since the last reset
+
+// Objects displayed between BeginObjectBatch and EndObjectBatch are depth
+// sorted together and drawn at once by FlushObjects (at the latest by
+// EndObjectBatch). Outside of a batch each object is drawn right away.
+void BeginObjectBatch();
+void EndObjectBatch();
+void FlushObjects();
+
+// Position in the pending primitives. FlushObjectsBefore draws those pending
+// before the mark and keeps the ones after it pending.
+struct objectMarkStruct
+{
+    u32 primEntry;
+    u32 primVertex;
+    u32 flushSerial;
+};
+
+objectMarkStruct GetObjectMark();
+void FlushObjectsBefore(const objectMarkStruct& mark);
+
+// DisplayObject for the object in ListObjets slot actorIdx. When the object
+// is displayed with the same body, pose, position and camera as in the
+// previous frames, the previous primitives are drawn again instead.
+struct displayCacheStatsStruct
+{
+    u32 hits;
+    u32 misses;
+};
+
+extern bool displayCacheEnabled;
+extern displayCacheStatsStruct displayCacheStats; // since the last reset
+
+int DisplayActor(int actorIdx, int x, int y, int z, int alpha, int beta, int gamma, sBody* pBody);
+
+// The DisplayActor arguments of an object
+struct actorDisplayStruct
+{
+    int actorIdx;
+    int x;
+    int y;
+    int z;
+    int alpha;
+    int beta;
+    int gamma;
+    sBody* pBody;
+};
+
+// Transforms, projects and emits the primitives of the objects on the job
+// threads, ahead of their DisplayActor calls, which then only copy them into
+// the batch (in draw order, so the result doesn't change). Call inside an
+// object batch, with the camera and poses set up for the frame; what isn't
+// used is dropped at the end of the batch.
+extern bool prepareActorsEnabled;
+void PrepareActors(const actorDisplayStruct* actors, int numActors);
 
 // Compatibility wrapper (old French name).
 int AffObjet(int x, int y, int z, int alpha, int beta, int gamma, sBody* pBody);
 
-void computeScreenBox(int x, int y, int z, int alpha, int beta, int gamma, sBody* bodyPtr);
+void computeScreenBox(int x, int y, int z, int alpha, int beta, int gamma, sBody* bodyPtr, sPoseInstance* pPose);
 
 #endif
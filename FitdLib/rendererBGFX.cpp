@@ -44,6 +44,7 @@ email                : yaz0r@yaz0r.net
 #include <bx/platform.h>
 #include "shaders/embeddedShaders.h"
 #include "imguiBGFX.h"
+#include <algorithm>
 #include <array>
 #include <string>
 
@@ -64,17 +65,26 @@ unsigned int ditherTexture = 0;
 
 unsigned int    debugFontTexture = 0;
 
+// The masks of the current camera, cropped to their rectangle. They are packed
+// in one atlas texture at the first osystem_drawMasks after they change.
 struct maskStruct
 {
-    bgfx::TextureHandle maskTexture = BGFX_INVALID_HANDLE;
-    bgfx::VertexBufferHandle vertexBuffer = BGFX_INVALID_HANDLE;
+    std::vector<u8> texels;
     int maskX1 = 0;
     int maskY1 = 0;
-    int maskX2 = 0;
-    int maskY2 = 0;
+    int maskX2 = 0; // excluded
+    int maskY2 = 0; // excluded
+    int atlasX = 0;
+    int atlasY = 0;
+    bool inAtlas = false;
 };
 
-std::vector<std::vector<maskStruct>> maskTextures; // [room][mask]
+std::vector<std::vector<maskStruct>> masks; // [room][mask]
+
+#define MASK_ATLAS_WIDTH 1024
+
+bgfx::TextureHandle maskAtlasTexture = BGFX_INVALID_HANDLE;
+bool maskAtlasDirty = false;
 
 //vertex buffers for rendering
 struct polyVertex
@@ -1264,99 +1274,198 @@ void osystem_flip(unsigned char* videoBuffer)
     osystem_flushPendingPrimitives();
 }
 
-void osystem_createMask(const std::array<u8, 320 * 200>& mask, int roomId, int maskId, int maskX1, int maskY1, int maskX2, int maskY2)
+static void destroyMaskAtlas()
 {
-    if (maskTextures.size() < roomId + 1)
+    if (bgfx::isValid(maskAtlasTexture))
     {
-        maskTextures.resize(roomId + 1);
+        bgfx::destroy(maskAtlasTexture);
+        maskAtlasTexture = BGFX_INVALID_HANDLE;
     }
-    if (maskTextures[roomId].size() < maskId + 1)
+}
+
+void osystem_clearMasks()
+{
+    destroyMaskAtlas();
+    masks.clear();
+    maskAtlasDirty = false;
+}
+
+void osystem_createMask(const u8* mask, int roomId, int maskId, int maskX1, int maskY1, int maskX2, int maskY2)
+{
+    if (masks.size() < roomId + 1)
     {
-        maskTextures[roomId].resize(maskId + 1);
+        masks.resize(roomId + 1);
     }
-
-    if (bgfx::isValid(maskTextures[roomId][maskId].maskTexture))
+    if (masks[roomId].size() < maskId + 1)
     {
-        bgfx::destroy(maskTextures[roomId][maskId].maskTexture);
-        maskTextures[roomId][maskId].maskTexture = BGFX_INVALID_HANDLE;
+        masks[roomId].resize(maskId + 1);
     }
 
-    if (bgfx::isValid(maskTextures[roomId][maskId].vertexBuffer))
+    maskStruct& entry = masks[roomId][maskId];
+    entry.maskX1 = maskX1;
+    entry.maskX2 = maskX2 + 1;
+    entry.maskY1 = maskY1;
+    entry.maskY2 = maskY2 + 1;
+
+    int width = entry.maskX2 - entry.maskX1;
+    int height = entry.maskY2 - entry.maskY1;
+    if (width > 0 && height > 0)
+        entry.texels.assign(mask, mask + width * height);
+    else
+        entry.texels.clear();
+
+    maskAtlasDirty = true;
+}
+
+// Packs the masks on shelves, tallest first, into a MASK_ATLAS_WIDTH wide
+// texture of the height they take.
+static void buildMaskAtlas()
+{
+    maskAtlasDirty = false;
+    destroyMaskAtlas();
+
+    std::vector<maskStruct*> sortedMasks;
+    for (auto& roomMasks : masks)
     {
-        bgfx::destroy(maskTextures[roomId][maskId].vertexBuffer);
-        maskTextures[roomId][maskId].vertexBuffer = BGFX_INVALID_HANDLE;
+        for (auto& entry : roomMasks)
+        {
+            entry.inAtlas = false;
+            if (!entry.texels.empty())
+                sortedMasks.push_back(&entry);
+        }
     }
 
-    maskTextures[roomId][maskId].maskTexture = bgfx::createTexture2D(320, 200, false, 1, bgfx::TextureFormat::R8U, 0, bgfx::copy(mask.data(), 320 * 200));
-    maskTextures[roomId][maskId].maskX1 = maskX1;
-    maskTextures[roomId][maskId].maskX2 = maskX2 + 1;
-    maskTextures[roomId][maskId].maskY1 = maskY1;
-    maskTextures[roomId][maskId].maskY2 = maskY2 + 1;
+    if (sortedMasks.empty())
+        return;
 
-    bgfx::VertexLayout layout;
-    layout
-        .begin()
-        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-        .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
-        .end();
+    std::stable_sort(sortedMasks.begin(), sortedMasks.end(), [](const maskStruct* a, const maskStruct* b) {
+        return (a->maskY2 - a->maskY1) > (b->maskY2 - b->maskY1);
+    });
 
-    float X1 = maskTextures[roomId][maskId].maskX1;
-    float X2 = maskTextures[roomId][maskId].maskX2;
-    float Y1 = maskTextures[roomId][maskId].maskY1;
-    float Y2 = maskTextures[roomId][maskId].maskY2;
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    for (maskStruct* entry : sortedMasks)
+    {
+        int width = entry->maskX2 - entry->maskX1;
+        int height = entry->maskY2 - entry->maskY1;
 
-    float maskZ = 0.f;
+        if (shelfX + width > MASK_ATLAS_WIDTH)
+        {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
 
-    struct sVertice
+        entry->atlasX = shelfX;
+        entry->atlasY = shelfY;
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+
+    int atlasHeight = shelfY + shelfHeight;
+
+    const bgfx::Memory* atlas = bgfx::alloc(MASK_ATLAS_WIDTH * atlasHeight);
+    memset(atlas->data, 0, atlas->size);
+
+    for (maskStruct* entry : sortedMasks)
     {
-        float position[3];
-        float texcoord[2];
-    } vertexBuffer[4];
-
-    sVertice* pVertices = vertexBuffer;
-    pVertices->position[0] = X1;
-    pVertices->position[1] = Y2;
-    pVertices->position[2] = maskZ;
-    pVertices->texcoord[0] = X1 / 320.f;
-    pVertices->texcoord[1] = Y2 / 200.f;
-    pVertices++;
-    pVertices->position[0] = X1;
-    pVertices->position[1] = Y1;
-    pVertices->position[2] = maskZ;
-    pVertices->texcoord[0] = X1 / 320.f;
-    pVertices->texcoord[1] = Y1 / 200.f;
-    pVertices++;
-    pVertices->position[0] = X2;
-    pVertices->position[1] = Y2;
-    pVertices->position[2] = maskZ;
-    pVertices->texcoord[0] = X2 / 320.f;
-    pVertices->texcoord[1] = Y2 / 200.f;
-    pVertices++;
-    pVertices->position[0] = X2;
-    pVertices->position[1] = Y1;
-    pVertices->position[2] = maskZ;
-    pVertices->texcoord[0] = X2 / 320.f;
-    pVertices->texcoord[1] = Y1 / 200.f;
-    pVertices++;
-
-    maskTextures[roomId][maskId].vertexBuffer = bgfx::createVertexBuffer(bgfx::copy(vertexBuffer, sizeof(vertexBuffer)), layout);
+        int width = entry->maskX2 - entry->maskX1;
+        int height = entry->maskY2 - entry->maskY1;
+
+        for (int y = 0; y < height; y++)
+        {
+            memcpy(atlas->data + (entry->atlasY + y) * MASK_ATLAS_WIDTH + entry->atlasX, &entry->texels[y * width], width);
+        }
+
+        entry->inAtlas = true;
+    }
+
+    maskAtlasTexture = bgfx::createTexture2D(MASK_ATLAS_WIDTH, atlasHeight, false, 1, bgfx::TextureFormat::R8U, 0, atlas);
 }
 
-void osystem_drawMask(int roomId, int maskId)
+// Draws every rectangle as a quad of its mask, with texel positions in the
+// atlas, all in one draw call.
+void osystem_drawMasks(const maskRectStruct* rects, int numRects)
 {
     if (g_gameId == TIMEGATE)
         return;
 
-    if (!bgfx::isValid(maskTextures[roomId][maskId].maskTexture))
+#ifdef FITD_DEBUGGER
+    if (backgroundMode != backgroundModeEnum_2D)
         return;
+#endif
+
+    if (maskAtlasDirty)
+        buildMaskAtlas();
 
-    if (!bgfx::isValid(maskTextures[roomId][maskId].vertexBuffer))
+    if (!bgfx::isValid(maskAtlasTexture))
         return;
 
-#ifdef FITD_DEBUGGER
-    if (backgroundMode != backgroundModeEnum_2D)
+    struct sVertice
+    {
+        float position[3];
+        float texcoord[2];
+    };
+    static std::vector<sVertice> vertices;
+    vertices.clear();
+
+    for (int i = 0; i < numRects; i++)
+    {
+        const maskRectStruct& rect = rects[i];
+        if (rect.roomId >= masks.size() || rect.maskId >= masks[rect.roomId].size())
+            continue;
+
+        const maskStruct& entry = masks[rect.roomId][rect.maskId];
+        if (!entry.inAtlas)
+            continue;
+
+        // from a pixel left of and above the rectangle, like the
+        // osystem_setClip scissor, within the mask
+        int x1 = std::max(rect.x1 - 1, entry.maskX1);
+        int y1 = std::max(rect.y1 - 1, entry.maskY1);
+        int x2 = std::min(rect.x2 + 1, entry.maskX2);
+        int y2 = std::min(rect.y2 + 1, entry.maskY2);
+        if (x1 >= x2 || y1 >= y2)
+            continue;
+
+        // screen position, and texel position in the atlas
+        float X1 = x1;
+        float X2 = x2;
+        float Y1 = y1;
+        float Y2 = y2;
+        float U1 = entry.atlasX + x1 - entry.maskX1;
+        float U2 = entry.atlasX + x2 - entry.maskX1;
+        float V1 = entry.atlasY + y1 - entry.maskY1;
+        float V2 = entry.atlasY + y2 - entry.maskY1;
+
+        float maskZ = 0.f;
+
+        vertices.push_back({ { X1, Y2, maskZ }, { U1, V2 } });
+        vertices.push_back({ { X1, Y1, maskZ }, { U1, V1 } });
+        vertices.push_back({ { X2, Y2, maskZ }, { U2, V2 } });
+        vertices.push_back({ { X2, Y2, maskZ }, { U2, V2 } });
+        vertices.push_back({ { X1, Y1, maskZ }, { U1, V1 } });
+        vertices.push_back({ { X2, Y1, maskZ }, { U2, V1 } });
+    }
+
+    if (vertices.empty())
         return;
-#endif
+
+    bgfx::VertexLayout layout;
+    layout
+        .begin()
+        .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+        .end();
+
+    if (bgfx::getAvailTransientVertexBuffer((u32)vertices.size(), layout) < vertices.size())
+        return;
+
+    bgfx::TransientVertexBuffer transientBuffer;
+    bgfx::allocTransientVertexBuffer(&transientBuffer, (u32)vertices.size(), layout);
+
+    memcpy(transientBuffer.data, vertices.data(), sizeof(sVertice) * vertices.size());
 
     static bgfx::UniformHandle backgroundTextureUniform = BGFX_INVALID_HANDLE;
     if (!bgfx::isValid(backgroundTextureUniform))
@@ -1376,14 +1485,13 @@ void osystem_drawMask(int roomId, int maskId)
 
     bgfx::setState(0 | BGFX_STATE_WRITE_RGB
         | BGFX_STATE_MSAA
-        | BGFX_STATE_PT_TRISTRIP
     );
 
-    bgfx::setVertexBuffer(0, maskTextures[roomId][maskId].vertexBuffer);
+    bgfx::setVertexBuffer(0, &transientBuffer);
 
     bgfx::setTexture(2, backgroundTextureUniform, g_backgroundTexture);
     bgfx::setTexture(1, paletteTextureUniform, g_paletteTexture);
-    bgfx::setTexture(0, maskTextureUniform, maskTextures[roomId][maskId].maskTexture);
+    bgfx::setTexture(0, maskTextureUniform, maskAtlasTexture);
     bgfx::submit(gameViewId, getMaskBackgroundShader());
 }
 
@@ -23,6 +23,7 @@ struct hardColStruct;
 typedef struct hardColStruct hardColStruct;
 
 #include "vars.h" // temporary fix to cross include
+#include "roomGrid.h"
 
 struct hardColStruct
 {
@@ -115,9 +116,11 @@ struct roomDataStruct
 
   u32 numHardCol;
   std::vector<hardColStruct> hardColTable;
+  roomGridStruct hardColGrid;
 
   u32 numSceZone;
   std::vector<sceZoneStruct> sceZoneTable;
+  roomGridStruct sceZoneGrid;
 
   s32 worldX;
   s32 worldY;
@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark room grid (Game Logic)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+#include "common.h"
+
+#include "roomGrid.h"
+
+#include <math.h>
+#include <algorithm>
+
+#define ROOM_GRID_MIN_ENTRIES 8 // below this a plain walk of the table is as fast
+#define ROOM_GRID_MAX_CELLS 32 // per axis
+
+// Entries of the last box query over several cells, and the query each entry
+// was last added by
+static std::vector<u16> gridScratch;
+static std::vector<u32> gridStamps;
+static u32 gridStamp = 0;
+
+static inline const ZVStruct* getZv(const ZVStruct* firstZv, size_t stride, int index)
+{
+    return (const ZVStruct*)((const u8*)firstZv + stride * index);
+}
+
+static inline int getCell(s32 value, s32 min, s32 max, int shift)
+{
+    return (std::clamp(value, min, max) - min) >> shift;
+}
+
+// The cells under [x1, x2] x [z1, z2]; false if it misses the grid
+static bool getCells(const roomGridStruct& grid, s32 x1, s32 x2, s32 z1, s32 z2, int& cellX1, int& cellX2, int& cellZ1, int& cellZ2)
+{
+    if (x2 < grid.minX || x1 > grid.maxX || z2 < grid.minZ || z1 > grid.maxZ)
+        return false;
+
+    cellX1 = getCell(x1, grid.minX, grid.maxX, grid.cellShift);
+    cellX2 = getCell(x2, grid.minX, grid.maxX, grid.cellShift);
+    cellZ1 = getCell(z1, grid.minZ, grid.maxZ, grid.cellShift);
+    cellZ2 = getCell(z2, grid.minZ, grid.maxZ, grid.cellShift);
+
+    return true;
+}
+
+void buildRoomGrid(roomGridStruct& grid, const ZVStruct* firstZv, size_t stride, int numEntries)
+{
+    grid.numEntries = -1;
+    grid.cellStarts.clear();
+    grid.cellEntries.clear();
+
+    if (numEntries < ROOM_GRID_MIN_ENTRIES)
+        return;
+
+    // A ZV with X1 > X2 still meets the boxes spanning [X2, X1] in
+    // AsmCheckListCol, so each entry covers both of its ends
+    grid.minX = grid.minZ = INT32_MAX;
+    grid.maxX = grid.maxZ = INT32_MIN;
+
+    for (int i = 0; i < numEntries; i++)
+    {
+        const ZVStruct* zvPtr = getZv(firstZv, stride, i);
+
+        grid.minX = std::min(grid.minX, std::min(zvPtr->ZVX1, zvPtr->ZVX2));
+        grid.maxX = std::max(grid.maxX, std::max(zvPtr->ZVX1, zvPtr->ZVX2));
+        grid.minZ = std::min(grid.minZ, std::min(zvPtr->ZVZ1, zvPtr->ZVZ2));
+        grid.maxZ = std::max(grid.maxZ, std::max(zvPtr->ZVZ1, zvPtr->ZVZ2));
+    }
+
+    // about one entry per cell, with power of 2 cells
+    const int targetCells = std::clamp((int)ceil(sqrt((double)numEntries)), 1, ROOM_GRID_MAX_CELLS);
+    const s32 span = std::max(grid.maxX - grid.minX, grid.maxZ - grid.minZ);
+
+    grid.cellShift = 0;
+    while ((span >> grid.cellShift) >= targetCells)
+    {
+        grid.cellShift++;
+    }
+
+    grid.cellsX = ((grid.maxX - grid.minX) >> grid.cellShift) + 1;
+    grid.cellsZ = ((grid.maxZ - grid.minZ) >> grid.cellShift) + 1;
+
+    // counted, then filled in table order
+    grid.cellStarts.assign(grid.cellsX * grid.cellsZ + 1, 0);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < numEntries; i++)
+        {
+            const ZVStruct* zvPtr = getZv(firstZv, stride, i);
+
+            int cellX1, cellX2, cellZ1, cellZ2;
+            getCells(grid,
+                std::min(zvPtr->ZVX1, zvPtr->ZVX2), std::max(zvPtr->ZVX1, zvPtr->ZVX2),
+                std::min(zvPtr->ZVZ1, zvPtr->ZVZ2), std::max(zvPtr->ZVZ1, zvPtr->ZVZ2),
+                cellX1, cellX2, cellZ1, cellZ2);
+
+            for (int cellZ = cellZ1; cellZ <= cellZ2; cellZ++)
+            {
+                for (int cellX = cellX1; cellX <= cellX2; cellX++)
+                {
+                    const int cell = cellZ * grid.cellsX + cellX;
+
+                    if (pass == 0)
+                        grid.cellStarts[cell + 1]++;
+                    else
+                        grid.cellEntries[grid.cellStarts[cell]++] = (u16)i;
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            // cellStarts[cell] is where the cell's entries start
+            for (size_t cell = 1; cell < grid.cellStarts.size(); cell++)
+            {
+                grid.cellStarts[cell] += grid.cellStarts[cell - 1];
+            }
+
+            grid.cellEntries.resize(grid.cellStarts.back());
+        }
+        else
+        {
+            // the fill moved cellStarts[cell] to where cell + 1 starts
+            for (size_t cell = grid.cellStarts.size() - 1; cell > 0; cell--)
+            {
+                grid.cellStarts[cell] = grid.cellStarts[cell - 1];
+            }
+
+            grid.cellStarts[0] = 0;
+        }
+    }
+
+    grid.numEntries = numEntries;
+}
+
+int getRoomGridBox(const roomGridStruct& grid, const ZVStruct* zvPtr, const u16** entries)
+{
+    if (grid.numEntries < 0)
+        return -1;
+
+    int cellX1, cellX2, cellZ1, cellZ2;
+    if (!getCells(grid,
+            std::min(zvPtr->ZVX1, zvPtr->ZVX2), std::max(zvPtr->ZVX1, zvPtr->ZVX2),
+            std::min(zvPtr->ZVZ1, zvPtr->ZVZ2), std::max(zvPtr->ZVZ1, zvPtr->ZVZ2),
+            cellX1, cellX2, cellZ1, cellZ2))
+    {
+        return 0;
+    }
+
+    if (cellX1 == cellX2 && cellZ1 == cellZ2)
+    {
+        const int cell = cellZ1 * grid.cellsX + cellX1;
+
+        *entries = grid.cellEntries.data() + grid.cellStarts[cell];
+        return (int)(grid.cellStarts[cell + 1] - grid.cellStarts[cell]);
+    }
+
+    // over several cells: each entry once, back in table order
+    if (gridStamps.size() < (size_t)grid.numEntries)
+        gridStamps.resize(grid.numEntries, 0);
+
+    if (++gridStamp == 0)
+    {
+        std::fill(gridStamps.begin(), gridStamps.end(), 0);
+        gridStamp = 1;
+    }
+
+    gridScratch.clear();
+
+    for (int cellZ = cellZ1; cellZ <= cellZ2; cellZ++)
+    {
+        for (int cellX = cellX1; cellX <= cellX2; cellX++)
+        {
+            const int cell = cellZ * grid.cellsX + cellX;
+
+            for (u32 i = grid.cellStarts[cell]; i < grid.cellStarts[cell + 1]; i++)
+            {
+                const u16 entry = grid.cellEntries[i];
+
+                if (gridStamps[entry] != gridStamp)
+                {
+                    gridStamps[entry] = gridStamp;
+                    gridScratch.push_back(entry);
+                }
+            }
+        }
+    }
+
+    std::sort(gridScratch.begin(), gridScratch.end());
+
+    *entries = gridScratch.data();
+    return (int)gridScratch.size();
+}
+
+int getRoomGridPoint(const roomGridStruct& grid, int x, int z, const u16** entries)
+{
+    if (grid.numEntries < 0)
+        return -1;
+
+    if (x < grid.minX || x > grid.maxX || z < grid.minZ || z > grid.maxZ)
+        return 0;
+
+    const int cell = ((z - grid.minZ) >> grid.cellShift) * grid.cellsX + ((x - grid.minX) >> grid.cellShift);
+
+    *entries = grid.cellEntries.data() + grid.cellStarts[cell];
+    return (int)(grid.cellStarts[cell + 1] - grid.cellStarts[cell]);
+}
@@ -0,0 +1,53 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark room grid (Game Logic)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+// A 2D grid on X/Z over the hard collisions or the scenario zones of a room,
+// built by LoadEtage. Every cell lists, in table order, the entries whose ZV
+// covers it, so AsmCheckListCol, processActor2Sub and GereDec only test those
+// and still find them in the order of the table.
+
+struct ZVStruct;
+
+struct roomGridStruct
+{
+    int numEntries = -1; // -1 until built
+    s32 minX = 0;
+    s32 minZ = 0;
+    s32 maxX = 0;
+    s32 maxZ = 0;
+    int cellShift = 0;
+    int cellsX = 0;
+    int cellsZ = 0;
+    std::vector<u32> cellStarts; // cellsX * cellsZ + 1, into cellEntries
+    std::vector<u16> cellEntries;
+};
+
+// numEntries ZVs, stride bytes apart
+void buildRoomGrid(roomGridStruct& grid, const ZVStruct* firstZv, size_t stride, int numEntries);
+
+// The entries, in ascending order, whose ZV may intersect zvPtr (as
+// CubeIntersect does) or contain the point (x, *, z). -1 when the grid isn't
+// built and every entry has to be tested. The list stays valid until the next
+// getRoomGridBox.
+int getRoomGridBox(const roomGridStruct& grid, const ZVStruct* zvPtr, const u16** entries);
+int getRoomGridPoint(const roomGridStruct& grid, int x, int z, const u16** entries);
@@ -508,16 +508,20 @@ int loadSave(int saveNumber)
     }
     fclose(fHandle);
 
+    GenereActiveObjets();
+
     for(i=0;i<NUM_MAX_OBJECT;i++)
     {
         if(ListObjets[i].indexInWorld != -1 && ListObjets[i].bodyNum != -1)
         {
             sBody* bodyPtr = HQR_Get(HQ_Bodys,ListObjets[i].bodyNum);
 
+            InitPose(&ListPoses[i], bodyPtr);
+
             if(ListObjets[i].ANIM != -1)
             {
                 sAnimation* animPtr = HQR_Get(HQ_Anims,ListObjets[i].ANIM);
-                SetAnimObjet(ListObjets[i].frame,animPtr,bodyPtr);
+                SetAnimObjet(ListObjets[i].frame,animPtr,bodyPtr,&ListPoses[i]);
             }
         }
     }
@@ -577,6 +581,7 @@ int makeSaveFile(int entry)
             if (ListObjets[i].indexInWorld == -2) // Special objects
             {
                 ListObjets[i].indexInWorld = -1;
+                RemoveActiveObjet(i);
                 if (ListObjets[i].ANIM == 4)
                 {
                     CVars[getCVarsIdx(FOG_FLAG)] = 0;
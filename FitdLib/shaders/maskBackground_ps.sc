@@ -1,4 +1,4 @@
-$input v_texcoord0
+$input v_texcoord0, v_texcoord1
 
 #include "bgfx_shader.sh"
 #include "palette.sh"
@@ -8,11 +8,10 @@ USAMPLER2D(s_backgroundTexture, 2);
 
 void main()
 {
-    vec2 position = vec2(v_texcoord0.xy) * vec2(320, 200);
-    uvec4 rawMask = texelFetch(s_maskPaletteTexture, ivec2(position), 0);
+    uvec4 rawMask = texelFetch(s_maskPaletteTexture, ivec2(v_texcoord0.xy), 0);
     if(int(rawMask.r) == 0)
         discard;
 
-    uvec4 rawTexel = texelFetch(s_backgroundTexture, ivec2(position), 0);
+    uvec4 rawTexel = texelFetch(s_backgroundTexture, ivec2(v_texcoord1.xy), 0);
     gl_FragColor = getColorFromRawOffset(rawTexel.r);
 }
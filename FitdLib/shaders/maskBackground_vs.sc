@@ -1,10 +1,11 @@
 $input a_position, a_texcoord0
-$output v_texcoord0
+$output v_texcoord0, v_texcoord1
 
 #include "bgfx_shader.sh"
 
 void main()
 {
     gl_Position = vec4(a_position.x/160.0-1.0, 1.0-a_position.y/100.0, 0.0, 1.0);
-    v_texcoord0 = a_texcoord0;
+    v_texcoord0 = a_texcoord0; // texel in the mask atlas
+    v_texcoord1 = a_position.xy; // pixel of the background
 }
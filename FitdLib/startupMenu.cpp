@@ -58,7 +58,9 @@ void DrawMenu(int selectedEntry)
 
 int MainMenu(void)
 {
+#ifdef DREAMCAST
     DC_SetMenuActive(true);
+#endif
 
 #ifdef DREAMCAST
     dbgio_printf("[dc] MainMenu(): enter (gameId=%d)\n", (int)g_gameId);
@@ -164,7 +166,9 @@ int MainMenu(void)
         process_events();
     }
 
+#ifdef DREAMCAST
     DC_SetMenuActive(false);
+#endif
 
 #ifdef DREAMCAST
     dbgio_printf("[dc] MainMenu(): exit selectedEntry=%d\n", selectedEntry);
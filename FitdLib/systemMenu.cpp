@@ -70,7 +70,9 @@ void AffOptionList(int selectedStringNumber)
 
 void processSystemMenu(void)
 {
+#ifdef DREAMCAST
     DC_SetMenuActive(true);
+#endif
 
     //int entry = -1;
     int exitMenu = 0;
@@ -178,5 +180,7 @@ void processSystemMenu(void)
 	localKey = localClick = localJoyD = 0;
 	FlagInitView = 2;
 	RestoreTimerAnim();
+#ifdef DREAMCAST
     DC_SetMenuActive(false);
+#endif
 }
\ No newline at end of file
@@ -369,6 +369,8 @@ void processTrack(void)
                     currentProcessedActorPtr->zv.ZVZ1 += currentProcessedActorPtr->roomZ + currentProcessedActorPtr->stepZ;
                     currentProcessedActorPtr->zv.ZVZ2 += currentProcessedActorPtr->roomZ + currentProcessedActorPtr->stepZ;
 
+                    MoveObjetGrid(currentProcessedActorPtr);
+
                     currentProcessedActorPtr->speed = 0;
                     currentProcessedActorPtr->direction = 0;
                     currentProcessedActorPtr->rotate.numSteps = 0;
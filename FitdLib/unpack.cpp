@@ -40,32 +40,45 @@
 // --------------------------------------------------------------
 // Explode unpacking functions & types
 // --------------------------------------------------------------
+// Table driven take on the Mark Adler decoder. The three trees are decoded
+// through flat tables that are rebuilt in place, or kept when an entry
+// carries the same tree as the previous one, so nothing is allocated per
+// entry. Bits come from a 64 bit buffer that is refilled once per token,
+// literals are decoded several at a time while it holds enough bits, and
+// matches are copied straight into the destination instead of going through
+// a 32K window. The output is the one of the old decoder, which
+// tools/pakpack keeps as the reference.
+
 #define PAK_BMAX 16
-#define PAK_N_MAX 288
-#define PAK_WSIZE 0x8000
+#define PAK_LIT_ROOT 9                  // root bits of the literal table
+#define PAK_LEN_ROOT 8                  // root bits of the length and distance tables
+#define PAK_LIT_ENOUGH (512 + 4096)     // root + subtables, for any complete 256 code tree
+#define PAK_LEN_ENOUGH (256 + 1824)     // same for 64 codes
+
+#define PAK_OP_LINK 0x40                // | subtable bits
+#define PAK_OP_INVALID 0x80
+
+typedef struct {
+  unsigned char bits;   // stream bits used by this entry
+  unsigned char op;     // extra bits for a leaf, or PAK_OP_LINK / PAK_OP_INVALID
+  unsigned short val;   // literal, length base, distance base or subtable offset
+} PAK_code;
 
 typedef struct {
-  unsigned long csize;
-  unsigned long ucsize;
-  unsigned char * buf_src;
-  unsigned char * buf_dst;
-  unsigned long off_src;
-  unsigned long off_dst;
-  unsigned short flags;
-} PAK_stream;
-
-typedef struct PAK_huft {
-  unsigned short e;     // number of PAK_extra bits or operation
-  unsigned short b;     // number of bits in this code or subcode
-  union {
-    unsigned short n;   // literal, length base, or distance base
-    struct PAK_huft *t;     // pointer to next level of table
-  } v;
-} PAK_huft;
-
-
-static unsigned char PAK_slide[PAK_WSIZE];
-static unsigned PAK_mask_bits[17] = { 0x0000, 0x0001, 0x0003, 0x0007, 0x000f, 0x001f, 0x003f, 0x007f, 0x00ff, 0x01ff, 0x03ff, 0x07ff, 0x0fff, 0x1fff, 0x3fff, 0x7fff, 0xffff };
+  unsigned char desc[257];      // tree description the table was built from
+  unsigned size;
+  const unsigned short * base;
+  unsigned root;                // 0 if there is no valid table
+} PAK_tree;
+
+static struct {
+  PAK_code lit[PAK_LIT_ENOUGH];
+  PAK_code len[PAK_LEN_ENOUGH];
+  PAK_code dist[PAK_LEN_ENOUGH];
+  PAK_tree litTree;
+  PAK_tree lenTree;
+  PAK_tree distTree;
+} PAK_tables;
 
 /* Tables for length and distance */
 static unsigned short cplen2[] = {
@@ -107,370 +120,275 @@ static unsigned short cpdist8[] = {
         7041, 7169, 7297, 7425, 7553, 7681, 7809, 7937, 8065
 };
 
-#define PAK_NEXTBYTE ((pG->off_src<pG->csize)?(pG->buf_src[pG->off_src++]):0)
-#define PAK_FLUSH(size) { memcpy(pG->buf_dst + pG->off_dst, PAK_slide, size); pG->off_dst += size; }
-
-#define PAK_NEEDBITS(n) {while(k<(n)){b|=((unsigned long)PAK_NEXTBYTE)<<k;k+=8;}}
-#define PAK_DUMPBITS(n) {b>>=(n);k-=(n);}
-#define PAK_DECODEHUFT(htab, bits, mask) {\
-  PAK_NEEDBITS((unsigned)(bits))\
-  t = (htab) + ((~(unsigned)b)&(mask));\
-  while(1) {\
-    PAK_DUMPBITS(t->b)\
-    if((e=t->e) <= 32) break;\
-    if(e==99) return 1;\
-    e &= 31;\
-    PAK_NEEDBITS(e)\
-    t = t->v.t + ((~(unsigned)b)&PAK_mask_bits[e]);\
+// At least 56 bits in b afterwards. Reads past the end of the source give
+// zeros, like PAK_NEXTBYTE did.
+#ifdef MACOSX
+#define PAK_REFILL() {\
+  while(k <= 56) { b |= (uint64_t)((src < srcEnd) ? *src++ : 0) << k; k += 8; }\
+}
+#else
+#define PAK_REFILL() {\
+  if(srcEnd - src >= 8) {\
+    uint64_t word;\
+    memcpy(&word, src, 8);\
+    b |= word << k;\
+    src += (63 - k) >> 3;\
+    k |= 56;\
+  } else {\
+    while(k <= 56) { b |= (uint64_t)((src < srcEnd) ? *src++ : 0) << k; k += 8; }\
   }\
 }
+#endif
 
-void PAK_huft_free(PAK_stream * pG, PAK_huft * t) {
-  PAK_huft *p, *q;
-  p = t;
-  while(p != (PAK_huft *)NULL) {
-    q = (--p)->v.t;
-    free((void *)p);
-    p = q;
-  }
+#define PAK_DUMPBITS(n) {b>>=(n);k-=(n);}
+
+// The codes are stored inverted, hence the ~b.
+#define PAK_DECODE(t, table, root) {\
+  t = (table) + ((~(unsigned)b) & ((1u << (root)) - 1));\
+  if(t->op & PAK_OP_LINK) {\
+    PAK_DUMPBITS(root)\
+    t = (table) + t->val + ((~(unsigned)b) & ((1u << (t->op & 0x3f)) - 1));\
+  }\
+  if(t->op & PAK_OP_INVALID) return 1;\
+  PAK_DUMPBITS(t->bits)\
 }
 
-int PAK_huft_build(PAK_stream * pG, unsigned * b, unsigned n, unsigned s, unsigned short * d, unsigned char * e, PAK_huft * t[], unsigned * m) {
-  unsigned a;                   /* counter for codes of length k */
-  unsigned c[PAK_BMAX+1];       /* bit length count table */
-  unsigned el;                  /* length of EOB code (value 256) */
-  unsigned f;                   /* i repeats in table every f entries */
-  int g;                        /* maximum code length */
-  int h;                        /* table level */
-  unsigned i;          /* counter, current code */
-  unsigned j;          /* counter */
-  int k;               /* number of bits in current code */
-  int lx[PAK_BMAX+1];           /* memory for l[-1..PAK_BMAX-1] */
-  int *l = lx+1;                /* stack of bits per table */
-  unsigned *p;         /* pointer into c[], b[], or v[] */
-  PAK_huft *q;         /* points to current table */
-  PAK_huft r;                   /* table entry for structure assignment */
-  PAK_huft *u[PAK_BMAX];        /* table stack */
-  unsigned v[PAK_N_MAX];        /* values in order of bit length */
-  int w;               /* bits before this table == (l * h) */
-  unsigned x[PAK_BMAX+1];       /* bit offsets, then code stack */
-  unsigned *xp;                 /* pointer into x */
-  int y;                        /* number of dummy codes added */
-  unsigned z;                   /* number of entries in current table */
-
-  /* Generate counts for each bit length */
-  el = n > 256 ? b[256] : PAK_BMAX; /* set length of EOB code, if any */
-  memset((char *)c, 0, sizeof(c));
-  p = (unsigned *)b;  i = n;
-  do {
-    c[*p]++; p++;               /* assume all entries <= PAK_BMAX */
-  } while(--i);
-  if(c[0] == n)                /* null input--all zero length codes */
-  {
-    *t = (PAK_huft *)NULL;
-    *m = 0;
-    return(0);
+/* Builds the decoding table of n codes with the given bit lengths (1..16),
+   with the code assignment of huft_build. Returns the root bits, 0 if the
+   lengths are over-subscribed, incomplete with more than one code (the
+   error of huft_build) or don't fit in the table. */
+static unsigned PAK_build_table(PAK_code * table, unsigned tableSize, unsigned maxRoot, const unsigned * lengths, unsigned n, const unsigned short * base, const unsigned char * extraBits) {
+  unsigned count[PAK_BMAX+1];
+  unsigned next[PAK_BMAX+1];
+  unsigned codes[256];
+  unsigned char subBits[1 << PAK_LIT_ROOT];
+  unsigned short subOffset[1 << PAK_LIT_ROOT];
+  unsigned maxLen = 0;
+  unsigned i, len;
+
+  memset(count, 0, sizeof(count));
+  for(i = 0; i < n; i++) {
+    count[lengths[i]]++;
+    if(lengths[i] > maxLen) maxLen = lengths[i];
   }
 
-  /* Find minimum and maximum length, bound *m by those */
-  for(j = 1; j <= PAK_BMAX; j++)
-    if(c[j])
-      break;
-  k = j;                        /* minimum code length */
-  if(*m < j) *m = j;
-  for(i = PAK_BMAX; i; i--) {
-    if(c[i]) break;
+  int left = 1;
+  for(len = 1; len <= PAK_BMAX; len++) {
+    left = (left << 1) - (int)count[len];
+    if(left < 0) return 0;
   }
-  g = i;                        /* maximum code length */
-  if(*m > i) *m = i;
+  if(left > 0 && n > 1) return 0;
 
-  /* Adjust last length count to fill out codes, if needed */
-  for(y = 1 << j; j < i; j++, y <<= 1) {
-    if((y -= c[j]) < 0) return(2);  /* bad input: more codes than bits */
+  // canonical codes, shortest first, bit reversed since the stream is read from the low bit
+  unsigned code = 0;
+  for(len = 1; len <= PAK_BMAX; len++) {
+    next[len] = code;
+    code = (code + count[len]) << 1;
   }
-  if((y -= c[i]) < 0) return(2);
-  c[i] += y;
-
-  /* Generate starting offsets into the value table for each length */
-  x[1] = j = 0;
-  p = c + 1;  xp = x + 2;
-  while(--i) {                 /* note that i == g from above */
-    *xp++ = (j += *p++);
+  for(i = 0; i < n; i++) {
+    unsigned c = next[lengths[i]]++;
+    unsigned r = 0;
+    for(len = 0; len < lengths[i]; len++) {
+      r = (r << 1) | (c & 1);
+      c >>= 1;
+    }
+    codes[i] = r;
   }
 
-  /* Make a table of values in order of bit lengths */
-  memset((char *)v, 0, sizeof(v));
-  p = (unsigned *)b;  i = 0;
-  do {
-    if((j = *p++) != 0) v[x[j]++] = i;
-  } while(++i < n);
-  n = x[g];                     /* set n to length of v */
-
-  /* Generate the Huffman codes and for each, make the table entries */
-  x[0] = i = 0;                 /* first Huffman code is zero */
-  p = v;                        /* grab values in bit order */
-  h = -1;                       /* no tables yet--level -1 */
-  w = l[-1] = 0;                /* no bits decoded yet */
-  u[0] = (PAK_huft *)NULL;      /* just to keep compilers happy */
-  q = (PAK_huft *)NULL;         /* ditto */
-  z = 0;                        /* ditto */
-
-  /* go through the bit lengths (k already is bits in shortest code) */
-  for(; k <= g; k++) {
-    a = c[k];
-    while(a--) {
-      /* here i is the Huffman code of length k bits for value *p */
-      /* make tables up to required level */
-      while(k > w + l[h]) {
-        w += l[h++];            /* add bits already decoded */
-
-        /* compute minimum size table less than or equal to *m bits */
-        z = (z = g - w) > *m ? *m : z;                  /* upper limit */
-        if((f = 1 << (j = k - w)) > a + 1) {    /* try a k-w bit table */
-                                /* too few codes for k-w bit table */
-          f -= a + 1;           /* deduct codes from patterns left */
-          xp = c + k;
-          while(++j < z) {      /* try smaller tables up to z bits */
-            if((f <<= 1) <= *++xp) break; /* enough codes to use up j bits */
-            f -= *xp;           /* else deduct codes from patterns */
-          }
-        }
-        if((unsigned)w + j > el && (unsigned)w < el) j = el - w; /* make EOB code end at table */
-        z = 1 << j;             /* table entries for j-bit table */
-        l[h] = j;               /* set table size in stack */
-
-        /* allocate and link in new table */
-        if((q = (PAK_huft *)malloc((z + 1)*sizeof(PAK_huft))) == (PAK_huft *)NULL) {
-          if(h) PAK_huft_free(pG, u[0]);
-          return(3);            /* not enough memory */
-        }
-
-        *t = q + 1;             /* link to list for PAK_huft_free() */
-        *(t = &(q->v.t)) = (PAK_huft *)NULL;
-        u[h] = ++q;             /* table starts after link */
-
-        /* connect to last table, if there is one */
-        if(h) {
-          x[h] = i;             /* save pattern for backing up */
-          r.b = (unsigned char)l[h-1];    /* bits to dump before this table */
-          r.e = (unsigned char)(32 + j);  /* bits in this table */
-          r.v.t = q;            /* pointer to this table */
-          j = (i & ((1 << w) - 1)) >> (w - l[h-1]);
-          u[h-1][j] = r;        /* connect to last table */
-        }
-      }
+  const unsigned root = (maxLen < maxRoot) ? maxLen : maxRoot;
+  const unsigned rootSize = 1u << root;
 
-      /* set up table entry in r */
-      r.b = (unsigned char)(k - w);
-      if(p >= v + n) {
-        r.e = 99;     /* out of values--invalid code */
-      } else if(*p < s) {
-        r.e = (unsigned char)(*p < 256 ? 32 : 31);  /* 256 is end-of-block code */
-        r.v.n = (unsigned short)*p++;               /* simple code is just the value */
-      } else {
-        r.e = e[*p - s];        /* non-simple--look up in lists */
-        r.v.n = d[*p++ - s];
-      }
-
-      /* fill code-like entries with r */
-      f = 1 << (k - w);
-      for(j = i >> w; j < z; j += f) {
-        q[j] = r;
-      }
+  memset(subBits, 0, rootSize);
+  for(i = 0; i < n; i++) {
+    if(lengths[i] > root) {
+      unsigned p = codes[i] & (rootSize - 1);
+      if(lengths[i] - root > subBits[p]) subBits[p] = (unsigned char)(lengths[i] - root);
+    }
+  }
 
-      /* backwards increment the k-bit code i */
-      for(j = 1 << (k - 1); i & j; j >>= 1) {
-        i ^= j;
-      }
-      i ^= j;
+  unsigned used = rootSize;
+  for(i = 0; i < rootSize; i++) {
+    if(subBits[i]) {
+      subOffset[i] = (unsigned short)used;
+      used += 1u << subBits[i];
+    }
+  }
+  if(used > tableSize) return 0;
 
-      /* backup over finished tables */
-      while((i & ((1 << w) - 1)) != x[h]) {
-        w -= l[--h];            /* don't need to update q */
-      }
+  // whatever a single code leaves unfilled stays invalid
+  for(i = 0; i < used; i++) {
+    table[i].bits = 0;
+    table[i].op = PAK_OP_INVALID;
+    table[i].val = 0;
+  }
+  for(i = 0; i < rootSize; i++) {
+    if(subBits[i]) {
+      table[i].bits = (unsigned char)root;
+      table[i].op = (unsigned char)(PAK_OP_LINK | subBits[i]);
+      table[i].val = subOffset[i];
     }
   }
 
-  /* return actual size of base table */
-  *m = l[0];
+  for(i = 0; i < n; i++) {
+    PAK_code leaf;
+    leaf.op = extraBits ? extraBits[i] : 0;
+    leaf.val = base ? base[i] : (unsigned short)i;
+    len = lengths[i];
+
+    if(len <= root) {
+      leaf.bits = (unsigned char)len;
+      for(unsigned j = codes[i]; j < rootSize; j += 1u << len)
+        table[j] = leaf;
+    } else {
+      unsigned p = codes[i] & (rootSize - 1);
+      PAK_code * sub = table + subOffset[p];
+      leaf.bits = (unsigned char)(len - root);
+      for(unsigned j = codes[i] >> root; j < (1u << subBits[p]); j += 1u << (len - root))
+        sub[j] = leaf;
+    }
+  }
 
-  /* Return true (1) if we were given an incomplete table */
-  return((y!=0) && (g!=1));
+  return root;
 }
 
-/* Get the bit lengths for a code representation from the compressed stream. */
-int PAK_get_tree(PAK_stream * pG, unsigned * l, unsigned n) {
-  unsigned i;           /* unsigned chars remaining in list */
-  unsigned k;           /* lengths entered */
-  unsigned j;           /* number of codes */
-  unsigned b;           /* bit length for those codes */
+/* Reads the tree description at src and builds its table, unless it is the
+   one the table already holds. Returns the bytes read, 0 on a bad tree. */
+static unsigned PAK_get_tree(PAK_tree * tree, PAK_code * table, unsigned tableSize, unsigned maxRoot, const unsigned char * src, const unsigned char * srcEnd, unsigned n, const unsigned short * base, const unsigned char * extraBits) {
+  unsigned char desc[257];
+  unsigned lengths[256];
+  unsigned i, k;
 
-  /* get bit lengths */
-  i = PAK_NEXTBYTE + 1;                 /* length/count pairs to read */
-  k = 0;                                /* next code */
-  do {
-    b = ((j = PAK_NEXTBYTE) & 0xf) + 1; /* bits in code (1..16) */
-    j = ((j & 0xf0) >> 4) + 1;          /* codes with those bits (1..16) */
-    if(k + j > n) return(4);            /* don't overflow l[] */
+  const unsigned size = ((src < srcEnd) ? src[0] : 0) + 2;   // count byte, then length/count pairs
+  for(i = 0; i < size; i++)
+    desc[i] = (src + i < srcEnd) ? src[i] : 0;
+
+  if(tree->root && tree->size == size && tree->base == base && !memcmp(tree->desc, desc, size))
+    return size;
+
+  tree->root = 0;
+
+  k = 0;
+  for(i = 1; i < size; i++) {
+    unsigned b = (desc[i] & 0xf) + 1;           /* bits in code (1..16) */
+    unsigned j = ((desc[i] & 0xf0) >> 4) + 1;   /* codes with those bits (1..16) */
+    if(k + j > n) return 0;
     do {
-      l[k++] = b;
+      lengths[k++] = b;
     } while(--j);
-  } while(--i);
-  return((k!=n)?4:0);                   /* should have read n of them */
+  }
+  if(k != n) return 0;
+
+  tree->root = PAK_build_table(table, tableSize, maxRoot, lengths, n, base, extraBits);
+  if(!tree->root) return 0;
+
+  memcpy(tree->desc, desc, size);
+  tree->size = size;
+  tree->base = base;
+
+  return size;
 }
 
-/* Decompress the imploded data using coded literals and a sliding window (of size 2^(6+bdl) bytes). */
-int PAK_explode_lit(PAK_stream * pG, PAK_huft * tb, PAK_huft * tl, PAK_huft * td, unsigned bb, unsigned bl, unsigned bd, unsigned bdl) {
-  unsigned long s;      /* bytes to decompress */
-  unsigned e;  /* table entry flag/number of extra bits */
-  unsigned n, d;        /* length and index for copy */
-  unsigned w;           /* current window position */
-  PAK_huft *t;          /* pointer to table entry */
-  unsigned mb, ml, md;  /* masks for bb, bl, and bd bits */
-  unsigned mdl;         /* mask for bdl (distance lower) bits */
-  unsigned long b; /* bit buffer */
-  unsigned k;  /* number of bits in bit buffer */
-  unsigned u;           /* true if unPAK_FLUSHed */
-
-  /* explode the coded data */
-  b = k = w = 0;                /* initialize bit buffer, window */
-  u = 1;                        /* buffer unPAK_FLUSHed */
-  mb = PAK_mask_bits[bb];       /* precompute masks for speed */
-  ml = PAK_mask_bits[bl];
-  md = PAK_mask_bits[bd];
-  mdl = PAK_mask_bits[bdl];
-  s = pG->ucsize;
-  while(s>0) {                 /* do until ucsize bytes uncompressed */
-    PAK_NEEDBITS(1)
-    if(b & 1) {                /* then literal--decode it */
-      PAK_DUMPBITS(1)
-      s--;
-      PAK_DECODEHUFT(tb, bb, mb)    /* get coded literal */
-      PAK_slide[w++] = (unsigned char)t->v.n;
-      if(w == PAK_WSIZE) {
-        PAK_FLUSH(w)
-        w = u = 0;
-      }
+/* Copies a match. Before the first 32K of output, the old window was still
+   zeroed, so whatever reaches back past the start reads as zeros. */
+static inline unsigned char * PAK_copy(unsigned char * out, unsigned char * outEnd, unsigned char * dst, unsigned dist, unsigned len) {
+  if(len > (size_t)(outEnd - out)) len = (unsigned)(outEnd - out);
+
+  const size_t done = out - dst;
+  if(dist > done) {
+    unsigned zeros = dist - (unsigned)done;
+    if(zeros > len) zeros = len;
+    memset(out, 0, zeros);
+    out += zeros;
+    len -= zeros;
+  }
+
+  const unsigned char * from = out - dist;
+  if(dist >= len) {
+    memcpy(out, from, len);
+    out += len;
+  } else {
+    while(len--) *out++ = *from++;
+  }
+  return out;
+}
+
+/* Decompress the imploded data using coded literals. */
+static int PAK_explode_lit(const unsigned char * src, const unsigned char * srcEnd, unsigned char * dst, unsigned char * outEnd, unsigned bdl) {
+  const PAK_code * const tb = PAK_tables.lit;
+  const PAK_code * const tl = PAK_tables.len;
+  const PAK_code * const td = PAK_tables.dist;
+  const unsigned bb = PAK_tables.litTree.root;
+  const unsigned bl = PAK_tables.lenTree.root;
+  const unsigned bd = PAK_tables.distTree.root;
+  const unsigned mdl = (1u << bdl) - 1;
+  const PAK_code * t;
+  unsigned char * out = dst;
+  uint64_t b = 0;       /* bit buffer */
+  unsigned k = 0;       /* number of bits in bit buffer */
+
+  while(out < outEnd) {
+    PAK_REFILL()
+    if(b & 1) {                 /* then literal--decode it */
+      /* then as many literals as the buffer is sure to hold */
+      do {
+        PAK_DUMPBITS(1)
+        PAK_DECODE(t, tb, bb)
+        *out++ = (unsigned char)t->val;
+      } while(k >= 1 + PAK_BMAX && (b & 1) && out < outEnd);
     } else {                    /* else distance/length */
       PAK_DUMPBITS(1)
-      PAK_NEEDBITS(bdl)             /* get distance low bits */
-      d = (unsigned)b & mdl;
+      unsigned d = (unsigned)b & mdl;   /* distance low bits */
       PAK_DUMPBITS(bdl)
-      PAK_DECODEHUFT(td, bd, md)    /* get coded distance high bits */
-      d = w - d - t->v.n;       /* construct offset */
-      PAK_DECODEHUFT(tl, bl, ml)    /* get coded length */
-      n = t->v.n;
-      if(e) {                    /* get length extra bits */
-        PAK_NEEDBITS(8)
+      PAK_DECODE(t, td, bd)     /* coded distance high bits */
+      d += t->val;
+      PAK_DECODE(t, tl, bl)     /* coded length */
+      unsigned n = t->val;
+      if(t->op) {               /* length extra bits */
         n += (unsigned)b & 0xff;
         PAK_DUMPBITS(8)
       }
-      s = (s > (unsigned long)n ? s - (unsigned long)n : 0);
-      do {
-        e = PAK_WSIZE - ((d &= PAK_WSIZE-1) > w ? d : w);
-        if(e>n) e = n;
-        n -= e;
-        if(u && (w<=d)) {
-          memset(PAK_slide + w, 0, e);
-          w += e;
-          d += e;
-        } else {
-          if(w-d >= e) {    // Fast memcopy for large block
-            memcpy(PAK_slide + w, PAK_slide + d, e);
-            w += e;
-            d += e;
-          } else {          // Slow memcopy for small block
-            do {
-              PAK_slide[w++] = PAK_slide[d++];
-            } while(--e);
-          }
-        }
-        if(w == PAK_WSIZE) {
-          PAK_FLUSH(w)
-          w = u = 0;
-        }
-      } while(n);
+      out = PAK_copy(out, outEnd, dst, d, n);
     }
   }
-  PAK_FLUSH(w)
-  return(0);
+  return 0;
 }
 
-/* Decompress the imploded data using uncoded literals and a sliding window (of size 2^(6+bdl) bytes). */
-int PAK_explode_nolit(PAK_stream * pG, PAK_huft * tl, PAK_huft * td, unsigned bl, unsigned bd, unsigned bdl) {
-  unsigned long s;      /* unsigned chars to decompress */
-  unsigned e;  /* table entry flag/number of PAK_extra bits */
-  unsigned n, d;        /* length and index for copy */
-  unsigned w;           /* current window position */
-  PAK_huft *t;          /* pointer to table entry */
-  unsigned ml, md;      /* masks for bl and bd bits */
-  unsigned mdl;         /* mask for bdl (distance lower) bits */
-  unsigned long b; /* bit buffer */
-  unsigned k;  /* number of bits in bit buffer */
-  unsigned u;           /* true if unPAK_FLUSHed */
-
-  /* explode the coded data */
-  b = k = w = 0;                /* initialize bit buffer, window */
-  u = 1;                        /* buffer unPAK_FLUSHed */
-  ml = PAK_mask_bits[bl];           /* precompute masks for speed */
-  md = PAK_mask_bits[bd];
-  mdl = PAK_mask_bits[bdl];
-  s = pG->ucsize;
-  while(s>0) {
-    PAK_NEEDBITS(1)
-    if(b & 1) {                 /* then literal--get eight bits */
-      PAK_DUMPBITS(1)
-      s--;
-      PAK_NEEDBITS(8)
-      PAK_slide[w++] = (unsigned char)b;
-      if(w==PAK_WSIZE) {
-        PAK_FLUSH(w)
-        w = u = 0;
-      }
-      PAK_DUMPBITS(8)
+/* Decompress the imploded data using uncoded literals. */
+static int PAK_explode_nolit(const unsigned char * src, const unsigned char * srcEnd, unsigned char * dst, unsigned char * outEnd, unsigned bdl) {
+  const PAK_code * const tl = PAK_tables.len;
+  const PAK_code * const td = PAK_tables.dist;
+  const unsigned bl = PAK_tables.lenTree.root;
+  const unsigned bd = PAK_tables.distTree.root;
+  const unsigned mdl = (1u << bdl) - 1;
+  const PAK_code * t;
+  unsigned char * out = dst;
+  uint64_t b = 0;       /* bit buffer */
+  unsigned k = 0;       /* number of bits in bit buffer */
+
+  while(out < outEnd) {
+    PAK_REFILL()
+    if(b & 1) {
+      /* literals are flag + eight bits, take as many as the buffer holds */
+      do {
+        *out++ = (unsigned char)(b >> 1);
+        PAK_DUMPBITS(9)
+      } while(k >= 9 && (b & 1) && out < outEnd);
     } else {
       PAK_DUMPBITS(1)
-      PAK_NEEDBITS(bdl)             /* get distance low bits */
-      d = (unsigned)b & mdl;
+      unsigned d = (unsigned)b & mdl;   /* distance low bits */
       PAK_DUMPBITS(bdl)
-      PAK_DECODEHUFT(td, bd, md)    /* get coded distance high bits */
-      d = w - d - t->v.n;       /* conPAK_huftoffset */
-      PAK_DECODEHUFT(tl, bl, ml)    /* get coded length */
-      n = t->v.n;
-      if(e) {                   /* get length PAK_extra bits */
-        PAK_NEEDBITS(8)
+      PAK_DECODE(t, td, bd)     /* coded distance high bits */
+      d += t->val;
+      PAK_DECODE(t, tl, bl)     /* coded length */
+      unsigned n = t->val;
+      if(t->op) {               /* length extra bits */
         n += (unsigned)b & 0xff;
         PAK_DUMPBITS(8)
       }
-      s = (s > (unsigned long)n ? s - (unsigned long)n : 0);
-      do {
-        e = PAK_WSIZE - ((d &= PAK_WSIZE-1) > w ? d : w);
-        if(e > n) e = n;
-        n -= e;
-        if(u && w <= d) {
-          memset(PAK_slide + w, 0, e);
-          w += e;
-          d += e;
-        } else {
-          if(w-d >= e) {    // Fast memcopy for large block
-            memcpy(PAK_slide + w, PAK_slide + d, e);
-            w += e;
-            d += e;
-          } else {          // Slow memcopy for small block
-            do {
-              PAK_slide[w++] = PAK_slide[d++];
-            } while(--e);
-          }
-        }
-        if(w==PAK_WSIZE) {
-          PAK_FLUSH(w)
-          w = u = 0;
-        }
-      } while(n);
+      out = PAK_copy(out, outEnd, dst, d, n);
     }
   }
-  PAK_FLUSH(w)
-  return(0);
+  return 0;
 }
 
 // --------------------------------------------------------------
@@ -482,59 +400,36 @@ int PAK_explode(unsigned char * srcBuffer, unsigned char * dstBuffer, unsigned i
   if(!srcBuffer || !dstBuffer || compressedSize == 0 || uncompressedSize == 0)
     return -1;
 
-  PAK_huft * tb;        /* literal code table */
-  PAK_huft * tl;        /* length code table */
-  PAK_huft * td;        /* distance code table */
-  unsigned bb;          /* bits for tb */
-  unsigned bl;          /* bits for tl */
-  unsigned bd;          /* bits for td */
-  unsigned bdl;         /* number of uncoded lower distance bits */
-  unsigned l[256];      /* bit lengths for codes */
-
-  PAK_stream G;
-  G.buf_src = srcBuffer;
-  G.buf_dst = dstBuffer;
-  G.off_src = 0;
-  G.off_dst = 0;
-  G.csize = compressedSize;
-  G.ucsize = uncompressedSize;
-
-  bl = 7;
-  bd = (compressedSize > 200000L) ? 8 : 7; // TODO : Totalement FOIREUX, a verifier
+  const unsigned char * src = srcBuffer;
+  const unsigned char * srcEnd = srcBuffer + compressedSize;
+  unsigned size;
+
+#define PAK_SKIP(n) { src += ((n) < (size_t)(srcEnd - src)) ? (n) : (size_t)(srcEnd - src); }
 
   if(flags & 4) {    // With literal tree--minimum match length is 3
-    bb = 9;
-    PAK_get_tree(&G, l, 256);
-    PAK_huft_build(&G, l, 256, 256, NULL, NULL, &tb, &bb);
-    PAK_get_tree(&G, l, 64);
-    PAK_huft_build(&G, l, 64, 0, cplen3, extra, &tl, &bl);
+    size = PAK_get_tree(&PAK_tables.litTree, PAK_tables.lit, PAK_LIT_ENOUGH, PAK_LIT_ROOT, src, srcEnd, 256, NULL, NULL);
+    if(!size) return 1;
+    PAK_SKIP(size)
+    size = PAK_get_tree(&PAK_tables.lenTree, PAK_tables.len, PAK_LEN_ENOUGH, PAK_LEN_ROOT, src, srcEnd, 64, cplen3, extra);
   } else {                // No literal tree--minimum match length is 2
-    tb = (PAK_huft *) NULL;
-    PAK_get_tree(&G, l, 64);
-    PAK_huft_build(&G, l, 64, 0, cplen2, extra, &tl, &bl);
+    size = PAK_get_tree(&PAK_tables.lenTree, PAK_tables.len, PAK_LEN_ENOUGH, PAK_LEN_ROOT, src, srcEnd, 64, cplen2, extra);
   }
+  if(!size) return 1;
+  PAK_SKIP(size)
 
-  PAK_get_tree(&G, l, 64);
+  // the distance extra bits are the uncoded low bits, read apart
+  size = PAK_get_tree(&PAK_tables.distTree, PAK_tables.dist, PAK_LEN_ENOUGH, PAK_LEN_ROOT, src, srcEnd, 64, (flags & 2) ? cpdist8 : cpdist4, NULL);
+  if(!size) return 1;
+  PAK_SKIP(size)
 
-  if(flags & 2) {     /* true if 8K */
-    bdl = 7;
-    PAK_huft_build(&G, l, 64, 0, cpdist8, extra, &td, &bd);
-  } else {                 /* else 4K */
-    bdl = 6;
-    PAK_huft_build(&G, l, 64, 0, cpdist4, extra, &td, &bd);
-  }
+#undef PAK_SKIP
 
-  if(tb!=NULL) {
-    PAK_explode_lit(&G, tb, tl, td, bb, bl, bd, bdl);
-    PAK_huft_free(&G, tb);
-  } else {
-    PAK_explode_nolit(&G, tl, td, bl, bd, bdl);
-  }
+  const unsigned bdl = (flags & 2) ? 7 : 6;     /* uncoded lower distance bits, 8K or 4K window */
 
-  PAK_huft_free(&G, td);
-  PAK_huft_free(&G, tl);
+  if(flags & 4)
+    return PAK_explode_lit(src, srcEnd, dstBuffer, dstBuffer + uncompressedSize, bdl);
 
-  return(0);
+  return PAK_explode_nolit(src, srcEnd, dstBuffer, dstBuffer + uncompressedSize, bdl);
 }
 
 // --------------------------------------------------------------
@@ -90,6 +90,7 @@ char* screenSm4;
 char* screenSm5;
 
 std::array<tObject, NUM_MAX_OBJECT> ListObjets;
+std::array<sPoseInstance, NUM_MAX_OBJECT> ListPoses;
 
 s16 currentWorldTarget;
 
@@ -207,11 +208,14 @@ s16 readNextArgument(const char* name)
 bool cameraBackgroundChanged = false;
 int flagRedraw;
 
-float renderPointList[6400];
+RENDER_CONTEXT float renderPointList[6400];
 
 int NbAffObjets;
 std::array<int, NUM_MAX_OBJECT> Index;
 
+int NbActiveObjets = 0;
+std::array<int, NUM_MAX_OBJECT> ActiveObjets;
+
 int angleCompX;
 int angleCompZ;
 int angleCompBeta;
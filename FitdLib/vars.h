@@ -19,6 +19,7 @@
 #pragma  once
 
 #include "osystem.h"
+#include "animInterpolate.h"
 
 #include <array>
 #include <vector>
@@ -430,11 +431,23 @@ s16 readNextArgument(const char* name = NULL);
 extern bool cameraBackgroundChanged;
 extern int flagRedraw;
 
-extern float renderPointList[6400];
+// Storage of the renderer's per-object state (renderPointList, pointBuffer,
+// BBox3D...): one copy per thread, so PrepareActors can display objects on
+// the job threads. The Dreamcast has no job threads.
+#ifdef DREAMCAST
+#define RENDER_CONTEXT
+#else
+#define RENDER_CONTEXT thread_local
+#endif
+
+extern RENDER_CONTEXT float renderPointList[6400];
 
 extern int NbAffObjets;
 extern std::array<int, NUM_MAX_OBJECT> Index;
 
+extern int NbActiveObjets;
+extern std::array<int, NUM_MAX_OBJECT> ActiveObjets; // ListObjets slots with indexInWorld != -1, ascending
+
 extern int angleCompX;
 extern int angleCompZ;
 extern int angleCompBeta;
@@ -538,7 +551,7 @@ struct sGroup
     s16 m_baseVertices; // 4
     s8 m_orgGroup; // 6
     s8 m_numGroup; // 7
-    sGroupState m_state;//8
+    sGroupState m_state;//8 as loaded, the pose of an object is in its sPoseInstance
     // 0x16 / 0x22 (AITD2+) if Info_optimise
 };
 
@@ -557,6 +570,27 @@ enum primTypeEnum
     processPrim_PolyTexture10 = 10,
 };
 
+// Size of the arena allocated after a resource header, see sBody
+struct arenaSize
+{
+    size_t size;
+};
+
+// Fixed size view into a resource's arena
+template <typename T>
+struct arenaArray
+{
+    T* m_data = nullptr;
+    u32 m_size = 0;
+
+    u32 size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    T* data() const { return m_data; }
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+    T& operator[](u32 index) const { return m_data[index]; }
+};
+
 struct sPrimitive
 {
     primTypeEnum m_type;
@@ -564,7 +598,28 @@ struct sPrimitive
     u8 m_color;
     u8 m_even;
     u16 m_size;
-    std::vector<u16> m_points;
+    u16 m_numPoints;
+    const u16* m_points; // into sBody::m_pointIndices
+};
+
+// Vertices as separate x/y/z arrays
+struct sBodyVertices
+{
+    s16* x = nullptr;
+    s16* y = nullptr;
+    s16* z = nullptr;
+    u16 count = 0;
+
+    u32 size() const { return count; }
+};
+
+// Bone hierarchy of one group, flattened by createBodyFromPtr: the groups
+// whose pose reaches this group's vertices, in m_groupOrder order
+struct sGroupLink
+{
+    u16 m_chainStart; // into sBody::m_groupChains
+    u16 m_chainSize;
+    s16 m_baseGroup; // group holding m_baseVertices, -1 if none
 };
 
 struct sExtraBody
@@ -573,19 +628,47 @@ struct sExtraBody
 };
 
 // scratch buffer:
-// 4: u16 timer
-
+// 4: u16 timer, the start time of a new sPoseInstance
 
+// A body is a single allocation: the sBody is followed by an arena holding
+// the primitives, groups, bone hierarchy, vertices, point indices and scratch
+// buffer, which the members below point into. Allocate with
+// new (arenaSize{ size }) sBody, free with delete.
 struct sBody
 {
     void* m_raw;
+    u32 m_serial; // unique per loaded body, even if a later one reuses the address
 
     u16 m_flags; //0 size 0x2
     ZVStruct16 m_zv; //2 size 0xC
-    struct sFrame* startAnim = nullptr; // This is normally stored as 4 bytes at the beginning of scratchBuffer, but we store it here due to pointer size
-    std::vector<u8> m_scratchBuffer; //0xE size u16 + data
-    std::vector<point3dStruct> m_vertices; // size u16 count * 6
-    std::vector<u16> m_groupOrder; // size u16 * 2
-    std::vector<sGroup> m_groups; // size u16 
-    std::vector<sPrimitive> m_primitives;
+    arenaArray<u8> m_scratchBuffer; //0xE size u16 + data
+    sBodyVertices m_vertices; // size u16 count * 6
+    arenaArray<u16> m_groupOrder; // size u16 * 2
+    arenaArray<sGroup> m_groups; // size u16 
+    arenaArray<sGroupLink> m_groupLinks; // one per group
+    arenaArray<u16> m_groupChains;
+    bool m_flatGroups = false; // groups are disjoint vertex ranges, AnimateCloud poses each vertex once
+    arenaArray<sPrimitive> m_primitives;
+    arenaArray<u16> m_pointIndices; // every primitive's points, in primitive order
+
+    u8* arena() { return (u8*)(this + 1); }
+
+    static void* operator new(size_t size, arenaSize arena) { return ::operator new(size + arena.size); }
+    static void operator delete(void* ptr) { ::operator delete(ptr); }
+    static void operator delete(void* ptr, arenaSize) { ::operator delete(ptr); }
 };
+
+// Pose of a body for one object: the group states SetAnimObjet,
+// SetInterAnimObjet and AnimateCloud write, and the keyframe they blend from.
+// The sBody stays as loaded, so objects sharing a body animate and display
+// independently, on any thread.
+struct sPoseInstance
+{
+    u32 m_bodySerial = 0; // sBody::m_serial of the body posed, 0 if none
+    struct sFrame* m_startAnim = nullptr; // was stored at the beginning of the body's scratch buffer
+    u16 m_startTime = 0; // timer at the start of the keyframe, was at +4 in the scratch buffer
+    std::vector<sGroupState> m_groups; // one per sBody::m_groups
+    animChannelsStruct m_channels; // SetInterAnimObjet's blend from m_startAnim, m_channels.m_frame is nullptr whenever m_startAnim changes
+};
+
+extern std::array<sPoseInstance, NUM_MAX_OBJECT> ListPoses; // one per ListObjets slot
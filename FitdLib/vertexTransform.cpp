@@ -0,0 +1,383 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark vertex transform (Rendering)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+#include "common.h"
+
+#include "vertexTransform.h"
+#include "dc_fastmath.h"
+
+#include <algorithm>
+
+// Signed 16.16 to integer, truncating toward zero like C division
+static inline int q16Trunc(int64_t v)
+{
+    if (v >= 0)
+        return (int)(v >> 16);
+
+    // Safe abs for INT64_MIN (avoid UB from -v).
+    const uint64_t mag = (uint64_t)(-(v + 1)) + 1ULL;
+    return -(int)(mag >> 16);
+}
+
+// Same math as transformPoint
+static inline void cameraTransform(const projectParamsStruct& params, int X, int Y, int Z, int& outX, int& outY, int& outZ)
+{
+    int x;
+    int y;
+    int z;
+
+    if (params.useY)
+    {
+        const int64_t vx = (int64_t)X * (int64_t)params.ySin - (int64_t)Z * (int64_t)params.yCos;
+        const int64_t vz = (int64_t)X * (int64_t)params.yCos + (int64_t)Z * (int64_t)params.ySin;
+        x = q16Trunc(vx) << 1;
+        z = q16Trunc(vz) << 1;
+    }
+    else
+    {
+        x = X;
+        z = Z;
+    }
+
+    if (params.useX)
+    {
+        const int64_t vy = (int64_t)Y * (int64_t)params.xSin - (int64_t)z * (int64_t)params.xCos;
+        const int64_t vz = (int64_t)Y * (int64_t)params.xCos + (int64_t)z * (int64_t)params.xSin;
+        y = q16Trunc(vy) << 1;
+        z = q16Trunc(vz) << 1;
+    }
+    else
+    {
+        y = Y;
+    }
+
+    if (params.useZ)
+    {
+        const int64_t vx = (int64_t)x * (int64_t)params.zSin - (int64_t)y * (int64_t)params.zCos;
+        const int64_t vy = (int64_t)x * (int64_t)params.zCos + (int64_t)y * (int64_t)params.zSin;
+        x = q16Trunc(vx) << 1;
+        y = q16Trunc(vy) << 1;
+    }
+
+    outX = x;
+    outY = y;
+    outZ = z;
+}
+
+static inline void emitClipped(float* out)
+{
+    out[0] = -10000;
+    out[1] = -10000;
+    out[2] = -10000;
+}
+
+static inline void emitProjected(const projectParamsStruct& params, float X, float Y, float Z, float invZ, float* out, projectBBoxStruct& bbox)
+{
+    float transformedX = (X * params.fovX * invZ) + params.centerX;
+    float transformedY = (Y * params.fovY * invZ) + params.centerY;
+
+    out[0] = transformedX;
+    out[1] = transformedY;
+    out[2] = Z;
+
+    if (transformedX < bbox.x1)
+        bbox.x1 = (int)transformedX;
+
+    if (transformedX > bbox.x2)
+        bbox.x2 = (int)transformedX;
+
+    if (transformedY < bbox.y1)
+        bbox.y1 = (int)transformedY;
+
+    if (transformedY > bbox.y2)
+        bbox.y2 = (int)transformedY;
+}
+
+static inline void projectVertex(const projectParamsStruct& params, int X, int Y, int Z, float* out, projectBBoxStruct& bbox)
+{
+    X += params.renderX;
+    Y += params.renderY;
+    Z += params.renderZ;
+
+    int x;
+    int y;
+    int z;
+
+    if (params.cloud)
+    {
+        // camera space goes through an s16 buffer, clamped points included
+        s16 cameraX = -10000;
+        s16 cameraY = -10000;
+        s16 cameraZ = -10000;
+
+        if (Y <= 10000) // height clamp
+        {
+            cameraTransform(params, X, Y - params.translateY, Z, x, y, z);
+            cameraX = (s16)(float)x;
+            cameraY = (s16)(float)y;
+            cameraZ = (s16)(float)z;
+        }
+
+        float projectedZ = (float)cameraZ + params.perspective;
+        if (projectedZ <= 50) // clipping
+        {
+            emitClipped(out);
+            return;
+        }
+
+        emitProjected(params, (float)cameraX, (float)cameraY, projectedZ, fitd_rcpf_fast(projectedZ), out, bbox);
+    }
+    else
+    {
+        if (Y > 10000) // height clamp
+        {
+            emitClipped(out);
+            return;
+        }
+
+        cameraTransform(params, X, Y - params.translateY, Z, x, y, z);
+
+        float projectedZ = (float)z + params.perspective;
+        emitProjected(params, (float)x, (float)y, projectedZ, fitd_rcpf_fast(projectedZ), out, bbox);
+    }
+}
+
+void projectVerticesScalar(const projectParamsStruct& params, const s16* x, const s16* y, const s16* z, int stride, int count, float* out, projectBBoxStruct& bbox)
+{
+    for (int i = 0; i < count; i++)
+    {
+        projectVertex(params, x[i * stride], y[i * stride], z[i * stride], out + i * 3, bbox);
+    }
+}
+
+// The rotations run in double lanes: |coordinate| < 2^31 and |cosTable| < 2^15,
+// so every product and sum is exact and matches the int64 scalar math. Not
+// on the Dreamcast, where double is single precision. Only run on CPUs with
+// AVX2, picked at run time: on plain SSE2 the 4 wide double lanes are split in
+// halves and the batch runs about 2x slower than the scalar loop
+// (tools/vertexbench).
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(DREAMCAST)
+
+// built for AVX2 whatever the compiler flags, so the batch needs no -mavx
+#define PROJECT_BATCH_TARGET __attribute__((target("avx2")))
+
+typedef double projVec4d __attribute__((vector_size(32)));
+typedef int32_t projVec4i __attribute__((vector_size(16)));
+typedef uint32_t projVec4u __attribute__((vector_size(16)));
+typedef float projVec4f __attribute__((vector_size(16)));
+
+// q16Trunc(v) << 1 on 4 lanes, wrapped to int like the scalar code
+PROJECT_BATCH_TARGET static inline projVec4i q16TruncShift(projVec4d v)
+{
+    const projVec4i truncated = __builtin_convertvector(v * (1.0 / 65536.0), projVec4i);
+    return (projVec4i)((projVec4u)truncated << 1);
+}
+
+PROJECT_BATCH_TARGET static inline projVec4d toDouble(projVec4i v)
+{
+    return __builtin_convertvector(v, projVec4d);
+}
+
+// Folds the running box into bbox and resets it
+PROJECT_BATCH_TARGET static inline void flushBBox(projectBBoxStruct& bbox, projVec4i& minX, projVec4i& minY, projVec4i& maxX, projVec4i& maxY)
+{
+    for (int lane = 0; lane < 4; lane++)
+    {
+        bbox.x1 = std::min(bbox.x1, minX[lane]);
+        bbox.y1 = std::min(bbox.y1, minY[lane]);
+        bbox.x2 = std::max(bbox.x2, maxX[lane]);
+        bbox.y2 = std::max(bbox.y2, maxY[lane]);
+    }
+
+    minX = projVec4i{ INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX };
+    minY = minX;
+    maxX = projVec4i{ INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN };
+    maxY = maxX;
+}
+
+PROJECT_BATCH_TARGET static inline projVec4f reciprocal(projVec4f v)
+{
+    const projVec4f one = { 1.f, 1.f, 1.f, 1.f };
+    return one / v;
+}
+
+PROJECT_BATCH_TARGET static void projectVerticesBatch(const projectParamsStruct& params, const s16* x, const s16* y, const s16* z, int stride, int count, float* out, projectBBoxStruct& bbox)
+{
+    const double xSin = params.xSin;
+    const double xCos = params.xCos;
+    const double ySin = params.ySin;
+    const double yCos = params.yCos;
+    const double zSin = params.zSin;
+    const double zCos = params.zCos;
+
+    // running box of the vectorised lanes
+    projVec4i minX = { INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX };
+    projVec4i minY = minX;
+    projVec4i maxX = { INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN };
+    projVec4i maxY = maxX;
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const s16* px = x + i * stride;
+        const s16* py = y + i * stride;
+        const s16* pz = z + i * stride;
+
+        projVec4i X = { px[0], px[stride], px[stride * 2], px[stride * 3] };
+        projVec4i Y = { py[0], py[stride], py[stride * 2], py[stride * 3] };
+        projVec4i Z = { pz[0], pz[stride], pz[stride * 2], pz[stride * 3] };
+
+        X += params.renderX;
+        Y += params.renderY;
+        Z += params.renderZ;
+
+        const projVec4i clamped = Y > 10000; // height clamp, -1 per clamped lane
+        Y -= params.translateY;
+
+        if (params.useY)
+        {
+            const projVec4d dX = toDouble(X);
+            const projVec4d dZ = toDouble(Z);
+            X = q16TruncShift(dX * ySin - dZ * yCos);
+            Z = q16TruncShift(dX * yCos + dZ * ySin);
+        }
+
+        if (params.useX)
+        {
+            const projVec4d dY = toDouble(Y);
+            const projVec4d dZ = toDouble(Z);
+            Y = q16TruncShift(dY * xSin - dZ * xCos);
+            Z = q16TruncShift(dY * xCos + dZ * xSin);
+        }
+
+        if (params.useZ)
+        {
+            const projVec4d dX = toDouble(X);
+            const projVec4d dY = toDouble(Y);
+            X = q16TruncShift(dX * zSin - dY * zCos);
+            Y = q16TruncShift(dX * zCos + dY * zSin);
+        }
+
+        projVec4f fX = __builtin_convertvector(X, projVec4f);
+        projVec4f fY = __builtin_convertvector(Y, projVec4f);
+        projVec4f fZ = __builtin_convertvector(Z, projVec4f);
+
+        if (params.cloud)
+        {
+            // through s16, the clamped lanes at -10000
+            const projVec4i mask = clamped;
+            const projVec4i clampValue = { -10000, -10000, -10000, -10000 };
+
+            projVec4i cameraX = (projVec4i)((projVec4u)__builtin_convertvector(fX, projVec4i) << 16) >> 16;
+            projVec4i cameraY = (projVec4i)((projVec4u)__builtin_convertvector(fY, projVec4i) << 16) >> 16;
+            projVec4i cameraZ = (projVec4i)((projVec4u)__builtin_convertvector(fZ, projVec4i) << 16) >> 16;
+
+            cameraX = (cameraX & ~mask) | (clampValue & mask);
+            cameraY = (cameraY & ~mask) | (clampValue & mask);
+            cameraZ = (cameraZ & ~mask) | (clampValue & mask);
+
+            fX = __builtin_convertvector(cameraX, projVec4f);
+            fY = __builtin_convertvector(cameraY, projVec4f);
+            fZ = __builtin_convertvector(cameraZ, projVec4f);
+        }
+
+        fZ += params.perspective;
+
+        const projVec4f invZ = reciprocal(fZ);
+        const projVec4f transformedX = (fX * params.fovX * invZ) + params.centerX;
+        const projVec4f transformedY = (fY * params.fovY * invZ) + params.centerY;
+
+        const projVec4i clipped = params.cloud ? (projVec4i)(fZ <= 50) : clamped;
+        const projVec4f clipValue = { -10000.f, -10000.f, -10000.f, -10000.f };
+
+        const projVec4f outX = clipped ? clipValue : transformedX;
+        const projVec4f outY = clipped ? clipValue : transformedY;
+        const projVec4f outZ = clipped ? clipValue : fZ;
+
+        float* laneOut = out + i * 3;
+        for (int lane = 0; lane < 4; lane++)
+        {
+            laneOut[lane * 3 + 0] = outX[lane];
+            laneOut[lane * 3 + 1] = outY[lane];
+            laneOut[lane * 3 + 2] = outZ[lane];
+        }
+
+        // For anything (int) converts, the if (t < box) box = (int)t updates
+        // are a min/max of the truncated values, in any order. Lanes out of
+        // int range or NaN take the scalar updates, in vertex order.
+        const projVec4f intRange = { 2147483648.f, 2147483648.f, 2147483648.f, 2147483648.f };
+        const projVec4i inRange = (transformedX < intRange) & (transformedX > -intRange) & (transformedY < intRange) & (transformedY > -intRange);
+
+        if (((~clipped & ~inRange)[0] | (~clipped & ~inRange)[1] | (~clipped & ~inRange)[2] | (~clipped & ~inRange)[3]) == 0)
+        {
+            const projVec4i truncatedX = __builtin_convertvector(transformedX, projVec4i);
+            const projVec4i truncatedY = __builtin_convertvector(transformedY, projVec4i);
+
+            minX = (~clipped & (truncatedX < minX)) ? truncatedX : minX;
+            maxX = (~clipped & (truncatedX > maxX)) ? truncatedX : maxX;
+            minY = (~clipped & (truncatedY < minY)) ? truncatedY : minY;
+            maxY = (~clipped & (truncatedY > maxY)) ? truncatedY : maxY;
+        }
+        else
+        {
+            flushBBox(bbox, minX, minY, maxX, maxY);
+
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if (clipped[lane])
+                    continue;
+
+                if (transformedX[lane] < bbox.x1)
+                    bbox.x1 = (int)transformedX[lane];
+
+                if (transformedX[lane] > bbox.x2)
+                    bbox.x2 = (int)transformedX[lane];
+
+                if (transformedY[lane] < bbox.y1)
+                    bbox.y1 = (int)transformedY[lane];
+
+                if (transformedY[lane] > bbox.y2)
+                    bbox.y2 = (int)transformedY[lane];
+            }
+        }
+    }
+
+    flushBBox(bbox, minX, minY, maxX, maxY);
+
+    projectVerticesScalar(params, x + i * stride, y + i * stride, z + i * stride, stride, count - i, out + i * 3, bbox);
+}
+
+void projectVertices(const projectParamsStruct& params, const s16* x, const s16* y, const s16* z, int stride, int count, float* out, projectBBoxStruct& bbox)
+{
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+    if (hasAVX2)
+        projectVerticesBatch(params, x, y, z, stride, count, out, bbox);
+    else
+        projectVerticesScalar(params, x, y, z, stride, count, out, bbox);
+}
+
+#else
+
+void projectVertices(const projectParamsStruct& params, const s16* x, const s16* y, const s16* z, int stride, int count, float* out, projectBBoxStruct& bbox)
+{
+    projectVerticesScalar(params, x, y, z, stride, count, out, bbox);
+}
+
+#endif
@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark vertex transform (Rendering)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// Camera transform and perspective projection of a body's vertices into
+// renderPointList, 4 vertices at a time on x86 CPUs with AVX2 when built with
+// GCC or Clang. Results are bit exact with the one-vertex-at-a-time code
+// (projectVerticesScalar), which tools/vertexbench checks.
+
+struct projectParamsStruct
+{
+    int renderX;
+    int renderY;
+    int renderZ;
+    int translateY;
+
+    bool useX;
+    bool useY;
+    bool useZ;
+    int xSin;
+    int xCos;
+    int ySin;
+    int yCos;
+    int zSin;
+    int zCos;
+
+    float fovX;
+    float fovY;
+    float centerX;
+    float centerY;
+    float perspective;
+
+    // AnimateCloud: camera space coordinates wrap to s16 and vertices at
+    // Z <= 50 are clipped. RotateAndProjectBody does neither.
+    bool cloud;
+};
+
+struct projectBBoxStruct
+{
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+};
+
+// Projects count vertices read at x[i * stride], y[i * stride], z[i * stride]
+// into out (3 floats each), growing bbox.
+void projectVertices(const projectParamsStruct& params, const s16* x, const s16* y, const s16* z, int stride, int count, float* out, projectBBoxStruct& bbox);
+void projectVerticesScalar(const projectParamsStruct& params, const s16* x, const s16* y, const s16* z, int stride, int count, float* out, projectBBoxStruct& bbox);
@@ -0,0 +1,519 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark keyframe interpolation benchmark (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+// Checks that the channels of animInterpolate.cpp, batched and scalar, pose
+// the groups the same as the per bone interpolation they replaced
+// (interAnimReference), on every keyframe of every animation, from the
+// previous keyframe and from itself, with and without INFO_OPTIMISE. The
+// animations are the entries of a LISTANIM PAK, or generated ones with
+// extreme values and keyframe lengths when no PAK is given. Then times one
+// second (60 timer ticks) of SetInterAnimObjet's sampling for N actors,
+// keyframe changes included.
+//
+//   AnimBench [<LISTANIM.PAK>] [-n <actors>] [-r <repeats>] [-s <seed>]
+//
+// The exit code is 1 if any group differs.
+
+#include "common.h"
+
+#include "animInterpolate.h"
+#include "interAnimReference.h"
+#include "fitd_endian_read.h"
+#include "engineStubs.h"
+#include "toolUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+
+struct benchAnimationStruct
+{
+    int index;
+    bool optimised; // has the INFO_OPTIMISE rotate deltas
+    int numGroups;
+    std::vector<u16> timestamps;
+    std::vector<sGroupState> groups; // [frame][group]
+
+    int numFrames() const
+    {
+        return (int)timestamps.size();
+    }
+
+    const sGroupState* frame(int i) const
+    {
+        return groups.data() + i * numGroups;
+    }
+};
+
+// Same walk as createAnimationFromPtr
+static bool parseAnimation(u8* data, int size, benchAnimationStruct& animation)
+{
+    if (size < 4)
+        return false;
+
+    const int numFrames = READ_LE_U16(data);
+    const int numGroups = READ_LE_U16(data + 2);
+    data += 4;
+
+    const int fullSizeNoOptim = 4 + numFrames * (8 + numGroups * 8);
+    const int fullSizeWithOptim = 4 + numFrames * (8 + numGroups * 16);
+
+    if (size != fullSizeNoOptim && size != fullSizeWithOptim)
+        return false;
+
+    animation.optimised = size == fullSizeWithOptim && numGroups;
+    animation.numGroups = numGroups;
+    animation.timestamps.resize(numFrames);
+    animation.groups.resize(numFrames * numGroups);
+
+    for (int i = 0; i < numFrames; i++)
+    {
+        animation.timestamps[i] = READ_LE_U16(data);
+        data += 8;
+
+        for (int j = 0; j < numGroups; j++)
+        {
+            sGroupState& group = animation.groups[i * numGroups + j];
+
+            group.m_type = READ_LE_S16(data);
+            group.m_delta.x = READ_LE_S16(data + 2);
+            group.m_delta.y = READ_LE_S16(data + 4);
+            group.m_delta.z = READ_LE_S16(data + 6);
+            data += 8;
+
+            group.m_hasRotateDelta = animation.optimised;
+            group.m_rotateDelta = { 0, 0, 0 };
+            if (animation.optimised)
+            {
+                group.m_rotateDelta.x = READ_LE_S16(data);
+                group.m_rotateDelta.y = READ_LE_S16(data + 2);
+                group.m_rotateDelta.z = READ_LE_S16(data + 4);
+                data += 8;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool loadAnimations(const std::filesystem::path& pakFile, std::vector<benchAnimationStruct>& animations)
+{
+    std::string directory = pakFile.parent_path().string();
+    if (directory.empty())
+        directory = ".";
+    snprintf(homePath, sizeof(homePath), "%s/", directory.c_str());
+
+    std::string name = pakFile.stem().string();
+    unsigned int numFiles = PAK_getNumFiles(name.c_str());
+
+    for (unsigned int i = 0; i < numFiles; i++)
+    {
+        int size = getPakSize(name.c_str(), i);
+        char* data = loadPak(name.c_str(), i);
+
+        benchAnimationStruct animation;
+        animation.index = i;
+
+        if (data && parseAnimation((u8*)data, size, animation))
+            animations.push_back(std::move(animation));
+        else
+            printf("entry %d: not an animation\n", i);
+
+        free(data);
+    }
+
+    PAK_CloseAll();
+
+    return numFiles != 0;
+}
+
+static s16 randomValue(std::mt19937& random, bool angle)
+{
+    switch (random() % 8)
+    {
+    case 0: // anything, the s16 extremes included
+        return (s16)(random() % 4 ? random() : (random() % 2 ? 0x7FFF : -0x8000));
+    case 1:
+        return 0;
+    default:
+        return angle ? (s16)(random() % 0x400) : (s16)((int)(random() % 2000) - 1000);
+    }
+}
+
+static std::vector<benchAnimationStruct> syntheticAnimations(std::mt19937& random, int count)
+{
+    std::vector<benchAnimationStruct> animations(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        benchAnimationStruct& animation = animations[i];
+        animation.index = i;
+        animation.optimised = random() % 2;
+        animation.numGroups = 1 + random() % 40;
+        animation.timestamps.resize(2 + random() % 8);
+        animation.groups.resize(animation.numFrames() * animation.numGroups);
+
+        for (u16& timestamp : animation.timestamps)
+        {
+            // keyframe lengths of the game, and up to the longest a u16 holds
+            timestamp = (u16)((random() % 8) ? 1 + random() % 60 : 1 + random() % 0xFFFF);
+        }
+
+        // the type of a bone stays the same over the animation, mostly
+        std::vector<s16> types(animation.numGroups);
+        for (s16& type : types)
+        {
+            type = (s16)(random() % 16 ? random() % 3 : random() % 5);
+        }
+
+        for (int frame = 0; frame < animation.numFrames(); frame++)
+        {
+            for (int j = 0; j < animation.numGroups; j++)
+            {
+                sGroupState& group = animation.groups[frame * animation.numGroups + j];
+                group.m_type = (random() % 8) ? types[j] : (s16)(random() % 3);
+
+                group.m_delta.x = randomValue(random, group.m_type == 0);
+                group.m_delta.y = randomValue(random, group.m_type == 0);
+                group.m_delta.z = randomValue(random, group.m_type == 0);
+
+                group.m_hasRotateDelta = animation.optimised && (random() % 16) != 0;
+                group.m_rotateDelta.x = randomValue(random, true);
+                group.m_rotateDelta.y = randomValue(random, true);
+                group.m_rotateDelta.z = randomValue(random, true);
+            }
+        }
+    }
+
+    return animations;
+}
+
+static bool samePoint(const point3dStruct& a, const point3dStruct& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// Index of the first group that differs, -1 if none
+static int comparePoses(const std::vector<sGroupState>& expected, const std::vector<sGroupState>& output)
+{
+    for (int i = 0; i < (int)expected.size(); i++)
+    {
+        const sGroupState& a = expected[i];
+        const sGroupState& b = output[i];
+
+        if (a.m_type != b.m_type || !samePoint(a.m_delta, b.m_delta) || a.m_hasRotateDelta != b.m_hasRotateDelta || !samePoint(a.m_rotateDelta, b.m_rotateDelta))
+            return i;
+    }
+
+    return -1;
+}
+
+// Times sampled from a keyframe: all of them, or the first and last ones and
+// some in between for the long keyframes
+static std::vector<int> sampleTimes(std::mt19937& random, int keyframeLength)
+{
+    std::vector<int> times;
+
+    if (keyframeLength <= 512)
+    {
+        for (int time = 0; time < keyframeLength; time++)
+            times.push_back(time);
+    }
+    else
+    {
+        for (int time = 0; time < 128; time++)
+        {
+            times.push_back(time);
+            times.push_back(keyframeLength - 128 + time);
+        }
+        for (int i = 0; i < 256; i++)
+            times.push_back(random() % keyframeLength);
+
+        std::sort(times.begin(), times.end());
+    }
+
+    return times;
+}
+
+// Returns the number of mismatching samples, counting them in numSamples.
+static int checkAnimation(std::mt19937& random, const benchAnimationStruct& animation, int& numSamples)
+{
+    int mismatches = 0;
+    const int numGroups = animation.numGroups;
+
+    for (int optimise = 0; optimise < 2; optimise++)
+    {
+        for (int frame = 0; frame < animation.numFrames(); frame++)
+        {
+            const sGroupState* next = animation.frame(frame);
+            const int keyframeLength = animation.timestamps[frame];
+
+            // from the keyframe before (looping), or from itself like with no
+            // m_startAnim
+            for (int from = 0; from < 2 && keyframeLength; from++)
+            {
+                const sGroupState* previous = from ? next : animation.frame((frame + animation.numFrames() - 1) % animation.numFrames());
+
+                // the pose as SetAnimObjet left it, some rotate deltas missing
+                std::vector<sGroupState> expected(previous, previous + numGroups);
+                for (sGroupState& group : expected)
+                {
+                    if (random() % 16 == 0)
+                        group.m_hasRotateDelta = false;
+                }
+
+                std::vector<sGroupState> batched = expected;
+                std::vector<sGroupState> scalar = expected;
+
+                animChannelsStruct channels;
+                buildAnimChannels(channels, batched.data(), previous, next, numGroups, optimise != 0, nullptr, keyframeLength);
+                buildAnimChannels(channels, scalar.data(), previous, next, numGroups, optimise != 0, nullptr, keyframeLength);
+
+                for (int time : sampleTimes(random, keyframeLength))
+                {
+                    interAnimReference(expected.data(), previous, next, numGroups, optimise != 0, time, keyframeLength);
+                    interpolateAnimChannels(channels, time, batched.data());
+                    interpolateAnimChannelsScalar(channels, time, scalar.data());
+                    numSamples++;
+
+                    int batchedGroup = comparePoses(expected, batched);
+                    int scalarGroup = comparePoses(expected, scalar);
+
+                    if (batchedGroup >= 0 || scalarGroup >= 0)
+                    {
+                        int group = batchedGroup >= 0 ? batchedGroup : scalarGroup;
+                        const sGroupState& a = expected[group];
+                        const sGroupState& b = batchedGroup >= 0 ? batched[group] : scalar[group];
+
+                        printf("animation %d frame %d%s%s, time %d/%d, group %d (%s): type %d (%d %d %d) (%d %d %d), expected type %d (%d %d %d) (%d %d %d)\n",
+                            animation.index, frame, from ? " from itself" : "", optimise ? " optimised" : "", time, keyframeLength, group, batchedGroup >= 0 ? "batched" : "scalar",
+                            b.m_type, b.m_delta.x, b.m_delta.y, b.m_delta.z, b.m_rotateDelta.x, b.m_rotateDelta.y, b.m_rotateDelta.z,
+                            a.m_type, a.m_delta.x, a.m_delta.y, a.m_delta.z, a.m_rotateDelta.x, a.m_rotateDelta.y, a.m_rotateDelta.z);
+
+                        mismatches++;
+                        batched = expected;
+                        scalar = expected;
+                    }
+                }
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+//----------------------------------------------------------------------------
+// Sampling benchmark
+//----------------------------------------------------------------------------
+
+struct benchActorStruct
+{
+    const benchAnimationStruct* animation;
+    int frame;
+    const sGroupState* startAnim;
+    int startTime;
+    std::vector<sGroupState> pose;
+    animChannelsStruct channels;
+    bool channelsBuilt;
+};
+
+enum benchPath
+{
+    BENCH_REFERENCE,
+    BENCH_SCALAR,
+    BENCH_BATCHED,
+    BENCH_NUM_PATHS
+};
+
+static const char* s_pathNames[BENCH_NUM_PATHS] = { "reference", "scalar", "batched" };
+
+// SetInterAnimObjet on every actor at each tick: blends the keyframe, or
+// moves on to the next one once it's over
+static void sampleActors(std::vector<benchActorStruct>& actors, int tick, benchPath path)
+{
+    for (benchActorStruct& actor : actors)
+    {
+        const benchAnimationStruct& animation = *actor.animation;
+        const sGroupState* next = animation.frame(actor.frame);
+        const int keyframeLength = animation.timestamps[actor.frame];
+        const int time = tick - actor.startTime;
+
+        if (time < keyframeLength)
+        {
+            if (path == BENCH_REFERENCE)
+            {
+                interAnimReference(actor.pose.data(), actor.startAnim, next, animation.numGroups, animation.optimised, time, keyframeLength);
+            }
+            else
+            {
+                if (!actor.channelsBuilt)
+                {
+                    buildAnimChannels(actor.channels, actor.pose.data(), actor.startAnim, next, animation.numGroups, animation.optimised, nullptr, keyframeLength);
+                    actor.channelsBuilt = true;
+                }
+
+                if (path == BENCH_BATCHED)
+                    interpolateAnimChannels(actor.channels, time, actor.pose.data());
+                else
+                    interpolateAnimChannelsScalar(actor.channels, time, actor.pose.data());
+            }
+        }
+        else
+        {
+            std::copy(next, next + animation.numGroups, actor.pose.begin());
+            actor.startAnim = next;
+            actor.startTime = tick;
+            actor.channelsBuilt = false;
+            actor.frame = (actor.frame + 1) % animation.numFrames();
+        }
+    }
+}
+
+static void bench(std::mt19937& random, const std::vector<benchAnimationStruct>& animations, int numActors, int repeats)
+{
+    // the animations an actor can play, keyframes of the game's lengths
+    std::vector<const benchAnimationStruct*> playable;
+    for (const benchAnimationStruct& animation : animations)
+    {
+        bool playableFrames = animation.numFrames() && animation.numGroups;
+        for (u16 timestamp : animation.timestamps)
+            playableFrames = playableFrames && timestamp && timestamp <= 600;
+
+        if (playableFrames)
+            playable.push_back(&animation);
+    }
+
+    if (playable.empty())
+    {
+        printf("no animation to play\n");
+        return;
+    }
+
+    std::vector<benchActorStruct> start(numActors);
+    for (benchActorStruct& actor : start)
+    {
+        actor.animation = playable[random() % playable.size()];
+        actor.frame = random() % actor.animation->numFrames();
+        actor.startAnim = actor.animation->frame(actor.frame);
+        actor.startTime = -(int)(random() % actor.animation->timestamps[actor.frame]);
+        actor.pose.assign(actor.startAnim, actor.startAnim + actor.animation->numGroups);
+        actor.channelsBuilt = false;
+        actor.frame = (actor.frame + 1) % actor.animation->numFrames();
+    }
+
+    printf("\n%d actors, 1 second (60 ticks)\n", numActors);
+
+    for (int path = 0; path < BENCH_NUM_PATHS; path++)
+    {
+        std::vector<double> latencies;
+
+        for (int i = 0; i < repeats; i++)
+        {
+            std::vector<benchActorStruct> actors = start;
+
+            auto begin = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < 60; tick++)
+            {
+                sampleActors(actors, tick, (benchPath)path);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            latencies.push_back(std::chrono::duration<double>(end - begin).count() * 1000000.0);
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        double total = 0;
+        for (double latency : latencies)
+            total += latency;
+
+        printf("%-10s %9.2f Msamples/s  p50 %8.1f  p90 %8.1f  p99 %8.1f us\n", s_pathNames[path],
+            total > 0 ? 60.0 * numActors * repeats / total : 0,
+            percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* pakFile = nullptr;
+    int numActors = 100;
+    int repeats = 100;
+    unsigned int seed = 1234;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+        {
+            numActors = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+        {
+            repeats = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+        {
+            seed = (unsigned int)atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-' && !pakFile)
+        {
+            pakFile = argv[i];
+        }
+        else
+        {
+            printf("usage: AnimBench [<LISTANIM.PAK>] [-n <actors>] [-r <repeats>] [-s <seed>]\n");
+            return 1;
+        }
+    }
+
+    if (numActors < 1 || repeats < 1)
+    {
+        printf("usage: AnimBench [<LISTANIM.PAK>] [-n <actors>] [-r <repeats>] [-s <seed>]\n");
+        return 1;
+    }
+
+    std::mt19937 random(seed);
+    std::vector<benchAnimationStruct> animations;
+
+    if (pakFile)
+    {
+        if (!loadAnimations(pakFile, animations))
+        {
+            printf("Can't read %s\n", pakFile);
+            return 1;
+        }
+    }
+    else
+    {
+        animations = syntheticAnimations(random, 2000);
+    }
+
+    int numSamples = 0;
+    int mismatches = 0;
+    for (const benchAnimationStruct& animation : animations)
+    {
+        mismatches += checkAnimation(random, animation, numSamples);
+    }
+
+    printf("%d animations, %d samples, %d mismatches\n", (int)animations.size(), numSamples, mismatches);
+
+    bench(random, animations, numActors, repeats);
+
+    return mismatches ? 1 : 0;
+}
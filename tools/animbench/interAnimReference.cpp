@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark reference keyframe interpolation (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "common.h"
+
+#include "interAnimReference.h"
+
+static s16 PatchType(sGroupState* bodyPtr, u16 type)
+{
+    bodyPtr->m_type = type;
+
+    return(bodyPtr->m_type);
+}
+
+static void PatchInterAngle(s16* value, s16 previousValue, s16 nextValue, int bp, int bx)
+{
+    s16 diff = nextValue - previousValue;
+
+    if(diff == 0)
+    {
+        *value = nextValue;
+    }
+    else
+    {
+        if(diff <= 0x200)
+        {
+            if(diff >= -0x200)
+            {
+                *value = ((diff*bp)/bx) + previousValue;
+            }
+            else
+            {
+                nextValue += 0x400;
+                nextValue -= previousValue;
+
+                *value = ((nextValue *bp)/bx) + previousValue;
+            }
+        }
+        else
+        {
+            previousValue += 0x400;
+            nextValue -= previousValue;
+
+            *value = ((nextValue *bp)/bx) + previousValue;
+        }
+    }
+}
+
+static void PatchInterStep(s16* value, s16 previousValue, s16 nextValue, int bp, int bx)
+{
+    s16 cx = previousValue;
+    s16 ax = nextValue;
+
+    if(ax == cx)
+    {
+        *value = ax;
+    }
+    else
+    {
+        // (ax - cx) * bp only leaves int range for steps past 0x7FFF late in
+        // a long keyframe, where the 32-bit multiply it compiled to wraps
+        *value = ((s32)((u32)(ax - cx) * (u32)bp) / bx) + cx;
+    }
+}
+
+void interAnimReference(sGroupState* pose, const sGroupState* previous, const sGroupState* next, int numGroups, bool optimise, int bp, int bx)
+{
+    if (!optimise)
+    {
+        for (int i = 0; i < numGroups; i++)
+        {
+            point3dStruct& state = pose[i].m_delta;
+            const point3dStruct& previousState = previous[i].m_delta;
+            const point3dStruct& nextState = next[i].m_delta;
+            switch (PatchType(&pose[i], next[i].m_type))
+            {
+            case 0: // rotate
+                PatchInterAngle(&state.x, previousState.x, nextState.x, bp, bx);
+                PatchInterAngle(&state.y, previousState.y, nextState.y, bp, bx);
+                PatchInterAngle(&state.z, previousState.z, nextState.z, bp, bx);
+                break;
+            case 1: // translate
+            case 2: // zoom
+                PatchInterStep(&state.x, previousState.x, nextState.x, bp, bx);
+                PatchInterStep(&state.y, previousState.y, nextState.y, bp, bx);
+                PatchInterStep(&state.z, previousState.z, nextState.z, bp, bx);
+                break;
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numGroups; i++)
+        {
+            point3dStruct& state = pose[i].m_delta;
+            const point3dStruct& previousState = previous[i].m_delta;
+            const point3dStruct& nextState = next[i].m_delta;
+            switch (PatchType(&pose[i], next[i].m_type))
+            {
+            case 0:
+                break;
+            case 1:
+            case 2:
+                PatchInterStep(&state.x, previousState.x, nextState.x, bp, bx);
+                PatchInterStep(&state.y, previousState.y, nextState.y, bp, bx);
+                PatchInterStep(&state.z, previousState.z, nextState.z, bp, bx);
+                break;
+            }
+
+            if (!pose[i].m_hasRotateDelta ||
+                !previous[i].m_hasRotateDelta ||
+                !next[i].m_hasRotateDelta)
+            {
+                continue;
+            }
+
+            PatchInterAngle(&pose[i].m_rotateDelta.x, previous[i].m_rotateDelta.x, next[i].m_rotateDelta.x, bp, bx);
+            PatchInterAngle(&pose[i].m_rotateDelta.y, previous[i].m_rotateDelta.y, next[i].m_rotateDelta.y, bp, bx);
+            PatchInterAngle(&pose[i].m_rotateDelta.z, previous[i].m_rotateDelta.z, next[i].m_rotateDelta.z, bp, bx);
+        }
+    }
+}
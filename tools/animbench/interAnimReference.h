@@ -0,0 +1,26 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark reference keyframe interpolation (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// The interpolation SetInterAnimObjet did before the channels of
+// animInterpolate.cpp: one bone at a time, PatchType then PatchInterAngle or
+// PatchInterStep on each component, dividing by bx every time. AnimBench
+// checks the channels against it and times both.
+void interAnimReference(sGroupState* pose, const sGroupState* previous, const sGroupState* next, int numGroups, bool optimise, int bp, int bx);
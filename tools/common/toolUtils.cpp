@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark tool helpers (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+#include "common.h"
+
+#include "toolUtils.h"
+
+#include <algorithm>
+
+bool readFile(const std::filesystem::path& path, std::vector<u8>& data)
+{
+    FILE* fileHandle = fopen(path.string().c_str(), "rb");
+    if (!fileHandle)
+        return false;
+
+    fseek(fileHandle, 0, SEEK_END);
+    long size = ftell(fileHandle);
+    fseek(fileHandle, 0, SEEK_SET);
+
+    data.resize(size);
+    bool result = size == 0 || fread(data.data(), size, 1, fileHandle) == 1;
+    fclose(fileHandle);
+
+    return result;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
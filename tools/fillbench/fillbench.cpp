@@ -0,0 +1,292 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark polygon fill benchmark (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+// Checks that fillpoly draws the same pixels as the filler it replaced
+// (fillpolyReference), on random polygons partly or fully off screen, and
+// that every fillpolyMaterial material covers the same pixels as fillpoly.
+// Then times both fillers on sets of polygons the size of:
+//   - actor primitives (small)
+//   - mask polygons (medium)
+//   - room sized quads (large)
+//
+//   FillBench [-n <repeats>] [-s <seed>]
+//
+// The exit code is 1 if any pixel differs.
+
+#include "common.h"
+
+#include "polys.h"
+#include "fillpolyReference.h"
+#include "toolUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+struct polygonStruct
+{
+    std::vector<s16> points;
+    unsigned char color;
+
+    int numPoints() const
+    {
+        return (int)points.size() / 2;
+    }
+};
+
+// A star shaped polygon around (centerX, centerY): sorted angles keep it
+// simple, random radii make it concave.
+static polygonStruct randomPolygon(std::mt19937& random, int centerX, int centerY, int radius, int numPoints)
+{
+    std::vector<float> angles(numPoints);
+    for (float& angle : angles)
+    {
+        angle = (float)(random() % 3600) * (3.14159265f / 1800.f);
+    }
+    std::sort(angles.begin(), angles.end());
+
+    polygonStruct polygon;
+    polygon.color = (unsigned char)(1 + random() % 255);
+
+    for (float angle : angles)
+    {
+        float distance = (float)(radius / 2 + random() % (radius / 2 + 1));
+        polygon.points.push_back((s16)(centerX + cosf(angle) * distance));
+        polygon.points.push_back((s16)(centerY + sinf(angle) * distance));
+    }
+
+    return polygon;
+}
+
+static std::vector<polygonStruct> randomPolygons(std::mt19937& random, int count, int radius)
+{
+    std::vector<polygonStruct> polygons;
+
+    for (int i = 0; i < count; i++)
+    {
+        polygons.push_back(randomPolygon(random, (int)(random() % 320), (int)(random() % 200), radius, 3 + random() % 6));
+    }
+
+    return polygons;
+}
+
+static std::vector<unsigned char> s_expected(320 * 200);
+static std::vector<unsigned char> s_output(320 * 200);
+
+// Returns true if both fillers draw the same pixels.
+static bool compare(polygonStruct& polygon)
+{
+    std::fill(s_expected.begin(), s_expected.end(), 0);
+    std::fill(s_output.begin(), s_output.end(), 0);
+
+    polyBackBuffer = s_expected.data();
+    fillpolyReference(polygon.points.data(), polygon.numPoints(), polygon.color);
+    polyBackBuffer = s_output.data();
+    fillpoly(polygon.points.data(), polygon.numPoints(), polygon.color);
+    polyBackBuffer = nullptr;
+
+    if (memcmp(s_expected.data(), s_output.data(), 320 * 200))
+    {
+        for (int i = 0; i < 320 * 200; i++)
+        {
+            if (s_expected[i] != s_output[i])
+            {
+                printf("%d point polygon, pixel (%d %d): %d, expected %d\n", polygon.numPoints(), i % 320, i / 320, s_output[i], s_expected[i]);
+                break;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
+// Returns true if every material fills the pixels fillpoly fills. Each one is
+// drawn over 2 backgrounds, as any color it writes may be the background's.
+static bool compareMaterials(polygonStruct& polygon)
+{
+    std::fill(s_expected.begin(), s_expected.end(), 0);
+    polyBackBuffer = s_expected.data();
+    fillpoly(polygon.points.data(), polygon.numPoints(), 0xFF);
+
+    for (u8 polyType = 0; polyType <= 6; polyType++)
+    {
+        std::vector<unsigned char> background0(320 * 200, 0x00);
+        std::vector<unsigned char> background1(320 * 200, 0xFF);
+
+        polyBackBuffer = background0.data();
+        fillpolyMaterial(polygon.points.data(), polygon.numPoints(), polygon.color, polyType);
+        polyBackBuffer = background1.data();
+        fillpolyMaterial(polygon.points.data(), polygon.numPoints(), polygon.color, polyType);
+
+        for (int i = 0; i < 320 * 200; i++)
+        {
+            bool covered = background0[i] != 0x00 || background1[i] != 0xFF;
+            if (covered != (s_expected[i] != 0))
+            {
+                printf("material %d, %d point polygon, pixel (%d %d) %s\n", polyType, polygon.numPoints(), i % 320, i / 320, covered ? "filled" : "missing");
+                polyBackBuffer = nullptr;
+                return false;
+            }
+        }
+    }
+
+    polyBackBuffer = nullptr;
+    return true;
+}
+
+// Returns the number of mismatching polygons.
+static int checkAll(std::mt19937& random)
+{
+    int mismatches = 0;
+    int runs = 0;
+
+    // on screen to far off screen
+    const int radii[] = { 4, 40, 200, 2000 };
+    for (int radius : radii)
+    {
+        for (polygonStruct& polygon : randomPolygons(random, 20000, radius))
+        {
+            runs++;
+            if (!compare(polygon))
+                mismatches++;
+        }
+
+        for (polygonStruct& polygon : randomPolygons(random, 200, radius))
+        {
+            runs++;
+            if (!compareMaterials(polygon))
+                mismatches++;
+        }
+    }
+
+    printf("%d runs, %d mismatches\n", runs, mismatches);
+    return mismatches;
+}
+
+template <typename F>
+static void bench(const char* name, int repeats, std::vector<polygonStruct>& polygons, double pixels, F fill)
+{
+    std::vector<double> latencies;
+
+    polyBackBuffer = s_output.data();
+
+    for (int i = 0; i < repeats; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (polygonStruct& polygon : polygons)
+        {
+            fill(polygon);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        latencies.push_back(std::chrono::duration<double>(end - start).count() * 1000000.0);
+    }
+
+    polyBackBuffer = nullptr;
+
+    std::sort(latencies.begin(), latencies.end());
+
+    double total = 0;
+    for (double latency : latencies)
+        total += latency;
+
+    printf("%-14s %9.1f Mpixels/s %8.2f Mpolys/s  p50 %8.2f  p90 %8.2f  p99 %8.2f us\n", name,
+        total > 0 ? pixels * repeats / total : 0,
+        total > 0 ? (double)polygons.size() * repeats / total : 0,
+        percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99));
+}
+
+// Pixels the polygons cover on screen
+static double countPixels(std::vector<polygonStruct>& polygons)
+{
+    double pixels = 0;
+
+    for (polygonStruct& polygon : polygons)
+    {
+        std::fill(s_output.begin(), s_output.end(), 0);
+        polyBackBuffer = s_output.data();
+        fillpoly(polygon.points.data(), polygon.numPoints(), 0xFF);
+        pixels += (double)std::count(s_output.begin(), s_output.end(), 0xFF);
+    }
+
+    polyBackBuffer = nullptr;
+    return pixels;
+}
+
+int main(int argc, char* argv[])
+{
+    int repeats = 1000;
+    unsigned int seed = 1234;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+        {
+            repeats = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+        {
+            seed = (unsigned int)atoi(argv[++i]);
+        }
+        else
+        {
+            printf("usage: FillBench [-n <repeats>] [-s <seed>]\n");
+            return 1;
+        }
+    }
+
+    std::mt19937 random(seed);
+
+    int mismatches = checkAll(random);
+
+    struct
+    {
+        const char* name;
+        int count;
+        int radius;
+    } sets[] = {
+        { "small", 1000, 6 },
+        { "medium", 200, 40 },
+        { "large", 20, 150 },
+    };
+
+    for (auto& set : sets)
+    {
+        std::vector<polygonStruct> polygons = randomPolygons(random, set.count, set.radius);
+        double pixels = countPixels(polygons);
+
+        printf("\n%d %s polygons, %.0f pixels\n", set.count, set.name, pixels);
+
+        bench("reference", repeats, polygons, pixels, [](polygonStruct& polygon) {
+            fillpolyReference(polygon.points.data(), polygon.numPoints(), polygon.color);
+        });
+        bench("fillpoly", repeats, polygons, pixels, [](polygonStruct& polygon) {
+            fillpoly(polygon.points.data(), polygon.numPoints(), polygon.color);
+        });
+        bench("dither", repeats, polygons, pixels, [](polygonStruct& polygon) {
+            fillpolyMaterial(polygon.points.data(), polygon.numPoints(), polygon.color, 1);
+        });
+        bench("marbre", repeats, polygons, pixels, [](polygonStruct& polygon) {
+            fillpolyMaterial(polygon.points.data(), polygon.numPoints(), polygon.color & 0xF0, 3);
+        });
+    }
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark reference polygon filler (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// The fillpoly FitdLib had before the span filler of polys.cpp: double edge
+// stepping, all 200 scanline counters cleared per call and spans drawn pixel
+// by pixel. FillBench checks the span filler against it and times both.
+void fillpolyReference(s16* datas, int n, unsigned char c);
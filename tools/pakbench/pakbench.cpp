@@ -0,0 +1,639 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark PAK decompression benchmark (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+// Times PAK_explode, PAK_deflate and loadPak on every entry of every .PAK of
+// a directory, and checks what they return:
+//   - implode entries against PAK_explodeReference (tools/pakpack)
+//   - deflate entries against a one shot zlib inflate
+//   - loadPak against the codec output (or the stored data)
+//
+//   PakBench <game dir> [-n <repeats>]
+//   PakBench --synthetic [-n <repeats>] [-o <dir>]
+//
+// --synthetic first writes SYNTH.PAK (generated implode, deflate and stored
+// entries, always the same ones) to <dir>, the temp directory by default,
+// and runs on that. The exit code is 1 if any output differs.
+
+#include "common.h"
+
+#include "fitd_endian_read.h"
+#include "explodeReference.h"
+#include "engineStubs.h"
+#include "toolUtils.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+
+enum benchCodec
+{
+    BENCH_IMPLODE,
+    BENCH_DEFLATE,
+    BENCH_LOADPAK,
+    BENCH_NUM_CODECS
+};
+
+static const char* s_codecNames[BENCH_NUM_CODECS] = { "explode", "deflate", "loadPak" };
+
+struct benchEntryStruct
+{
+    int index;
+    u8 compressionFlag;
+    u8 info5;
+    u32 discSize;
+    u32 uncompressedSize;
+    size_t dataOffset;
+    std::vector<u8> expected; // reference output
+};
+
+struct benchResultStruct
+{
+    std::vector<double> latencies; // microseconds, one per decode
+    uint64_t bytes = 0;
+    double seconds = 0;
+    int mismatches = 0;
+};
+
+// Same walk as PakArchive::parse, on a file held in memory
+static bool parsePak(const std::vector<u8>& pak, std::vector<benchEntryStruct>& entries)
+{
+    if (pak.size() < 8)
+        return false;
+
+    u32 firstOffset = READ_LE_U32((void*)&pak[4]);
+    if (firstOffset < 8 || firstOffset > pak.size())
+        return false;
+
+    unsigned int numFiles = (firstOffset / 4) - 2;
+    entries.resize(numFiles);
+
+    for (unsigned int i = 0; i < numFiles; i++)
+    {
+        size_t offset = READ_LE_U32((void*)&pak[4 + i * 4]);
+        if (offset + 4 > pak.size())
+            return false;
+
+        u32 additionalDescriptorSize = READ_LE_U32((void*)&pak[offset]);
+        offset += additionalDescriptorSize ? additionalDescriptorSize : 4;
+
+        if (offset + 12 > pak.size())
+            return false;
+
+        benchEntryStruct& entry = entries[i];
+        entry.index = i;
+        entry.discSize = READ_LE_U32((void*)&pak[offset]);
+        entry.uncompressedSize = READ_LE_U32((void*)&pak[offset + 4]);
+        entry.compressionFlag = pak[offset + 8];
+        entry.info5 = pak[offset + 9];
+        offset += 12 + READ_LE_U16((void*)&pak[offset + 10]);
+
+        if (offset + entry.discSize > pak.size())
+            return false;
+
+        entry.dataOffset = offset;
+    }
+
+    return true;
+}
+
+static bool inflateOneShot(const u8* source, u32 sourceSize, u8* dest, u32 destSize)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.next_in = (Bytef*)source;
+    stream.avail_in = sourceSize;
+    stream.next_out = dest;
+    stream.avail_out = destSize;
+
+    if (inflateInit2(&stream, -15) != Z_OK)
+        return false;
+
+    int ret = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+
+    return ret == Z_STREAM_END && stream.avail_out == 0;
+}
+
+template <typename F>
+static void timeDecode(benchResultStruct& result, u32 size, int repeats, F decode)
+{
+    for (int i = 0; i < repeats; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        decode();
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        result.latencies.push_back(seconds * 1000000.0);
+        result.seconds += seconds;
+        result.bytes += size;
+    }
+}
+
+static void printResult(const char* archiveName, int codec, benchResultStruct& result)
+{
+    if (result.latencies.empty())
+        return;
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+
+    double megabytesPerSecond = result.seconds > 0 ? result.bytes / result.seconds / (1024.0 * 1024.0) : 0;
+
+    printf("%-12s %-8s %6d %9.1f MB/s  p50 %8.1f  p90 %8.1f  p99 %8.1f  max %8.1f us%s\n",
+        archiveName, s_codecNames[codec], (int)result.latencies.size(), megabytesPerSecond,
+        percentile(result.latencies, 0.5), percentile(result.latencies, 0.9), percentile(result.latencies, 0.99),
+        result.latencies.back(), result.mismatches ? "  MISMATCH" : "");
+}
+
+// Returns the number of mismatching entries.
+static int benchArchive(const std::filesystem::path& pakFile, int repeats, benchResultStruct* totals)
+{
+    std::vector<u8> pak;
+    std::vector<benchEntryStruct> entries;
+
+    std::string name = pakFile.stem().string();
+
+    if (!readFile(pakFile, pak) || !parsePak(pak, entries))
+    {
+        printf("%-12s unreadable\n", name.c_str());
+        return 0;
+    }
+
+    benchResultStruct results[BENCH_NUM_CODECS];
+    std::vector<u8> output;
+
+    for (auto& entry : entries)
+    {
+        unsigned char* source = &pak[entry.dataOffset];
+        entry.expected.resize(entry.uncompressedSize);
+        output.resize(entry.uncompressedSize);
+
+        switch (entry.compressionFlag)
+        {
+        case 0:
+            entry.expected.assign(source, source + entry.discSize);
+            break;
+        case 1:
+        {
+            benchResultStruct& result = results[BENCH_IMPLODE];
+            PAK_explodeReference(source, entry.expected.data(), entry.discSize, entry.uncompressedSize, entry.info5);
+
+            if (PAK_explode(source, output.data(), entry.discSize, entry.uncompressedSize, entry.info5) != 0 || output != entry.expected)
+            {
+                printf("%-12s entry %d: explode mismatch\n", name.c_str(), entry.index);
+                result.mismatches++;
+            }
+
+            timeDecode(result, entry.uncompressedSize, repeats, [&] {
+                PAK_explode(source, output.data(), entry.discSize, entry.uncompressedSize, entry.info5);
+            });
+            break;
+        }
+        case 4:
+        {
+            benchResultStruct& result = results[BENCH_DEFLATE];
+            inflateOneShot(source, entry.discSize, entry.expected.data(), entry.uncompressedSize);
+
+            if (PAK_deflate(source, output.data(), entry.discSize, entry.uncompressedSize) != 0 || output != entry.expected)
+            {
+                printf("%-12s entry %d: deflate mismatch\n", name.c_str(), entry.index);
+                result.mismatches++;
+            }
+
+            timeDecode(result, entry.uncompressedSize, repeats, [&] {
+                PAK_deflate(source, output.data(), entry.discSize, entry.uncompressedSize);
+            });
+            break;
+        }
+        default:
+            printf("%-12s entry %d: unknown compression %d\n", name.c_str(), entry.index, entry.compressionFlag);
+            entry.expected.clear();
+            break;
+        }
+    }
+
+    // through the engine loader, from disk (or FITD.PKX if there is one)
+    std::string directory = pakFile.parent_path().string();
+    if (directory.empty())
+        directory = ".";
+    snprintf(homePath, sizeof(homePath), "%s/", directory.c_str());
+
+    for (auto& entry : entries)
+    {
+        if (entry.expected.size() != entry.uncompressedSize)
+            continue;
+
+        benchResultStruct& result = results[BENCH_LOADPAK];
+
+        char* data = loadPak(name.c_str(), entry.index);
+        if (!data || memcmp(data, entry.expected.data(), entry.uncompressedSize))
+        {
+            printf("%-12s entry %d: loadPak mismatch\n", name.c_str(), entry.index);
+            result.mismatches++;
+        }
+        free(data);
+
+        timeDecode(result, entry.uncompressedSize, repeats, [&] {
+            free(loadPak(name.c_str(), entry.index));
+        });
+    }
+
+    PAK_CloseAll();
+
+    int mismatches = 0;
+    for (int codec = 0; codec < BENCH_NUM_CODECS; codec++)
+    {
+        printResult(name.c_str(), codec, results[codec]);
+
+        benchResultStruct& total = totals[codec];
+        total.latencies.insert(total.latencies.end(), results[codec].latencies.begin(), results[codec].latencies.end());
+        total.bytes += results[codec].bytes;
+        total.seconds += results[codec].seconds;
+        total.mismatches += results[codec].mismatches;
+        mismatches += results[codec].mismatches;
+    }
+
+    return mismatches;
+}
+
+//----------------------------------------------------------------------------
+// Synthetic archive
+//----------------------------------------------------------------------------
+
+// Bit writer in the order the explode decoder reads
+struct bitWriterStruct
+{
+    std::vector<u8> data;
+    u32 buffer = 0;
+    int bits = 0;
+
+    void put(u32 value, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            buffer |= ((value >> i) & 1) << bits;
+            if (++bits == 8)
+            {
+                data.push_back((u8)buffer);
+                buffer = 0;
+                bits = 0;
+            }
+        }
+    }
+
+    void flush()
+    {
+        if (bits)
+            data.push_back((u8)buffer);
+        buffer = 0;
+        bits = 0;
+    }
+};
+
+struct implodeCodeStruct
+{
+    std::vector<int> lengths;
+    std::vector<u32> codes; // bit reversed, as read from the stream
+};
+
+// Code lengths of a random complete prefix code, splitting mostly the
+// shallowest leaves so they stay in the range real trees use
+static std::vector<int> randomCodeLengths(std::mt19937& random, int numCodes)
+{
+    std::vector<int> depths = { 0 };
+
+    while ((int)depths.size() < numCodes)
+    {
+        size_t leaf = random() % depths.size();
+        if (random() % 4 != 0)
+            leaf = std::min_element(depths.begin(), depths.end()) - depths.begin();
+
+        if (depths[leaf] >= 16)
+            continue;
+
+        depths[leaf]++;
+        depths.push_back(depths[leaf]);
+    }
+
+    std::shuffle(depths.begin(), depths.end(), random);
+    return depths;
+}
+
+// Same code assignment as the decoder's tables
+static implodeCodeStruct makeImplodeCode(const std::vector<int>& lengths)
+{
+    implodeCodeStruct code;
+    code.lengths = lengths;
+
+    u32 count[17] = {};
+    for (int length : lengths)
+        count[length]++;
+
+    u32 next[17];
+    u32 value = 0;
+    for (int length = 1; length <= 16; length++)
+    {
+        next[length] = value;
+        value = (value + count[length]) << 1;
+    }
+
+    for (int length : lengths)
+    {
+        u32 canonical = next[length]++;
+        u32 reversed = 0;
+        for (int i = 0; i < length; i++)
+        {
+            reversed = (reversed << 1) | (canonical & 1);
+            canonical >>= 1;
+        }
+        code.codes.push_back(reversed);
+    }
+
+    return code;
+}
+
+static void putTree(std::vector<u8>& output, const std::vector<int>& lengths)
+{
+    std::vector<u8> pairs;
+    for (size_t i = 0; i < lengths.size();)
+    {
+        size_t run = 1;
+        while (i + run < lengths.size() && lengths[i + run] == lengths[i] && run < 16)
+            run++;
+
+        pairs.push_back((u8)((lengths[i] - 1) | ((run - 1) << 4)));
+        i += run;
+    }
+
+    output.push_back((u8)(pairs.size() - 1));
+    output.insert(output.end(), pairs.begin(), pairs.end());
+}
+
+static void putSymbol(bitWriterStruct& writer, const implodeCodeStruct& code, int symbol)
+{
+    // the codes are stored inverted
+    writer.put(~code.codes[symbol] & ((1u << code.lengths[symbol]) - 1), code.lengths[symbol]);
+}
+
+// A valid implode stream of random tokens decoding to exactly size bytes
+static std::vector<u8> makeImplodeStream(std::mt19937& random, u32 size, u8 flags)
+{
+    const bool literalTree = (flags & 4) != 0;
+    const int lowDistanceBits = (flags & 2) ? 7 : 6;
+    const int minMatch = literalTree ? 3 : 2;
+
+    std::vector<u8> stream;
+    implodeCodeStruct literalCode;
+    if (literalTree)
+    {
+        literalCode = makeImplodeCode(randomCodeLengths(random, 256));
+        putTree(stream, literalCode.lengths);
+    }
+    implodeCodeStruct lengthCode = makeImplodeCode(randomCodeLengths(random, 64));
+    putTree(stream, lengthCode.lengths);
+    implodeCodeStruct distanceCode = makeImplodeCode(randomCodeLengths(random, 64));
+    putTree(stream, distanceCode.lengths);
+
+    bitWriterStruct writer;
+    u32 produced = 0;
+
+    while (produced < size)
+    {
+        u32 left = size - produced;
+
+        if (left < (u32)minMatch || random() % 3 == 0)
+        {
+            writer.put(1, 1);
+            if (literalTree)
+                putSymbol(writer, literalCode, random() % 256);
+            else
+                writer.put(random() & 0xFF, 8);
+            produced++;
+        }
+        else
+        {
+            // mostly short matches, close by
+            int lengthSymbol = std::min<int>(random() % 8, left - minMatch);
+            writer.put(0, 1);
+            writer.put(random() & ((1 << lowDistanceBits) - 1), lowDistanceBits);
+            putSymbol(writer, distanceCode, random() % 8);
+            putSymbol(writer, lengthCode, lengthSymbol);
+            produced += minMatch + lengthSymbol;
+        }
+    }
+
+    writer.flush();
+    stream.insert(stream.end(), writer.data.begin(), writer.data.end());
+
+    return stream;
+}
+
+// Background like data: runs and gradients, with some noise
+static std::vector<u8> makePicture(std::mt19937& random, u32 size)
+{
+    std::vector<u8> data(size);
+    u32 position = 0;
+
+    while (position < size)
+    {
+        u32 run = std::min<u32>(1 + random() % 64, size - position);
+        u8 value = random() & 0xFF;
+        int step = (int)(random() % 3) - 1;
+
+        for (u32 i = 0; i < run; i++)
+        {
+            data[position++] = (random() % 16) ? value : (u8)random();
+            value += step;
+        }
+    }
+
+    return data;
+}
+
+static std::vector<u8> deflateRaw(const std::vector<u8>& data)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, 9, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+
+    // FitdLib/zlib.h is 1.1.3, no deflateBound: 0.1% + 12 bytes, rounded up
+    std::vector<u8> output(data.size() + data.size() / 100 + 64);
+    stream.next_in = (Bytef*)data.data();
+    stream.avail_in = (uInt)data.size();
+    stream.next_out = output.data();
+    stream.avail_out = (uInt)output.size();
+
+    deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return output;
+}
+
+static void writeLE32(std::vector<u8>& output, size_t offset, u32 value)
+{
+    output[offset] = value & 0xFF;
+    output[offset + 1] = (value >> 8) & 0xFF;
+    output[offset + 2] = (value >> 16) & 0xFF;
+    output[offset + 3] = (value >> 24) & 0xFF;
+}
+
+static bool writeSyntheticPak(const std::filesystem::path& pakFile)
+{
+    struct syntheticEntry
+    {
+        u8 compressionFlag;
+        u8 info5;
+        u32 uncompressedSize;
+        std::vector<u8> data;
+    };
+
+    std::mt19937 random(1234);
+    std::vector<syntheticEntry> entries;
+
+    // camera sized and body sized entries, with each explode variant
+    static const u32 sizes[] = { 64000, 64000, 16000, 4000, 1200, 300 };
+    static const u8 explodeFlags[] = { 0, 2, 4, 6 };
+
+    for (u8 flags : explodeFlags)
+    {
+        for (u32 size : sizes)
+        {
+            entries.push_back({ 1, flags, size, makeImplodeStream(random, size, flags) });
+        }
+    }
+
+    for (u32 size : sizes)
+    {
+        entries.push_back({ 4, 0, size, deflateRaw(makePicture(random, size)) });
+        entries.push_back({ 0, 0, size, makePicture(random, size) });
+    }
+
+    const u32 tableSize = (u32)(entries.size() + 2) * 4;
+    std::vector<u8> pak(tableSize, 0);
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        syntheticEntry& entry = entries[i];
+        size_t offset = pak.size();
+        writeLE32(pak, 4 + i * 4, (u32)offset);
+
+        pak.resize(offset + 16);
+        writeLE32(pak, offset, 0);
+        writeLE32(pak, offset + 4, (u32)entry.data.size());
+        writeLE32(pak, offset + 8, entry.uncompressedSize);
+        pak[offset + 12] = entry.compressionFlag;
+        pak[offset + 13] = entry.info5;
+        pak[offset + 14] = 0; // no name
+        pak[offset + 15] = 0;
+
+        pak.insert(pak.end(), entry.data.begin(), entry.data.end());
+    }
+    writeLE32(pak, 4 + entries.size() * 4, (u32)pak.size());
+
+    FILE* fileHandle = fopen(pakFile.string().c_str(), "wb");
+    if (!fileHandle)
+        return false;
+
+    bool result = fwrite(pak.data(), pak.size(), 1, fileHandle) == 1;
+    fclose(fileHandle);
+
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* inputDir = nullptr;
+    const char* outputDir = nullptr;
+    bool synthetic = false;
+    int repeats = 10;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--synthetic"))
+        {
+            synthetic = true;
+        }
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+        {
+            repeats = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+        {
+            outputDir = argv[++i];
+        }
+        else
+        {
+            inputDir = argv[i];
+        }
+    }
+
+    if ((!inputDir && !synthetic) || repeats < 1)
+    {
+        printf("usage: PakBench <game dir> [-n <repeats>]\n");
+        printf("       PakBench --synthetic [-n <repeats>] [-o <dir>]\n");
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> pakFiles;
+
+    if (synthetic)
+    {
+        std::filesystem::path pakFile = std::filesystem::path(outputDir ? outputDir : std::filesystem::temp_directory_path().string()) / "SYNTH.PAK";
+        if (!writeSyntheticPak(pakFile))
+        {
+            printf("Can't write %s\n", pakFile.string().c_str());
+            return 1;
+        }
+        pakFiles.push_back(pakFile);
+    }
+    else
+    {
+        for (auto& dirEntry : std::filesystem::directory_iterator(inputDir))
+        {
+            std::string extension = dirEntry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::toupper);
+
+            if (dirEntry.is_regular_file() && extension == ".PAK")
+                pakFiles.push_back(dirEntry.path());
+        }
+        std::sort(pakFiles.begin(), pakFiles.end());
+    }
+
+    benchResultStruct totals[BENCH_NUM_CODECS];
+    int mismatches = 0;
+
+    for (auto& pakFile : pakFiles)
+    {
+        mismatches += benchArchive(pakFile, repeats, totals);
+    }
+
+    printf("\n");
+    for (int codec = 0; codec < BENCH_NUM_CODECS; codec++)
+    {
+        printResult("total", codec, totals[codec]);
+    }
+
+    printf("%d archives, %d mismatches\n", (int)pakFiles.size(), mismatches);
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,384 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark PAK container builder (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+// Converts every .PAK of a game install into a single FITD.PKX container
+// (see FitdLib/pakContainer.h), with all entries decoded once, here.
+//
+//   PakPack <game dir> [-o <output>] [-a <alignment>]
+//   PakPack --verify <container>
+//   PakPack --compare <game dir>   checks PAK_explode against the reference decoder
+
+#include "common.h"
+
+#include "fitd_endian_read.h"
+#include "pakContainer.h"
+#include "explodeReference.h"
+#include "toolUtils.h"
+
+#include <algorithm>
+#include <filesystem>
+
+struct packEntryStruct
+{
+    std::string name;
+    std::vector<u8> data;
+};
+
+struct packArchiveStruct
+{
+    std::string name;
+    u32 sourceSize;
+    std::vector<packEntryStruct> entries;
+};
+
+static bool s_compareExplode = false;
+static int s_explodeMismatches = 0;
+
+// Same walk as PakArchive::parse, on a file held in memory
+static bool decodePak(const std::vector<u8>& pak, packArchiveStruct& archive)
+{
+    if (pak.size() < 8)
+        return false;
+
+    u32 firstOffset = READ_LE_U32((void*)&pak[4]);
+    if (firstOffset < 8 || firstOffset > pak.size())
+        return false;
+
+    unsigned int numFiles = (firstOffset / 4) - 2;
+    archive.entries.resize(numFiles);
+
+    for (unsigned int i = 0; i < numFiles; i++)
+    {
+        size_t offset = READ_LE_U32((void*)&pak[4 + i * 4]);
+        if (offset + 4 > pak.size())
+            return false;
+
+        u32 additionalDescriptorSize = READ_LE_U32((void*)&pak[offset]);
+        offset += additionalDescriptorSize ? additionalDescriptorSize : 4;
+
+        if (offset + 12 > pak.size())
+            return false;
+
+        u32 discSize = READ_LE_U32((void*)&pak[offset]);
+        u32 uncompressedSize = READ_LE_U32((void*)&pak[offset + 4]);
+        u8 compressionFlag = pak[offset + 8];
+        u8 info5 = pak[offset + 9];
+        u16 nameSize = READ_LE_U16((void*)&pak[offset + 10]);
+        offset += 12;
+
+        if (offset + nameSize + discSize > pak.size())
+            return false;
+
+        packEntryStruct& entry = archive.entries[i];
+        if (nameSize > 2)
+        {
+            const char* name = (const char*)&pak[offset + 2];
+            entry.name.assign(name, strnlen(name, nameSize - 2));
+        }
+        offset += nameSize;
+
+        unsigned char* source = (unsigned char*)&pak[offset];
+
+        switch (compressionFlag)
+        {
+        case 0:
+            entry.data.assign(source, source + discSize);
+            break;
+        case 1:
+            entry.data.resize(uncompressedSize);
+            if (PAK_explode(source, entry.data.data(), discSize, uncompressedSize, info5) != 0)
+                return false;
+            if (s_compareExplode)
+            {
+                std::vector<u8> reference(uncompressedSize);
+                PAK_explodeReference(source, reference.data(), discSize, uncompressedSize, info5);
+                if (reference != entry.data)
+                {
+                    printf("  entry %d: explode mismatch\n", i);
+                    s_explodeMismatches++;
+                }
+            }
+            break;
+        case 4:
+            entry.data.resize(uncompressedSize);
+            if (PAK_deflate(source, entry.data.data(), discSize, uncompressedSize) != 0)
+                return false;
+            break;
+        default:
+            printf("  entry %d: unknown compression %d\n", i, compressionFlag);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static u32 addString(std::vector<char>& strings, const std::string& name)
+{
+    u32 offset = (u32)strings.size();
+    strings.insert(strings.end(), name.begin(), name.end());
+    strings.push_back(0);
+    return offset;
+}
+
+static void writeLE32(void* dest, u32 value)
+{
+    u8* bytes = (u8*)dest;
+    bytes[0] = value & 0xFF;
+    bytes[1] = (value >> 8) & 0xFF;
+    bytes[2] = (value >> 16) & 0xFF;
+    bytes[3] = (value >> 24) & 0xFF;
+}
+
+static void writeLE64(void* dest, uint64_t value)
+{
+    writeLE32(dest, (u32)value);
+    writeLE32((u8*)dest + 4, (u32)(value >> 32));
+}
+
+static bool writeContainer(const std::vector<packArchiveStruct>& archives, const char* outputName, u32 alignment)
+{
+    std::vector<pakContainerArchiveStruct> archiveTable;
+    std::vector<pakContainerEntryStruct> entryTable;
+    std::vector<char> strings;
+
+    for (auto& archive : archives)
+    {
+        pakContainerArchiveStruct archiveEntry;
+        writeLE32(&archiveEntry.nameOffset, addString(strings, archive.name));
+        writeLE32(&archiveEntry.firstEntry, (u32)entryTable.size());
+        writeLE32(&archiveEntry.numEntries, (u32)archive.entries.size());
+        writeLE32(&archiveEntry.sourceSize, archive.sourceSize);
+        archiveTable.push_back(archiveEntry);
+
+        for (auto& entry : archive.entries)
+        {
+            pakContainerEntryStruct containerEntry = {};
+            writeLE32(&containerEntry.size, (u32)entry.data.size());
+            writeLE32(&containerEntry.nameOffset, entry.name.empty() ? PAK_CONTAINER_NO_NAME : addString(strings, entry.name));
+            writeLE64(&containerEntry.hash, pakContainerHash(entry.data.data(), entry.data.size()));
+            entryTable.push_back(containerEntry);
+        }
+    }
+
+    const u32 stringTableOffset = (u32)(sizeof(pakContainerHeaderStruct)
+        + archiveTable.size() * sizeof(pakContainerArchiveStruct)
+        + entryTable.size() * sizeof(pakContainerEntryStruct));
+    const u32 dataOffset = (u32)((stringTableOffset + strings.size() + alignment - 1) / alignment * alignment);
+
+    // data offsets, in the same order as the data is written below
+    uint64_t offset = dataOffset;
+    size_t entryIndex = 0;
+    for (auto& archive : archives)
+    {
+        for (auto& entry : archive.entries)
+        {
+            if (offset > 0xFFFFFFFFull)
+            {
+                printf("Container over 4GB\n");
+                return false;
+            }
+            writeLE32(&entryTable[entryIndex++].offset, (u32)offset);
+            offset = (offset + entry.data.size() + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    pakContainerHeaderStruct header;
+    writeLE32(&header.magic, PAK_CONTAINER_MAGIC);
+    writeLE32(&header.version, PAK_CONTAINER_VERSION);
+    writeLE32(&header.alignment, alignment);
+    writeLE32(&header.numArchives, (u32)archiveTable.size());
+    writeLE32(&header.numEntries, (u32)entryTable.size());
+    writeLE32(&header.stringTableOffset, stringTableOffset);
+    writeLE32(&header.stringTableSize, (u32)strings.size());
+    writeLE32(&header.dataOffset, dataOffset);
+
+    FILE* fileHandle = fopen(outputName, "wb");
+    if (!fileHandle)
+    {
+        printf("Can't create %s\n", outputName);
+        return false;
+    }
+
+    fwrite(&header, sizeof(header), 1, fileHandle);
+    fwrite(archiveTable.data(), sizeof(pakContainerArchiveStruct), archiveTable.size(), fileHandle);
+    fwrite(entryTable.data(), sizeof(pakContainerEntryStruct), entryTable.size(), fileHandle);
+    fwrite(strings.data(), 1, strings.size(), fileHandle);
+
+    const std::vector<u8> padding(alignment, 0);
+    size_t position = stringTableOffset + strings.size();
+    fwrite(padding.data(), 1, dataOffset - position, fileHandle);
+    position = dataOffset;
+
+    for (auto& archive : archives)
+    {
+        for (auto& entry : archive.entries)
+        {
+            fwrite(entry.data.data(), 1, entry.data.size(), fileHandle);
+            position += entry.data.size();
+
+            size_t aligned = (position + alignment - 1) / alignment * alignment;
+            fwrite(padding.data(), 1, aligned - position, fileHandle);
+            position = aligned;
+        }
+    }
+
+    bool result = ferror(fileHandle) == 0;
+    fclose(fileHandle);
+
+    printf("%s: %d archives, %d entries, %u bytes\n", outputName, (int)archiveTable.size(), (int)entryTable.size(), (u32)position);
+
+    return result;
+}
+
+static int verifyContainer(const char* containerName)
+{
+    std::vector<u8> container;
+    if (!readFile(containerName, container) || container.size() < sizeof(pakContainerHeaderStruct))
+    {
+        printf("Can't read %s\n", containerName);
+        return 1;
+    }
+
+    pakContainerHeaderStruct* pHeader = (pakContainerHeaderStruct*)container.data();
+    if (READ_LE_U32(&pHeader->magic) != PAK_CONTAINER_MAGIC || READ_LE_U32(&pHeader->version) != PAK_CONTAINER_VERSION)
+    {
+        printf("%s is not a version %d container\n", containerName, PAK_CONTAINER_VERSION);
+        return 1;
+    }
+
+    const u32 numArchives = READ_LE_U32(&pHeader->numArchives);
+    const u32 numEntries = READ_LE_U32(&pHeader->numEntries);
+    const size_t entryTableOffset = sizeof(pakContainerHeaderStruct) + numArchives * sizeof(pakContainerArchiveStruct);
+
+    if (entryTableOffset + numEntries * sizeof(pakContainerEntryStruct) > container.size())
+    {
+        printf("Truncated tables\n");
+        return 1;
+    }
+
+    int errors = 0;
+    for (u32 i = 0; i < numEntries; i++)
+    {
+        pakContainerEntryStruct entry;
+        memcpy(&entry, &container[entryTableOffset + i * sizeof(pakContainerEntryStruct)], sizeof(entry));
+
+        const u32 offset = READ_LE_U32(&entry.offset);
+        const u32 size = READ_LE_U32(&entry.size);
+
+        if ((size_t)offset + size > container.size())
+        {
+            printf("entry %u: out of bounds\n", i);
+            errors++;
+        }
+        else if (pakContainerHash(&container[offset], size) != (READ_LE_U32(&entry.hash) | ((uint64_t)READ_LE_U32((u8*)&entry.hash + 4) << 32)))
+        {
+            printf("entry %u: hash mismatch\n", i);
+            errors++;
+        }
+    }
+
+    printf("%s: %u entries checked, %d errors\n", containerName, numEntries, errors);
+
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* inputDir = nullptr;
+    std::string outputName;
+    u32 alignment = 32;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--verify") && i + 1 < argc)
+        {
+            return verifyContainer(argv[i + 1]);
+        }
+        else if (!strcmp(argv[i], "--compare") && i + 1 < argc)
+        {
+            s_compareExplode = true;
+            inputDir = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+        {
+            outputName = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-a") && i + 1 < argc)
+        {
+            alignment = (u32)atoi(argv[++i]);
+        }
+        else
+        {
+            inputDir = argv[i];
+        }
+    }
+
+    if (!inputDir || alignment == 0 || (alignment & (alignment - 1)))
+    {
+        printf("usage: PakPack <game dir> [-o <output>] [-a <power of two alignment>]\n");
+        printf("       PakPack --verify <container>\n");
+        printf("       PakPack --compare <game dir>\n");
+        return 1;
+    }
+
+    if (outputName.empty())
+    {
+        outputName = (std::filesystem::path(inputDir) / PAK_CONTAINER_NAME).string();
+    }
+
+    std::vector<std::filesystem::path> pakFiles;
+    for (auto& dirEntry : std::filesystem::directory_iterator(inputDir))
+    {
+        std::string extension = dirEntry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::toupper);
+
+        if (dirEntry.is_regular_file() && extension == ".PAK")
+            pakFiles.push_back(dirEntry.path());
+    }
+    std::sort(pakFiles.begin(), pakFiles.end());
+
+    std::vector<packArchiveStruct> archives;
+    for (auto& pakFile : pakFiles)
+    {
+        std::vector<u8> pak;
+        packArchiveStruct archive;
+
+        archive.name = pakFile.stem().string();
+        std::transform(archive.name.begin(), archive.name.end(), archive.name.begin(), ::toupper);
+
+        // archives that don't decode are left out, the game keeps reading the .PAK
+        if (!readFile(pakFile, pak) || !decodePak(pak, archive))
+        {
+            printf("%s: skipped\n", pakFile.filename().string().c_str());
+            continue;
+        }
+
+        archive.sourceSize = (u32)pak.size();
+        archives.push_back(std::move(archive));
+    }
+
+    if (s_compareExplode)
+    {
+        printf("%d archives decoded, %d explode mismatches\n", (int)archives.size(), s_explodeMismatches);
+        return s_explodeMismatches ? 1 : 0;
+    }
+
+    return writeContainer(archives, outputName.c_str(), alignment) ? 0 : 1;
+}
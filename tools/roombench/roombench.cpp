@@ -0,0 +1,540 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark room grid benchmark (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+// Checks that the queries of roomGrid.cpp find the same hard collisions and
+// scenario zones, in the same order, as the walks of the whole tables that
+// AsmCheckListCol, processActor2Sub and GereDec did before, on actor sized
+// boxes and points in and around every room. The rooms are those of an ETAGE
+// PAK, or generated ones of up to 4096 entries when no PAK is given, with
+// inverted, wall long and room wide boxes. Then times both on the same
+// queries.
+//
+//   RoomBench [<ETAGExx.PAK>] [-q <queries per room>] [-r <repeats>] [-s <seed>]
+//
+// The exit code is 1 if any query differs.
+
+#include "common.h"
+
+#include "roomGrid.h"
+#include "fitd_endian_read.h"
+#include "engineStubs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+
+struct benchRoomStruct
+{
+    int index;
+    std::vector<hardColStruct> hardCols;
+    std::vector<sceZoneStruct> sceZones;
+    roomGridStruct hardColGrid;
+    roomGridStruct sceZoneGrid;
+
+    // where the queries go: the entries' bounds and a bit around
+    s32 minX, maxX, minY, maxY, minZ, maxZ;
+};
+
+struct benchQueryStruct
+{
+    ZVStruct zv;
+    int x, y, z;
+};
+
+//----------------------------------------------------------------------------
+// The walks of main.cpp the grids replaced
+//----------------------------------------------------------------------------
+
+// AsmCheckListCol
+static void hardColReference(const benchRoomStruct& room, const ZVStruct* zvPtr, std::vector<int>& found)
+{
+    const hardColStruct* pCurrentEntry = room.hardCols.data();
+
+    for (u32 i = 0; i < room.hardCols.size(); i++)
+    {
+        if (((pCurrentEntry->zv.ZVX1) < (zvPtr->ZVX2)) && ((zvPtr->ZVX1) < (pCurrentEntry->zv.ZVX2)))
+        {
+            if (((pCurrentEntry->zv.ZVY1) < (zvPtr->ZVY2)) && ((zvPtr->ZVY1) < (pCurrentEntry->zv.ZVY2)))
+            {
+                if (((pCurrentEntry->zv.ZVZ1) < (zvPtr->ZVZ2)) && ((zvPtr->ZVZ1) < (pCurrentEntry->zv.ZVZ2)))
+                {
+                    found.push_back(i);
+                }
+            }
+        }
+
+        pCurrentEntry++;
+    }
+}
+
+static bool isPointInZone(int x, int y, int z, const ZVStruct* pZV)
+{
+    return pZV->ZVX1 <= x && pZV->ZVX2 >= x && pZV->ZVY1 <= y && pZV->ZVY2 >= y && pZV->ZVZ1 <= z && pZV->ZVZ2 >= z;
+}
+
+// GereDec's walk; processActor2Sub returns the first one
+static void sceZoneReference(const benchRoomStruct& room, int x, int y, int z, std::vector<int>& found)
+{
+    for (u32 i = 0; i < room.sceZones.size(); i++)
+    {
+        if (isPointInZone(x, y, z, &room.sceZones[i].zv))
+            found.push_back(i);
+    }
+}
+
+//----------------------------------------------------------------------------
+// The same through the grids, as main.cpp does now
+//----------------------------------------------------------------------------
+
+static void hardColGrid(const benchRoomStruct& room, const ZVStruct* zvPtr, std::vector<int>& found)
+{
+    const u16* entries = nullptr;
+    int numEntries = getRoomGridBox(room.hardColGrid, zvPtr, &entries);
+    if (numEntries < 0)
+        numEntries = (int)room.hardCols.size();
+
+    for (int i = 0; i < numEntries; i++)
+    {
+        const int entry = entries ? entries[i] : i;
+        const ZVStruct* pZV = &room.hardCols[entry].zv;
+
+        if ((pZV->ZVX1 < zvPtr->ZVX2) && (zvPtr->ZVX1 < pZV->ZVX2) && (pZV->ZVY1 < zvPtr->ZVY2) && (zvPtr->ZVY1 < pZV->ZVY2) && (pZV->ZVZ1 < zvPtr->ZVZ2) && (zvPtr->ZVZ1 < pZV->ZVZ2))
+            found.push_back(entry);
+    }
+}
+
+static void sceZoneGrid(const benchRoomStruct& room, int x, int y, int z, std::vector<int>& found)
+{
+    const u16* entries = nullptr;
+    int numEntries = getRoomGridPoint(room.sceZoneGrid, x, z, &entries);
+    if (numEntries < 0)
+        numEntries = (int)room.sceZones.size();
+
+    for (int i = 0; i < numEntries; i++)
+    {
+        const int entry = entries ? entries[i] : i;
+
+        if (isPointInZone(x, y, z, &room.sceZones[entry].zv))
+            found.push_back(entry);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Rooms
+//----------------------------------------------------------------------------
+
+static void readZv(u8* data, ZVStruct& zv)
+{
+    zv.ZVX1 = READ_LE_S16(data + 0x00);
+    zv.ZVX2 = READ_LE_S16(data + 0x02);
+    zv.ZVY1 = READ_LE_S16(data + 0x04);
+    zv.ZVY2 = READ_LE_S16(data + 0x06);
+    zv.ZVZ1 = READ_LE_S16(data + 0x08);
+    zv.ZVZ2 = READ_LE_S16(data + 0x0A);
+}
+
+static void finishRoom(benchRoomStruct& room)
+{
+    room.minX = room.minY = room.minZ = -1000;
+    room.maxX = room.maxY = room.maxZ = 1000;
+
+    auto extend = [&room](const ZVStruct& zv) {
+        room.minX = std::min({ room.minX, zv.ZVX1, zv.ZVX2 });
+        room.maxX = std::max({ room.maxX, zv.ZVX1, zv.ZVX2 });
+        room.minY = std::min({ room.minY, zv.ZVY1, zv.ZVY2 });
+        room.maxY = std::max({ room.maxY, zv.ZVY1, zv.ZVY2 });
+        room.minZ = std::min({ room.minZ, zv.ZVZ1, zv.ZVZ2 });
+        room.maxZ = std::max({ room.maxZ, zv.ZVZ1, zv.ZVZ2 });
+    };
+
+    for (const hardColStruct& hardCol : room.hardCols)
+        extend(hardCol.zv);
+    for (const sceZoneStruct& sceZone : room.sceZones)
+        extend(sceZone.zv);
+
+    // as LoadEtage does
+    buildRoomGrid(room.hardColGrid, &room.hardCols.data()->zv, sizeof(hardColStruct), (int)room.hardCols.size());
+    buildRoomGrid(room.sceZoneGrid, &room.sceZones.data()->zv, sizeof(sceZoneStruct), (int)room.sceZones.size());
+}
+
+// Same walk as LoadEtage, for the floors with all the rooms in entry 0
+static bool loadRooms(const std::filesystem::path& pakFile, std::vector<benchRoomStruct>& rooms)
+{
+    std::string directory = pakFile.parent_path().string();
+    if (directory.empty())
+        directory = ".";
+    snprintf(homePath, sizeof(homePath), "%s/", directory.c_str());
+
+    std::string name = pakFile.stem().string();
+    if (!PAK_getNumFiles(name.c_str()))
+        return false;
+
+    const u32 size = getPakSize(name.c_str(), 0);
+    u8* data = (u8*)loadPak(name.c_str(), 0);
+    PAK_CloseAll();
+
+    if (!data || size < 4)
+    {
+        free(data);
+        return false;
+    }
+
+    const u32 numMax = READ_LE_U32(data) / 4;
+
+    for (u32 i = 0; i < numMax && (i + 1) * 4 <= size && READ_LE_U32(data + i * 4) < size; i++)
+    {
+        u8* roomData = data + READ_LE_U32(data + i * 4);
+
+        benchRoomStruct room;
+        room.index = i;
+
+        u8* hardColData = roomData + READ_LE_U16(roomData);
+        room.hardCols.resize(READ_LE_U16(hardColData));
+        hardColData += 2;
+
+        for (hardColStruct& hardCol : room.hardCols)
+        {
+            readZv(hardColData, hardCol.zv);
+            hardCol.parameter = READ_LE_U16(hardColData + 0x0C);
+            hardCol.type = READ_LE_U16(hardColData + 0x0E);
+            hardColData += 0x10;
+        }
+
+        u8* sceZoneData = roomData + READ_LE_U16(roomData + 2);
+        room.sceZones.resize(READ_LE_U16(sceZoneData));
+        sceZoneData += 2;
+
+        for (sceZoneStruct& sceZone : room.sceZones)
+        {
+            readZv(sceZoneData, sceZone.zv);
+            sceZone.parameter = READ_LE_U16(sceZoneData + 0x0C);
+            sceZone.type = READ_LE_U16(sceZoneData + 0x0E);
+            sceZoneData += 0x10;
+        }
+
+        finishRoom(room);
+        rooms.push_back(std::move(room));
+    }
+
+    free(data);
+
+    return !rooms.empty();
+}
+
+static s32 randomIn(std::mt19937& random, s32 min, s32 max)
+{
+    return min + (s32)(random() % (u32)(max - min + 1));
+}
+
+// A box of the room: mostly furniture sized, some walls and room wide zones,
+// now and then one upside down
+static void randomBox(std::mt19937& random, s32 extent, ZVStruct& zv)
+{
+    s32 sizeX, sizeZ;
+
+    switch (random() % 16)
+    {
+    case 0: // wall along X
+        sizeX = randomIn(random, extent / 4, extent * 2);
+        sizeZ = randomIn(random, 50, 300);
+        break;
+    case 1: // wall along Z
+        sizeX = randomIn(random, 50, 300);
+        sizeZ = randomIn(random, extent / 4, extent * 2);
+        break;
+    case 2: // over the whole room
+        sizeX = randomIn(random, extent, extent * 2);
+        sizeZ = randomIn(random, extent, extent * 2);
+        break;
+    default:
+        sizeX = randomIn(random, 100, 3000);
+        sizeZ = randomIn(random, 100, 3000);
+        break;
+    }
+
+    zv.ZVX1 = randomIn(random, -extent, extent - sizeX / 2);
+    zv.ZVX2 = zv.ZVX1 + sizeX;
+    zv.ZVY1 = randomIn(random, -3000, 0);
+    zv.ZVY2 = zv.ZVY1 + randomIn(random, 0, 3000);
+    zv.ZVZ1 = randomIn(random, -extent, extent - sizeZ / 2);
+    zv.ZVZ2 = zv.ZVZ1 + sizeZ;
+
+    if (random() % 32 == 0)
+        std::swap(zv.ZVX1, zv.ZVX2);
+    if (random() % 32 == 0)
+        std::swap(zv.ZVZ1, zv.ZVZ2);
+}
+
+static std::vector<benchRoomStruct> syntheticRooms(std::mt19937& random)
+{
+    static const int sizes[] = { 0, 1, 7, 8, 16, 64, 256, 1024, 4096 };
+
+    std::vector<benchRoomStruct> rooms;
+
+    for (int size : sizes)
+    {
+        benchRoomStruct room;
+        room.index = (int)rooms.size();
+
+        // the bigger the room, the more spread out
+        const s32 extent = 4000 + 1500 * (s32)sqrt((double)size);
+
+        room.hardCols.resize(size);
+        for (hardColStruct& hardCol : room.hardCols)
+        {
+            randomBox(random, extent, hardCol.zv);
+            hardCol.type = 0;
+            hardCol.parameter = 0;
+        }
+
+        room.sceZones.resize(size);
+        for (sceZoneStruct& sceZone : room.sceZones)
+        {
+            randomBox(random, extent, sceZone.zv);
+            sceZone.type = random() % 11;
+            sceZone.parameter = 0;
+        }
+
+        finishRoom(room);
+        rooms.push_back(std::move(room));
+    }
+
+    return rooms;
+}
+
+// Actor ZVs and the points GereDec tests, in and around the room, some right
+// on the edges of the entries
+static std::vector<benchQueryStruct> randomQueries(std::mt19937& random, const benchRoomStruct& room, int count)
+{
+    std::vector<benchQueryStruct> queries(count);
+
+    const s32 marginX = (room.maxX - room.minX) / 8 + 1;
+    const s32 marginZ = (room.maxZ - room.minZ) / 8 + 1;
+
+    for (benchQueryStruct& query : queries)
+    {
+        query.x = randomIn(random, room.minX - marginX, room.maxX + marginX);
+        query.y = randomIn(random, room.minY, room.maxY);
+        query.z = randomIn(random, room.minZ - marginZ, room.maxZ + marginZ);
+
+        if (random() % 4 == 0 && !room.sceZones.empty())
+        {
+            const ZVStruct& zv = room.sceZones[random() % room.sceZones.size()].zv;
+            query.x = random() % 2 ? zv.ZVX1 : zv.ZVX2;
+            query.z = random() % 2 ? zv.ZVZ1 : zv.ZVZ2;
+        }
+
+        const s32 size = random() % 16 ? randomIn(random, 100, 800) : randomIn(random, 1000, 20000);
+
+        query.zv.ZVX1 = query.x - size / 2;
+        query.zv.ZVX2 = query.x + size / 2;
+        query.zv.ZVY1 = query.y - 2000;
+        query.zv.ZVY2 = query.y;
+        query.zv.ZVZ1 = query.z - size / 2;
+        query.zv.ZVZ2 = query.z + size / 2;
+
+        if (random() % 4 == 0 && !room.hardCols.empty())
+        {
+            const ZVStruct& zv = room.hardCols[random() % room.hardCols.size()].zv;
+            query.zv.ZVX1 = zv.ZVX2 - (s32)(random() % 2);
+            query.zv.ZVX2 = query.zv.ZVX1 + size;
+        }
+
+        if (random() % 32 == 0)
+            std::swap(query.zv.ZVX1, query.zv.ZVX2);
+    }
+
+    return queries;
+}
+
+static void printList(const char* label, const std::vector<int>& list)
+{
+    printf("  %s:", label);
+    for (int entry : list)
+        printf(" %d", entry);
+    printf("\n");
+}
+
+// Returns the number of queries that differ
+static int checkRoom(const benchRoomStruct& room, const std::vector<benchQueryStruct>& queries)
+{
+    int mismatches = 0;
+    std::vector<int> expected, found;
+
+    for (const benchQueryStruct& query : queries)
+    {
+        expected.clear();
+        found.clear();
+        hardColReference(room, &query.zv, expected);
+        hardColGrid(room, &query.zv, found);
+
+        if (expected != found)
+        {
+            printf("room %d: hard collisions of (%d %d %d %d %d %d) differ\n", room.index,
+                query.zv.ZVX1, query.zv.ZVX2, query.zv.ZVY1, query.zv.ZVY2, query.zv.ZVZ1, query.zv.ZVZ2);
+            printList("expected", expected);
+            printList("found", found);
+            mismatches++;
+        }
+
+        expected.clear();
+        found.clear();
+        sceZoneReference(room, query.x, query.y, query.z, expected);
+        sceZoneGrid(room, query.x, query.y, query.z, found);
+
+        if (expected != found)
+        {
+            printf("room %d: scenario zones at (%d %d %d) differ\n", room.index, query.x, query.y, query.z);
+            printList("expected", expected);
+            printList("found", found);
+            mismatches++;
+        }
+    }
+
+    return mismatches;
+}
+
+//----------------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------------
+
+typedef void (*hardColQuery)(const benchRoomStruct&, const ZVStruct*, std::vector<int>&);
+typedef void (*sceZoneQuery)(const benchRoomStruct&, int, int, int, std::vector<int>&);
+
+// keeps the queries from being optimised away
+static volatile size_t s_numFound;
+
+// ns per query of each, the best of repeats
+static void benchRoom(const benchRoomStruct& room, const std::vector<benchQueryStruct>& queries, int repeats)
+{
+    const hardColQuery hardColQueries[2] = { hardColReference, hardColGrid };
+    const sceZoneQuery sceZoneQueries[2] = { sceZoneReference, sceZoneGrid };
+
+    double hardColTimes[2] = { 1e30, 1e30 };
+    double sceZoneTimes[2] = { 1e30, 1e30 };
+    std::vector<int> found;
+
+    for (int i = 0; i < repeats; i++)
+    {
+        for (int path = 0; path < 2; path++)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            for (const benchQueryStruct& query : queries)
+            {
+                found.clear();
+                hardColQueries[path](room, &query.zv, found);
+                s_numFound += found.size();
+            }
+            auto middle = std::chrono::steady_clock::now();
+            for (const benchQueryStruct& query : queries)
+            {
+                found.clear();
+                sceZoneQueries[path](room, query.x, query.y, query.z, found);
+                s_numFound += found.size();
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            hardColTimes[path] = std::min(hardColTimes[path], std::chrono::duration<double>(middle - begin).count());
+            sceZoneTimes[path] = std::min(sceZoneTimes[path], std::chrono::duration<double>(end - middle).count());
+        }
+    }
+
+    const double scale = 1000000000.0 / queries.size();
+
+    printf("room %3d %5d %5d  %9.1f %9.1f %6.1fx  %9.1f %9.1f %6.1fx\n", room.index,
+        (int)room.hardCols.size(), (int)room.sceZones.size(),
+        hardColTimes[0] * scale, hardColTimes[1] * scale, hardColTimes[1] > 0 ? hardColTimes[0] / hardColTimes[1] : 0,
+        sceZoneTimes[0] * scale, sceZoneTimes[1] * scale, sceZoneTimes[1] > 0 ? sceZoneTimes[0] / sceZoneTimes[1] : 0);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* pakFile = nullptr;
+    int numQueries = 10000;
+    int repeats = 20;
+    unsigned int seed = 1234;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-q") && i + 1 < argc)
+        {
+            numQueries = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+        {
+            repeats = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+        {
+            seed = (unsigned int)atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-' && !pakFile)
+        {
+            pakFile = argv[i];
+        }
+        else
+        {
+            printf("usage: RoomBench [<ETAGExx.PAK>] [-q <queries per room>] [-r <repeats>] [-s <seed>]\n");
+            return 1;
+        }
+    }
+
+    if (numQueries < 1 || repeats < 1)
+    {
+        printf("usage: RoomBench [<ETAGExx.PAK>] [-q <queries per room>] [-r <repeats>] [-s <seed>]\n");
+        return 1;
+    }
+
+    std::mt19937 random(seed);
+    std::vector<benchRoomStruct> rooms;
+
+    if (pakFile)
+    {
+        if (!loadRooms(pakFile, rooms))
+        {
+            printf("Can't read %s\n", pakFile);
+            return 1;
+        }
+    }
+    else
+    {
+        rooms = syntheticRooms(random);
+    }
+
+    std::vector<std::vector<benchQueryStruct>> queries;
+    int mismatches = 0;
+
+    for (const benchRoomStruct& room : rooms)
+    {
+        queries.push_back(randomQueries(random, room, numQueries));
+        mismatches += checkRoom(room, queries.back());
+    }
+
+    printf("%d rooms, %d queries, %d mismatches\n", (int)rooms.size(), (int)rooms.size() * numQueries * 2, mismatches);
+
+    printf("\nns per query, walk of the whole table then grid\n");
+    printf("%-8s %5s %5s  %9s %9s %7s  %9s %9s\n", "", "hard", "zones", "hardCol", "grid", "", "sceZone", "grid");
+    for (size_t i = 0; i < rooms.size(); i++)
+    {
+        benchRoom(rooms[i], queries[i], repeats);
+    }
+
+    return mismatches ? 1 : 0;
+}
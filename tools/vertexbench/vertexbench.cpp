@@ -0,0 +1,281 @@
+//----------------------------------------------------------------------------
+//  Dream In The Dark vertex transform benchmark (Tools)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2025  yaz0r/jimmu/FITD Team
+//  Copyright (C) 1999-2025  The EDGE Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+// Checks that projectVertices (batched) matches projectVerticesScalar bit for
+// bit, then times both on body sized vertex lists:
+//   - every s16 value of each coordinate, under random cameras
+//   - every camera angle of each axis, on random vertices
+// in both the RotateAndProjectBody and the AnimateCloud mode.
+//
+//   VertexBench [-n <repeats>] [-s <seed>]
+//
+// The exit code is 1 if any output differs.
+
+#include "common.h"
+
+#include "vertexTransform.h"
+#include "cosTable.h"
+#include "toolUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+static const int s_numBenchVertices = NUM_MAX_POINT_IN_POINT_BUFFER;
+
+struct vertexListStruct
+{
+    std::vector<s16> x;
+    std::vector<s16> y;
+    std::vector<s16> z;
+
+    void resize(size_t size)
+    {
+        x.resize(size);
+        y.resize(size);
+        z.resize(size);
+    }
+};
+
+// Same setup as SetAngleCamera, SetPosCamera and SetProjection
+static void setCamera(projectParamsStruct& params, int angleX, int angleY, int angleZ)
+{
+    angleX &= 0x3FF;
+    angleY &= 0x3FF;
+    angleZ &= 0x3FF;
+
+    params.useX = angleX != 0;
+    params.xCos = cosTable[angleX];
+    params.xSin = cosTable[(angleX + 0x100) & 0x3FF];
+    params.useY = angleY != 0;
+    params.yCos = cosTable[angleY];
+    params.ySin = cosTable[(angleY + 0x100) & 0x3FF];
+    params.useZ = angleZ != 0;
+    params.zCos = cosTable[angleZ];
+    params.zSin = cosTable[(angleZ + 0x100) & 0x3FF];
+}
+
+static projectParamsStruct randomParams(std::mt19937& random, bool cloud)
+{
+    projectParamsStruct params;
+
+    setCamera(params, random() % 1024, random() % 1024, random() % 1024);
+
+    // camera sized offsets, sometimes far out
+    int range = (random() % 8) ? 20000 : 2000000;
+    params.renderX = (int)(random() % (2 * range)) - range;
+    params.renderY = (int)(random() % (2 * range)) - range;
+    params.renderZ = (int)(random() % (2 * range)) - range;
+    params.translateY = (int)(random() % 20000) - 10000;
+
+    params.fovX = (float)(100 + random() % 1000);
+    params.fovY = (float)(100 + random() % 1000);
+    params.centerX = 160;
+    params.centerY = 100;
+    params.perspective = (float)(random() % 2000);
+    params.cloud = cloud;
+
+    return params;
+}
+
+static void randomVertices(std::mt19937& random, vertexListStruct& vertices, size_t size)
+{
+    vertices.resize(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        vertices.x[i] = (s16)random();
+        vertices.y[i] = (s16)random();
+        vertices.z[i] = (s16)random();
+    }
+}
+
+// Returns true if both paths agree on every output bit and on the box.
+static bool compare(const projectParamsStruct& params, const vertexListStruct& vertices)
+{
+    const int count = (int)vertices.x.size();
+
+    std::vector<float> expected(count * 3);
+    std::vector<float> output(count * 3);
+
+    projectBBoxStruct expectedBox = { 0x7FFF, 0x7FFF, -0x7FFF, -0x7FFF };
+    projectBBoxStruct outputBox = expectedBox;
+
+    projectVerticesScalar(params, vertices.x.data(), vertices.y.data(), vertices.z.data(), 1, count, expected.data(), expectedBox);
+    projectVertices(params, vertices.x.data(), vertices.y.data(), vertices.z.data(), 1, count, output.data(), outputBox);
+
+    if (memcmp(expected.data(), output.data(), count * 3 * sizeof(float)) || memcmp(&expectedBox, &outputBox, sizeof(projectBBoxStruct)))
+    {
+        for (int i = 0; i < count * 3; i++)
+        {
+            if (memcmp(&expected[i], &output[i], sizeof(float)))
+            {
+                printf("vertex %d (%d %d %d): %g, expected %g\n", i / 3, vertices.x[i / 3], vertices.y[i / 3], vertices.z[i / 3], output[i], expected[i]);
+                break;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
+// Returns the number of mismatching runs.
+static int checkAll(std::mt19937& random)
+{
+    int mismatches = 0;
+    int runs = 0;
+    vertexListStruct vertices;
+
+    for (int cloud = 0; cloud < 2; cloud++)
+    {
+        // every value of one coordinate, the others random
+        for (int axis = 0; axis < 3; axis++)
+        {
+            for (int camera = 0; camera < 16; camera++)
+            {
+                projectParamsStruct params = randomParams(random, cloud != 0);
+                randomVertices(random, vertices, 0x10000);
+
+                std::vector<s16>& sweep = axis == 0 ? vertices.x : (axis == 1 ? vertices.y : vertices.z);
+                for (int i = 0; i < 0x10000; i++)
+                {
+                    sweep[i] = (s16)(i - 0x8000);
+                }
+
+                runs++;
+                if (!compare(params, vertices))
+                    mismatches++;
+            }
+        }
+
+        // every angle of one axis, the others random
+        for (int axis = 0; axis < 3; axis++)
+        {
+            for (int angle = 0; angle < 1024; angle++)
+            {
+                projectParamsStruct params = randomParams(random, cloud != 0);
+                int angles[3] = { (int)(random() % 1024), (int)(random() % 1024), (int)(random() % 1024) };
+                angles[axis] = angle;
+                setCamera(params, angles[0], angles[1], angles[2]);
+
+                randomVertices(random, vertices, 1 + random() % 64); // odd sizes hit the scalar tail
+
+                runs++;
+                if (!compare(params, vertices))
+                    mismatches++;
+            }
+        }
+    }
+
+    printf("%d runs, %d mismatches\n", runs, mismatches);
+    return mismatches;
+}
+
+template <typename F>
+static void bench(const char* name, int repeats, F project)
+{
+    std::vector<double> latencies;
+
+    for (int i = 0; i < repeats; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        project();
+        auto end = std::chrono::steady_clock::now();
+
+        latencies.push_back(std::chrono::duration<double>(end - start).count() * 1000000.0);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    double total = 0;
+    for (double latency : latencies)
+        total += latency;
+
+    printf("%-14s %9.1f Mvertices/s  p50 %8.2f  p90 %8.2f  p99 %8.2f us\n", name,
+        total > 0 ? (double)s_numBenchVertices * repeats / total : 0,
+        percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99));
+}
+
+int main(int argc, char* argv[])
+{
+    int repeats = 10000;
+    unsigned int seed = 1234;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+        {
+            repeats = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+        {
+            seed = (unsigned int)atoi(argv[++i]);
+        }
+        else
+        {
+            printf("usage: VertexBench [-n <repeats>] [-s <seed>]\n");
+            return 1;
+        }
+    }
+
+    std::mt19937 random(seed);
+
+    int mismatches = checkAll(random);
+
+    // a body of in-room vertices, seen by a typical camera
+    vertexListStruct vertices;
+    vertices.resize(s_numBenchVertices);
+    for (int i = 0; i < s_numBenchVertices; i++)
+    {
+        vertices.x[i] = (s16)((int)(random() % 2000) - 1000);
+        vertices.y[i] = (s16)((int)(random() % 2000) - 2000);
+        vertices.z[i] = (s16)((int)(random() % 2000) - 1000);
+    }
+
+    std::vector<float> output(s_numBenchVertices * 3);
+
+    for (int cloud = 0; cloud < 2; cloud++)
+    {
+        projectParamsStruct params = {};
+        setCamera(params, 40, 300, 0);
+        params.renderX = 3000;
+        params.renderY = -1500;
+        params.renderZ = 8000;
+        params.translateY = -2000;
+        params.fovX = 400;
+        params.fovY = 320;
+        params.centerX = 160;
+        params.centerY = 100;
+        params.perspective = 1000;
+        params.cloud = cloud != 0;
+
+        printf("\n%s\n", cloud ? "AnimateCloud" : "RotateAndProjectBody");
+
+        bench("scalar", repeats, [&] {
+            projectBBoxStruct bbox = { 0x7FFF, 0x7FFF, -0x7FFF, -0x7FFF };
+            projectVerticesScalar(params, vertices.x.data(), vertices.y.data(), vertices.z.data(), 1, s_numBenchVertices, output.data(), bbox);
+        });
+        bench("batched", repeats, [&] {
+            projectBBoxStruct bbox = { 0x7FFF, 0x7FFF, -0x7FFF, -0x7FFF };
+            projectVertices(params, vertices.x.data(), vertices.y.data(), vertices.z.data(), 1, s_numBenchVertices, output.data(), bbox);
+        });
+    }
+
+    return mismatches ? 1 : 0;
+}